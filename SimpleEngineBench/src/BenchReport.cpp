@@ -0,0 +1,68 @@
+#include "BenchReport.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Bench {
+
+	double percentile(const std::vector<double>& sorted_values, const double p) {
+
+		if (sorted_values.empty())
+			return 0;
+
+		const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted_values.size()));
+		return sorted_values[std::min(sorted_values.size() - 1, rank > 0 ? rank - 1 : 0)];
+	}
+
+	template<typename TValue, typename TGetter>
+	static void write_array(std::ostream& stream, const char* name, const std::vector<FrameSample>& frames, TGetter getter) {
+
+		stream << "      \"" << name << "\": [";
+		for (size_t i = 0; i < frames.size(); ++i) {
+			stream << (i ? ", " : "") << static_cast<TValue>(getter(frames[i]));
+		}
+		stream << "]";
+	}
+
+	void write_json(std::ostream& stream, const std::vector<SceneResult>& results) {
+
+		stream << "{\n  \"scenes\": [\n";
+		for (size_t i = 0; i < results.size(); ++i) {
+
+			const SceneResult& result = results[i];
+
+			std::vector<double> cpu_ms(result.frames.size());
+			std::transform(result.frames.begin(), result.frames.end(), cpu_ms.begin(), [](const FrameSample& f) { return f.cpu_ms; });
+			std::sort(cpu_ms.begin(), cpu_ms.end());
+			const double mean = cpu_ms.empty() ? 0 : std::accumulate(cpu_ms.begin(), cpu_ms.end(), 0.0) / cpu_ms.size();
+
+			stream << "    {\n";
+			stream << "      \"scene\": \"" << result.scene << "\",\n";
+			stream << "      \"objects\": " << result.objects << ",\n";
+			stream << "      \"frames\": " << result.frames.size() << ",\n";
+			stream << "      \"cpu_ms_mean\": " << mean << ",\n";
+			stream << "      \"cpu_ms_min\": " << (cpu_ms.empty() ? 0 : cpu_ms.front()) << ",\n";
+			stream << "      \"cpu_ms_max\": " << (cpu_ms.empty() ? 0 : cpu_ms.back()) << ",\n";
+			stream << "      \"cpu_ms_p50\": " << percentile(cpu_ms, 50) << ",\n";
+			stream << "      \"cpu_ms_p90\": " << percentile(cpu_ms, 90) << ",\n";
+			stream << "      \"cpu_ms_p99\": " << percentile(cpu_ms, 99) << ",\n";
+			write_array<double>(stream, "cpu_ms", result.frames, [](const FrameSample& f) { return f.cpu_ms; });
+			stream << ",\n";
+			write_array<unsigned int>(stream, "draw_calls", result.frames, [](const FrameSample& f) { return f.draw_calls; });
+			stream << ",\n";
+			write_array<unsigned int>(stream, "state_changes", result.frames, [](const FrameSample& f) { return f.state_changes; });
+			stream << ",\n";
+			write_array<unsigned int>(stream, "state_changes_elided", result.frames, [](const FrameSample& f) { return f.state_changes_elided; });
+
+			const size_t counters_count = result.frames.empty() ? 0 : result.frames.front().counters.size();
+			for (size_t counter_index = 0; counter_index < counters_count; ++counter_index) {
+
+				stream << ",\n";
+				write_array<double>(stream, result.frames.front().counters[counter_index].name, result.frames,
+					[counter_index](const FrameSample& f) { return counter_index < f.counters.size() ? f.counters[counter_index].value : 0.0; });
+			}
+			stream << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		stream << "  ]\n}\n";
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace Bench {
+
+	//Счётчик конкретной сцены (батчи, отсечённые объекты и т.п.)
+	struct Counter {
+
+		const char* name;
+		double value;
+	};
+
+	struct FrameSample {
+
+		double cpu_ms = 0;
+		unsigned int draw_calls = 0;
+		unsigned int state_changes = 0;
+		unsigned int state_changes_elided = 0;
+		std::vector<Counter> counters;
+	};
+
+	struct SceneResult {
+
+		std::string scene;
+		unsigned int objects = 0;
+		std::vector<FrameSample> frames;
+	};
+
+	//p in [0, 100], nearest-rank on an already sorted array
+	double percentile(const std::vector<double>& sorted_values, const double p);
+
+	void write_json(std::ostream& stream, const std::vector<SceneResult>& results);
+}
@@ -0,0 +1,1676 @@
+#include "BenchScenes.hpp"
+
+#include "SimpleEngineCore/Camera.hpp"
+#include "SimpleEngineCore/Registry.hpp"
+#include "SimpleEngineCore/Components.hpp"
+#include "SimpleEngineCore/Systems.hpp"
+#include "SimpleEngineCore/TransformHierarchy.hpp"
+#include "SimpleEngineCore/Frustum.hpp"
+#include "SimpleEngineCore/Bvh.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+#include "SimpleEngineCore/MeshFile.hpp"
+#include "SimpleEngineCore/MeshImporter.hpp"
+#include "SimpleEngineCore/MeshOptimizer.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ShaderProgram.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ProgramBinaryCache.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ShaderCompiler.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ShaderLibrary.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/VertexArray.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/IndexBuffer.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/BatchRenderer.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/RenderQueue.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/MeshArena.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/IndirectDrawList.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/StaticMesh.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/Texture2D.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/TextureManager.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+
+using namespace SimpleEngine;
+
+namespace Bench {
+
+	const char* bench_vertex_shader =
+		R"(#version 460
+		layout(location = 0) in vec3 vertex_position;
+		layout(location = 1) in vec3 vertex_color;
+		uniform mat4 model_matrix;
+		layout(std140) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+			mat4 view_projection_matrix;
+			vec4 camera_position;
+		};
+		out vec3 color;
+		void main() {
+			color = vertex_color;
+			gl_Position = view_projection_matrix * model_matrix * vec4(vertex_position, 1.0);
+		})";
+
+	const char* bench_instanced_vertex_shader =
+		R"(#version 460
+		layout(location = 0) in vec3 vertex_position;
+		layout(location = 1) in vec3 vertex_color;
+		layout(location = 2) in mat4 instance_model_matrix;
+		layout(std140) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+			mat4 view_projection_matrix;
+			vec4 camera_position;
+		};
+		out vec3 color;
+		void main() {
+			color = vertex_color;
+			gl_Position = view_projection_matrix * instance_model_matrix * vec4(vertex_position, 1.0);
+		})";
+
+	const char* bench_indirect_vertex_shader =
+		R"(#version 460
+		layout(location = 0) in vec3 vertex_position;
+		layout(location = 1) in vec3 vertex_color;
+		layout(std140) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+			mat4 view_projection_matrix;
+			vec4 camera_position;
+		};
+		struct DrawData {
+			mat4 model_matrix;
+			vec4 color;
+		};
+		layout(std430, binding = 0) readonly buffer DrawDataBuffer {
+			DrawData draws[];
+		};
+		out vec3 color;
+		void main() {
+			color = vertex_color * draws[gl_DrawID].color.rgb;
+			gl_Position = view_projection_matrix * draws[gl_DrawID].model_matrix * vec4(vertex_position, 1.0);
+		})";
+
+	//Имена юниформов хешируются на этапе компиляции
+	constexpr UniformName model_matrix_uniform("model_matrix");
+
+	std::string make_fragment_shader(const float tint) {
+
+		return std::string(R"(#version 460
+		in vec3 color;
+		out vec4 frag_color;
+		void main() {
+			frag_color = vec4(color * )") + std::to_string(tint) + R"(, 1.0);
+		})";
+	}
+
+	const float quad_positions_colors[] = {
+		0.0f, -0.5f, -0.5f,     1.0f, 0.0f, 0.0f,
+		0.0f,  0.5f, -0.5f,     0.0f, 1.0f, 0.0f,
+		0.0f, -0.5f,  0.5f,     0.0f, 0.0f, 1.0f,
+		0.0f,  0.5f,  0.5f,     1.0f, 1.0f, 0.0f
+	};
+
+	const unsigned int quad_indexes[] = {
+		0, 1, 2, 3, 2, 1
+	};
+
+	const float cube_positions_colors[] = {
+		-0.5f, -0.5f, -0.5f,    1.0f, 0.0f, 0.0f,
+		 0.5f, -0.5f, -0.5f,    0.0f, 1.0f, 0.0f,
+		 0.5f,  0.5f, -0.5f,    0.0f, 0.0f, 1.0f,
+		-0.5f,  0.5f, -0.5f,    1.0f, 1.0f, 0.0f,
+		-0.5f, -0.5f,  0.5f,    1.0f, 0.0f, 1.0f,
+		 0.5f, -0.5f,  0.5f,    0.0f, 1.0f, 1.0f,
+		 0.5f,  0.5f,  0.5f,    1.0f, 1.0f, 1.0f,
+		-0.5f,  0.5f,  0.5f,    0.2f, 0.2f, 0.2f
+	};
+
+	const unsigned int cube_indexes[] = {
+		0, 2, 1, 0, 3, 2,
+		4, 5, 6, 4, 6, 7,
+		0, 1, 5, 0, 5, 4,
+		3, 6, 2, 3, 7, 6,
+		0, 4, 7, 0, 7, 3,
+		1, 2, 6, 1, 6, 5
+	};
+
+	std::string make_material_fragment_shader(const float tint) {
+
+		return std::string(R"(#version 460
+		in vec3 color;
+		uniform vec4 material_color;
+		out vec4 frag_color;
+		void main() {
+			frag_color = vec4(color * )") + std::to_string(tint) + R"(, 1.0) * material_color;
+		})";
+	}
+
+	//Детерминированный генератор - одинаковые сцены на любой платформе
+	class Random {
+	public:
+		explicit Random(const uint32_t seed) : m_state(seed) {}
+
+		float next(const float min, const float max) {
+
+			m_state ^= m_state << 13;
+			m_state ^= m_state >> 17;
+			m_state ^= m_state << 5;
+			return min + (max - min) * static_cast<float>(m_state & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
+		}
+
+	private:
+		uint32_t m_state;
+	};
+
+	struct Mesh {
+
+		std::unique_ptr<VertexBuffer> p_vbo;
+		std::unique_ptr<IndexBuffer> p_index_buffer;
+		std::unique_ptr<VertexArray> p_vao;
+	};
+
+	template<size_t VerticesSize, size_t IndexesCount>
+	Mesh make_mesh(const float (&positions_colors)[VerticesSize], const unsigned int (&indexes)[IndexesCount]) {
+
+		BufferLayout buffer_layout_2vec3{
+			ShaderDataType::Float3,
+			ShaderDataType::Float3
+		};
+
+		Mesh mesh;
+		mesh.p_vao = std::make_unique<VertexArray>();
+		mesh.p_vbo = std::make_unique<VertexBuffer>(positions_colors, sizeof(positions_colors), buffer_layout_2vec3);
+		mesh.p_index_buffer = std::make_unique<IndexBuffer>(indexes, IndexesCount);
+		mesh.p_vao->add_vertex_buffer(*mesh.p_vbo);
+		mesh.p_vao->set_index_buffer(*mesh.p_index_buffer);
+		return mesh;
+	}
+
+	std::vector<glm::mat4> make_model_matrices(const unsigned int objects_count) {
+
+		Random random(12345);
+		std::vector<glm::mat4> model_matrices;
+		model_matrices.reserve(objects_count);
+		for (unsigned int i = 0; i < objects_count; ++i) {
+
+			const glm::vec3 position(random.next(0.f, 20.f), random.next(-5.f, 5.f), random.next(-5.f, 5.f));
+			const float angle = random.next(0.f, 6.28f);
+			glm::mat4 model_matrix = glm::translate(glm::mat4(1.f), position);
+			model_matrix = glm::rotate(model_matrix, angle, glm::vec3(0.f, 0.f, 1.f));
+			model_matrices.push_back(glm::scale(model_matrix, glm::vec3(0.1f)));
+		}
+		return model_matrices;
+	}
+
+	//N объектов одного меша: одна программа, один VAO, N draw call'ов
+	class SingleMeshScene : public BenchScene {
+	public:
+		explicit SingleMeshScene(const bool cubes) : m_cubes(cubes) {}
+
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			m_model_matrix_location = m_pShaderProgram->get_uniform_location(model_matrix_uniform);
+			m_mesh = m_cubes ? make_mesh(cube_positions_colors, cube_indexes) : make_mesh(quad_positions_colors, quad_indexes);
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			m_pShaderProgram->bind();
+			for (const glm::mat4& model_matrix : m_model_matrices) {
+
+				m_pShaderProgram->setMatrix4(m_model_matrix_location, model_matrix);
+				Renderer_OpenGL::draw(*m_mesh.p_vao);
+			}
+		}
+
+	private:
+		bool m_cubes;
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		int m_model_matrix_location = -1;
+		Mesh m_mesh;
+		std::vector<glm::mat4> m_model_matrices;
+	};
+
+	//s_programs_count разных программ нужны сразу при загрузке сцены. Sync - все собираются в init, кадр загрузки стоит;
+	//Async - отправляются пакетом в ShaderCompiler, а пока программа не готова, объекты рисуются запасной
+	class ShaderCompileScene : public BenchScene {
+	public:
+		explicit ShaderCompileScene(const bool async) : m_async(async) {}
+
+		bool init(const unsigned int objects_count) override {
+
+			const auto start = std::chrono::steady_clock::now();
+			m_pFallbackProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_fragment_shader(1.f).c_str());
+			if (!m_pFallbackProgram->isCompiled())
+				return false;
+			for (unsigned int i = 0; i < s_programs_count; ++i) {
+
+				const std::string fragment_shader = make_fragment_shader(0.25f + i * 0.75f / s_programs_count);
+				if (m_async) {
+					m_compiler.submit(bench_vertex_shader, fragment_shader.c_str());
+					continue;
+				}
+				m_shader_programs.push_back(std::make_unique<ShaderProgram>(bench_vertex_shader, fragment_shader.c_str()));
+				if (!m_shader_programs.back()->isCompiled())
+					return false;
+			}
+			m_init_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			m_mesh = make_mesh(cube_positions_colors, cube_indexes);
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			if (m_async)
+				m_compiler.poll();
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				const size_t program = i % s_programs_count;
+				const ShaderProgram& shader_program = m_async ? m_compiler.get_or(program, *m_pFallbackProgram) : *m_shader_programs[program];
+				shader_program.bind();
+				shader_program.setMatrix4(model_matrix_uniform, m_model_matrices[i]);
+				Renderer_OpenGL::draw(*m_mesh.p_vao);
+			}
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			const ShaderCompiler::Statistics& statistics = m_compiler.get_statistics();
+			counters.push_back({ "scene_init_ms", m_init_ms });
+			counters.push_back({ "programs_pending", static_cast<double>(m_compiler.get_pending_count()) });
+			counters.push_back({ "programs_ready", static_cast<double>(m_async ? statistics.ready : m_shader_programs.size()) });
+			counters.push_back({ "compiler_poll_ms", statistics.poll_ms });
+			counters.push_back({ "parallel_shader_compile", Renderer_OpenGL::supports_parallel_shader_compile() ? 1.0 : 0.0 });
+		}
+
+	private:
+		static constexpr unsigned int s_programs_count = 64;
+		bool m_async;
+		ShaderCompiler m_compiler;
+		std::unique_ptr<ShaderProgram> m_pFallbackProgram;
+		std::vector<std::unique_ptr<ShaderProgram>> m_shader_programs;
+		Mesh m_mesh;
+		std::vector<glm::mat4> m_model_matrices;
+		double m_init_ms = 0.0;
+	};
+
+	//Каждый объект берёт одну из s_programs_count программ по кругу - худший случай переключений.
+	//Время создания программ - со вторым запуском с тем же --shader-cache они берутся из кэша бинарников
+	class ManyShadersScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			const ProgramBinaryCache::Statistics cache_before = ProgramBinaryCache::get_statistics();
+			const auto start = std::chrono::steady_clock::now();
+			for (unsigned int i = 0; i < s_programs_count; ++i) {
+
+				m_shader_programs.push_back(std::make_unique<ShaderProgram>(bench_vertex_shader, make_fragment_shader(0.5f + i * 0.5f / s_programs_count).c_str()));
+				if (!m_shader_programs.back()->isCompiled())
+					return false;
+			}
+			m_programs_create_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			const ProgramBinaryCache::Statistics& cache_after = ProgramBinaryCache::get_statistics();
+			m_program_cache.hits = cache_after.hits - cache_before.hits;
+			m_program_cache.misses = cache_after.misses - cache_before.misses;
+			m_program_cache.rejected = cache_after.rejected - cache_before.rejected;
+			m_program_cache.load_ms = cache_after.load_ms - cache_before.load_ms;
+			m_program_cache.compile_ms = cache_after.compile_ms - cache_before.compile_ms;
+			m_program_cache.store_ms = cache_after.store_ms - cache_before.store_ms;
+
+			m_mesh = make_mesh(cube_positions_colors, cube_indexes);
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				const ShaderProgram& shader_program = *m_shader_programs[i % s_programs_count];
+				shader_program.bind();
+				shader_program.setMatrix4(model_matrix_uniform, m_model_matrices[i]);
+				Renderer_OpenGL::draw(*m_mesh.p_vao);
+			}
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "programs_create_ms", m_programs_create_ms });
+			counters.push_back({ "program_cache_hits", static_cast<double>(m_program_cache.hits) });
+			counters.push_back({ "program_cache_misses", static_cast<double>(m_program_cache.misses) });
+			counters.push_back({ "program_cache_rejected", static_cast<double>(m_program_cache.rejected) });
+			//Из чего сложилось programs_create_ms: чтение бинарников, компиляция промахов и их запись в кэш
+			counters.push_back({ "program_cache_load_ms", m_program_cache.load_ms });
+			counters.push_back({ "program_compile_ms", m_program_cache.compile_ms });
+			counters.push_back({ "program_cache_store_ms", m_program_cache.store_ms });
+		}
+
+	private:
+		static constexpr unsigned int s_programs_count = 16;
+		std::vector<std::unique_ptr<ShaderProgram>> m_shader_programs;
+		Mesh m_mesh;
+		std::vector<glm::mat4> m_model_matrices;
+		double m_programs_create_ms = 0.0;
+		//Прирост статистики кэша за init()
+		ProgramBinaryCache::Statistics m_program_cache;
+	};
+
+	//У каждого объекта свои VertexBuffer/IndexBuffer/VertexArray
+	class ManyVaosScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			m_meshes.reserve(objects_count);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+				m_meshes.push_back(i % 2 ? make_mesh(cube_positions_colors, cube_indexes) : make_mesh(quad_positions_colors, quad_indexes));
+			}
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			m_pShaderProgram->bind();
+			for (size_t i = 0; i < m_meshes.size(); ++i) {
+
+				m_pShaderProgram->setMatrix4(model_matrix_uniform, m_model_matrices[i]);
+				Renderer_OpenGL::draw(*m_meshes[i].p_vao);
+			}
+		}
+
+	private:
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::vector<Mesh> m_meshes;
+		std::vector<glm::mat4> m_model_matrices;
+	};
+
+	//Те же N объектов, но через BatchRenderer - несколько draw call'ов на весь кадр
+	class BatchScene : public BenchScene {
+	public:
+		explicit BatchScene(const bool cubes) : m_cubes(cubes) {}
+
+		bool init(const unsigned int objects_count) override {
+
+			m_pBatchRenderer = std::make_unique<BatchRenderer>();
+			if (!m_pBatchRenderer->is_valid())
+				return false;
+
+			m_model_matrices = make_model_matrices(objects_count);
+			Random random(54321);
+			m_colors.reserve(objects_count);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+				m_colors.emplace_back(random.next(0.f, 1.f), random.next(0.f, 1.f), random.next(0.f, 1.f), 1.f);
+			}
+			return true;
+		}
+
+		void render(const Camera& camera, RenderQueue& /*render_queue*/) override {
+
+			m_pBatchRenderer->begin(camera.get_projection_matrix() * camera.get_view_matrix());
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				if (m_cubes)
+					m_pBatchRenderer->submit_cube(m_model_matrices[i], m_colors[i]);
+				else
+					m_pBatchRenderer->submit_quad(m_model_matrices[i], m_colors[i]);
+			}
+			m_pBatchRenderer->end();
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "batches_flushed", static_cast<double>(m_pBatchRenderer->get_statistics().batches_flushed) });
+			counters.push_back({ "batch_vertices", static_cast<double>(m_pBatchRenderer->get_statistics().vertices) });
+			counters.push_back({ "ring_fence_waits", static_cast<double>(m_pBatchRenderer->get_statistics().fence_waits) });
+			counters.push_back({ "ring_overflows", static_cast<double>(m_pBatchRenderer->get_statistics().ring_overflows) });
+		}
+
+	private:
+		bool m_cubes;
+		std::unique_ptr<BatchRenderer> m_pBatchRenderer;
+		std::vector<glm::mat4> m_model_matrices;
+		std::vector<glm::vec4> m_colors;
+	};
+
+	//Один draw_instanced на все объекты, матрицы экземпляров стримятся в буфер каждый кадр
+	class InstancedScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_instanced_vertex_shader, make_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			m_model_matrices = make_model_matrices(objects_count);
+			m_mesh = make_mesh(cube_positions_colors, cube_indexes);
+
+			BufferLayout instance_layout{
+				BufferElement(ShaderDataType::Mat4, 1)
+			};
+			m_pInstanceBuffer = std::make_unique<VertexBuffer>(nullptr, m_model_matrices.size() * sizeof(glm::mat4), instance_layout, VertexBuffer::EUsage::Stream);
+			m_mesh.p_vao->add_vertex_buffer(*m_pInstanceBuffer);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			m_pInstanceBuffer->update_buffer(m_model_matrices.data(), m_model_matrices.size() * sizeof(glm::mat4));
+
+			m_pShaderProgram->bind();
+			Renderer_OpenGL::draw_instanced(*m_mesh.p_vao, m_model_matrices.size());
+		}
+
+	private:
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::unique_ptr<VertexBuffer> m_pInstanceBuffer;
+		Mesh m_mesh;
+		std::vector<glm::mat4> m_model_matrices;
+	};
+
+	//Кубы и квадраты в одной MeshArena, весь кадр - один glMultiDrawElementsIndirect, список залит один раз
+	class MultiDrawIndirectScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_indirect_vertex_shader, make_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			BufferLayout buffer_layout_2vec3{
+				ShaderDataType::Float3,
+				ShaderDataType::Float3
+			};
+			m_pMeshArena = std::make_unique<MeshArena>(buffer_layout_2vec3, 1024, 4096);
+			const MeshHandle cube_mesh = m_pMeshArena->add_mesh(cube_positions_colors, std::size(cube_positions_colors) / 6, cube_indexes, std::size(cube_indexes));
+			const MeshHandle quad_mesh = m_pMeshArena->add_mesh(quad_positions_colors, std::size(quad_positions_colors) / 6, quad_indexes, std::size(quad_indexes));
+
+			const std::vector<glm::mat4> model_matrices = make_model_matrices(objects_count);
+			for (size_t i = 0; i < model_matrices.size(); ++i) {
+				m_draw_list.add(i % 2 ? cube_mesh : quad_mesh, model_matrices[i]);
+			}
+			m_draw_list.upload();
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			m_pShaderProgram->bind();
+			m_draw_list.draw(*m_pMeshArena);
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "indirect_draws", static_cast<double>(m_draw_list.get_draws_count()) });
+		}
+
+	private:
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::unique_ptr<MeshArena> m_pMeshArena;
+		IndirectDrawList m_draw_list;
+	};
+
+	const char* variants_vertex_shader =
+		R"(#version 460
+		#include "camera_data.glsl"
+		layout(location = 0) in vec3 vertex_position;
+		layout(location = 1) in vec3 vertex_color;
+		uniform mat4 model_matrix;
+		out vec3 color;
+		void main() {
+		#ifdef VERTEX_COLOR
+			color = vertex_color;
+		#else
+			color = vec3(1.0);
+		#endif
+			gl_Position = view_projection_matrix * model_matrix * vec4(vertex_position, 1.0);
+		})";
+
+	const char* variants_fragment_shader =
+		R"(#version 460
+		in vec3 color;
+		uniform vec4 material_color;
+		out vec4 frag_color;
+		void main() {
+			frag_color = vec4(color * TINT, 1.0) * material_color;
+		})";
+
+	const char* camera_data_shader =
+		R"(layout(std140) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+			mat4 view_projection_matrix;
+			vec4 camera_position;
+		};)";
+
+	//s_materials_count материалов просят у ShaderLibrary варианты по набору define'ов. FOG в шейдерах не используется,
+	//поэтому различаются только VERTEX_COLOR и TINT - все материалы делят 8 программ, а очередь переключает только их
+	class ShaderVariantsScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_library.add_source("camera_data.glsl", camera_data_shader);
+			m_library.add_source("variants.vert", variants_vertex_shader);
+			m_library.add_source("variants.frag", variants_fragment_shader);
+
+			const char* tints[] = { "TINT=0.6", "TINT=0.8", "TINT=1.0", "TINT=1.2" };
+			Random random(777);
+			for (unsigned int i = 0; i < s_materials_count; ++i) {
+
+				std::vector<std::string> defines{ tints[i % 4] };
+				if (i / 4 % 2 == 0)
+					defines.push_back("VERTEX_COLOR");
+				if (i % 3 == 0)
+					defines.push_back("FOG");
+				ShaderProgram* pProgram = m_library.get_program("variants.vert", "variants.frag", defines);
+				if (!pProgram)
+					return false;
+				m_material_programs.push_back(pProgram);
+
+				Material material;
+				material.id = i;
+				material.color = glm::vec4(random.next(0.5f, 1.f), random.next(0.5f, 1.f), random.next(0.5f, 1.f), 1.f);
+				m_materials.push_back(material);
+			}
+
+			m_mesh = make_mesh(cube_positions_colors, cube_indexes);
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& render_queue) override {
+
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				const size_t material = i % s_materials_count;
+				render_queue.submit(*m_material_programs[material], *m_mesh.p_vao, m_materials[material], m_model_matrices[i]);
+			}
+			m_pRenderQueue = &render_queue;
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			const ShaderLibrary::Statistics& statistics = m_library.get_statistics();
+			counters.push_back({ "variant_requests", static_cast<double>(statistics.requests) });
+			counters.push_back({ "variants_preprocessed", static_cast<double>(statistics.variants) });
+			counters.push_back({ "programs_compiled", static_cast<double>(statistics.programs) });
+			counters.push_back({ "variants_deduplicated", static_cast<double>(statistics.deduplicated) });
+			counters.push_back({ "preprocess_ms", statistics.preprocess_ms });
+			counters.push_back({ "compile_ms", statistics.compile_ms });
+			counters.push_back({ "shader_program_switches", static_cast<double>(m_pRenderQueue->get_statistics().shader_program_switches) });
+		}
+
+	private:
+		static constexpr unsigned int s_materials_count = 64;
+		ShaderLibrary m_library;
+		std::vector<ShaderProgram*> m_material_programs;
+		std::vector<Material> m_materials;
+		Mesh m_mesh;
+		std::vector<glm::mat4> m_model_matrices;
+		RenderQueue* m_pRenderQueue = nullptr;
+	};
+
+	//Те же s_programs_count программ, что и в ManyShadersScene, плюс материалы (часть полупрозрачных),
+	//но всё идёт через RenderQueue и сортируется по ключу
+	class RenderQueueScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			for (unsigned int i = 0; i < s_programs_count; ++i) {
+
+				m_shader_programs.push_back(std::make_unique<ShaderProgram>(bench_vertex_shader, make_material_fragment_shader(0.5f + i * 0.5f / s_programs_count).c_str()));
+				if (!m_shader_programs.back()->isCompiled())
+					return false;
+			}
+
+			Random random(777);
+			for (unsigned int i = 0; i < s_materials_count; ++i) {
+
+				Material material;
+				material.id = i;
+				material.color = glm::vec4(random.next(0.5f, 1.f), random.next(0.5f, 1.f), random.next(0.5f, 1.f), 1.f);
+				material.translucent = i % 4 == 3;
+				if (material.translucent)
+					material.color.a = 0.5f;
+				m_materials.push_back(material);
+			}
+
+			m_meshes.push_back(make_mesh(cube_positions_colors, cube_indexes));
+			m_meshes.push_back(make_mesh(quad_positions_colors, quad_indexes));
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& render_queue) override {
+
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				render_queue.submit(*m_shader_programs[i % s_programs_count], *m_meshes[i % m_meshes.size()].p_vao,
+									m_materials[i % s_materials_count], m_model_matrices[i]);
+			}
+			m_pRenderQueue = &render_queue;
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			const RenderQueue::Statistics& statistics = m_pRenderQueue->get_statistics();
+			counters.push_back({ "queue_items", static_cast<double>(statistics.items) });
+			counters.push_back({ "shader_program_switches", static_cast<double>(statistics.shader_program_switches) });
+			counters.push_back({ "vertex_array_switches", static_cast<double>(statistics.vertex_array_switches) });
+			counters.push_back({ "material_switches", static_cast<double>(statistics.material_switches) });
+		}
+
+	private:
+		static constexpr unsigned int s_programs_count = 16;
+		static constexpr unsigned int s_materials_count = 8;
+		std::vector<std::unique_ptr<ShaderProgram>> m_shader_programs;
+		std::vector<Material> m_materials;
+		std::vector<Mesh> m_meshes;
+		std::vector<glm::mat4> m_model_matrices;
+		const RenderQueue* m_pRenderQueue = nullptr;
+	};
+
+	//N сущностей Transform + MeshRenderer: каждый кадр все поворачиваются, пересчитываются и уходят в RenderQueue
+	class EcsScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_material_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			m_meshes.push_back(make_mesh(cube_positions_colors, cube_indexes));
+			m_meshes.push_back(make_mesh(quad_positions_colors, quad_indexes));
+			for (unsigned int i = 0; i < s_materials_count; ++i) {
+
+				Material material;
+				material.id = i;
+				material.color = glm::vec4(0.5f + 0.5f * i / s_materials_count, 1.f, 1.f, 1.f);
+				m_materials.push_back(material);
+			}
+
+			m_registry.reserve<TransformComponent>(objects_count);
+			m_registry.reserve<MeshRendererComponent>(objects_count);
+			m_transform_hierarchy.reserve(objects_count);
+			Random random(12345);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+
+				const Entity entity = m_registry.create();
+				const TransformNode node = m_transform_hierarchy.create();
+				m_transform_hierarchy.set_local(node, glm::vec3(random.next(0.f, 20.f), random.next(-5.f, 5.f), random.next(-5.f, 5.f)),
+												glm::vec3(0.f, 0.f, random.next(0.f, 360.f)), glm::vec3(0.1f));
+				m_registry.emplace<TransformComponent>(entity, node);
+				m_registry.emplace<MeshRendererComponent>(entity, m_pShaderProgram.get(), m_meshes[i % m_meshes.size()].p_vao.get(), &m_materials[i % s_materials_count]);
+			}
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& render_queue) override {
+
+			for (const TransformComponent& transform : m_registry.get_pool<TransformComponent>().get_components()) {
+				m_transform_hierarchy.set_rotation(transform.node, m_transform_hierarchy.get_rotation(transform.node) + glm::vec3(0.f, 0.f, 1.f));
+			}
+			m_transform_hierarchy.update();
+			submit_mesh_renderers(m_registry, m_transform_hierarchy, render_queue);
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "entities", static_cast<double>(m_registry.get_alive_count()) });
+		}
+
+	private:
+		static constexpr unsigned int s_materials_count = 8;
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::vector<Mesh> m_meshes;
+		std::vector<Material> m_materials;
+		Registry m_registry;
+		TransformHierarchy m_transform_hierarchy;
+	};
+
+	//Как раньше считалась модельная матрица в Application: три glm::mat4 умножения на объект каждый кадр
+	class FlatTransformsScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			Random random(12345);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+
+				m_positions.emplace_back(random.next(0.f, 20.f), random.next(-5.f, 5.f), random.next(-5.f, 5.f));
+				m_angles.push_back(random.next(0.f, 360.f));
+			}
+			m_model_matrices.resize(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				const glm::mat4 scale_matrix = glm::scale(glm::mat4(1.f), glm::vec3(0.1f));
+				const glm::mat4 rotate_matrix = glm::rotate(glm::mat4(1.f), glm::radians(m_angles[i]), glm::vec3(0.f, 0.f, 1.f));
+				const glm::mat4 translate_matrix = glm::translate(glm::mat4(1.f), m_positions[i]);
+				m_model_matrices[i] = translate_matrix * rotate_matrix * scale_matrix;
+			}
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "world_matrices_recomputed", static_cast<double>(m_model_matrices.size()) });
+		}
+
+	private:
+		std::vector<glm::vec3> m_positions;
+		std::vector<float> m_angles;
+		std::vector<glm::mat4> m_model_matrices;
+	};
+
+	//Те же объекты в иерархии: корни по s_children_count детей, каждый кадр меняется доля dirty_fraction корней
+	class HierarchyTransformsScene : public BenchScene {
+	public:
+		explicit HierarchyTransformsScene(const float dirty_fraction) : m_dirty_fraction(dirty_fraction) {}
+
+		bool init(const unsigned int objects_count) override {
+
+			Random random(12345);
+			m_transform_hierarchy.reserve(objects_count);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+
+				const bool root = i % (s_children_count + 1) == 0;
+				const TransformNode node = m_transform_hierarchy.create(root ? invalid_transform_node : m_roots.back());
+				m_transform_hierarchy.set_local(node, glm::vec3(random.next(0.f, 20.f), random.next(-5.f, 5.f), random.next(-5.f, 5.f)),
+												glm::vec3(0.f, 0.f, random.next(0.f, 360.f)), glm::vec3(root ? 1.f : 0.1f));
+				if (root)
+					m_roots.push_back(node);
+			}
+			m_transform_hierarchy.update();
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			const size_t dirty_count = static_cast<size_t>(m_roots.size() * m_dirty_fraction);
+			for (size_t i = 0; i < dirty_count; ++i) {
+
+				const TransformNode node = m_roots[(m_next_root + i) % m_roots.size()];
+				m_transform_hierarchy.set_rotation(node, m_transform_hierarchy.get_rotation(node) + glm::vec3(0.f, 0.f, 1.f));
+			}
+			m_next_root = m_roots.empty() ? 0 : (m_next_root + dirty_count) % m_roots.size();
+			m_transform_hierarchy.update();
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			const TransformHierarchy::Statistics& statistics = m_transform_hierarchy.get_statistics();
+			counters.push_back({ "local_matrices_recomputed", static_cast<double>(statistics.local_matrices_recomputed) });
+			counters.push_back({ "world_matrices_recomputed", static_cast<double>(statistics.world_matrices_recomputed) });
+		}
+
+	private:
+		static constexpr unsigned int s_children_count = 15;
+		float m_dirty_fraction;
+		TransformHierarchy m_transform_hierarchy;
+		std::vector<TransformNode> m_roots;
+		size_t m_next_root = 0;
+	};
+
+	//Статичные сущности с BoundsComponent, разбросанные вокруг камеры: в кадр попадает только часть.
+	//Без отсечения в очередь уходят все, Flat - проверка всех сфер пачками, Bvh - иерархическое отсечение
+	class CullingScene : public BenchScene {
+	public:
+		enum class Mode {
+
+			Off,
+			Flat,
+			Bvh
+		};
+
+		explicit CullingScene(const Mode mode) : m_mode(mode) {}
+
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_material_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			m_mesh = make_mesh(cube_positions_colors, cube_indexes);
+			m_material.id = 0;
+
+			m_registry.reserve<TransformComponent>(objects_count);
+			m_registry.reserve<MeshRendererComponent>(objects_count);
+			m_registry.reserve<BoundsComponent>(objects_count);
+			m_transform_hierarchy.reserve(objects_count);
+			Random random(12345);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+
+				const Entity entity = m_registry.create();
+				const TransformNode node = m_transform_hierarchy.create();
+				m_transform_hierarchy.set_local(node, glm::vec3(random.next(-50.f, 50.f), random.next(-50.f, 50.f), random.next(-50.f, 50.f)),
+												glm::vec3(0.f, 0.f, random.next(0.f, 360.f)), glm::vec3(0.5f));
+				m_registry.emplace<TransformComponent>(entity, node);
+				m_registry.emplace<MeshRendererComponent>(entity, m_pShaderProgram.get(), m_mesh.p_vao.get(), &m_material);
+				//Куб -0.5..0.5: радиус описанной сферы - половина диагонали
+				m_registry.emplace<BoundsComponent>(entity, glm::vec3(0.f), 0.8661f);
+			}
+			m_transform_hierarchy.update();
+			//Сцена статичная - дерево строится один раз
+			std::vector<Aabb> bounds;
+			gather_world_bounds(m_registry, m_transform_hierarchy, m_bvh_entities, bounds);
+			m_bvh.build(bounds);
+			return true;
+		}
+
+		void render(const Camera& camera, RenderQueue& render_queue) override {
+
+			if (m_mode == Mode::Off) {
+				submit_mesh_renderers(m_registry, m_transform_hierarchy, render_queue);
+				return;
+			}
+			const Frustum frustum = Frustum::from_matrix(camera.get_projection_matrix() * camera.get_view_matrix());
+			if (m_mode == Mode::Flat)
+				submit_visible_mesh_renderers(m_registry, m_transform_hierarchy, frustum, m_frustum_culler, render_queue);
+			else
+				submit_visible_mesh_renderers(m_registry, m_transform_hierarchy, frustum, m_bvh, m_bvh_entities, m_visible, render_queue);
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			if (m_mode == Mode::Bvh) {
+
+				const Bvh::Statistics& statistics = m_bvh.get_statistics();
+				counters.push_back({ "bvh_nodes_visited", static_cast<double>(statistics.nodes_visited) });
+				counters.push_back({ "objects_tested", static_cast<double>(statistics.primitives_tested) });
+				counters.push_back({ "objects_culled", static_cast<double>(m_bvh.get_primitives_count() - m_visible.size()) });
+				return;
+			}
+			const FrustumCuller::Statistics& statistics = m_frustum_culler.get_statistics();
+			counters.push_back({ "objects_tested", static_cast<double>(statistics.tested) });
+			counters.push_back({ "objects_culled", static_cast<double>(statistics.culled) });
+		}
+
+	private:
+		Mode m_mode;
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		Mesh m_mesh;
+		Material m_material;
+		Registry m_registry;
+		TransformHierarchy m_transform_hierarchy;
+		FrustumCuller m_frustum_culler;
+		Bvh m_bvh;
+		std::vector<Entity> m_bvh_entities;
+		std::vector<uint32_t> m_visible;
+	};
+
+	template<typename Func>
+	static double measure_ms(Func&& func) {
+
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	//Сетка из ~objects_count * 64 вершин, записанная в .semesh: время загрузки через отображение файла
+	//против чтения файла в память и заливки оттуда. Файл только что записан и лежит в кэше ОС - сравнивается путь в памяти процесса, не диск
+	class MeshFileScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_material_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			const unsigned int side = std::max(2u, static_cast<unsigned int>(std::sqrt(static_cast<float>(objects_count)) * 8.f));
+			std::vector<float> positions_colors;
+			positions_colors.reserve(static_cast<size_t>(side) * side * 6);
+			for (unsigned int y = 0; y < side; ++y) {
+				for (unsigned int x = 0; x < side; ++x) {
+
+					const float u = static_cast<float>(x) / (side - 1);
+					const float v = static_cast<float>(y) / (side - 1);
+					positions_colors.insert(positions_colors.end(), { 0.f, u * 10.f - 5.f, v * 10.f - 5.f, u, v, 1.f - u });
+				}
+			}
+			std::vector<uint32_t> indexes;
+			indexes.reserve(static_cast<size_t>(side - 1) * (side - 1) * 6);
+			for (unsigned int y = 0; y + 1 < side; ++y) {
+				for (unsigned int x = 0; x + 1 < side; ++x) {
+
+					const uint32_t corner = y * side + x;
+					indexes.insert(indexes.end(), { corner, corner + 1, corner + side, corner + side + 1, corner + side, corner + 1 });
+				}
+			}
+
+			const BufferLayout buffer_layout{ ShaderDataType::Float3, ShaderDataType::Float3 };
+			m_path = (std::filesystem::temp_directory_path() / "simple_engine_bench.semesh").string();
+			if (!MeshFile::write(m_path, buffer_layout, positions_colors.data(), side * side, indexes.data(), indexes.size()))
+				return false;
+			m_file_mb = static_cast<double>(std::filesystem::file_size(m_path)) / (1024.0 * 1024.0);
+
+			//Обычный путь: файл целиком в вектор, из него в GL
+			Mesh stream_mesh;
+			m_stream_load_ms = measure_ms([&] {
+
+				std::ifstream stream(m_path, std::ios::binary);
+				MeshFileHeader header;
+				stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+				std::vector<char> file_data(static_cast<size_t>(header.index_data_offset + header.indexes_count * header.index_size));
+				stream.seekg(0);
+				stream.read(file_data.data(), file_data.size());
+				stream_mesh.p_vao = std::make_unique<VertexArray>();
+				stream_mesh.p_vbo = std::make_unique<VertexBuffer>(file_data.data() + header.vertex_data_offset, header.vertices_count * header.vertex_stride, buffer_layout);
+				stream_mesh.p_index_buffer = std::make_unique<IndexBuffer>(file_data.data() + header.index_data_offset, header.indexes_count);
+				stream_mesh.p_vao->add_vertex_buffer(*stream_mesh.p_vbo);
+				stream_mesh.p_vao->set_index_buffer(*stream_mesh.p_index_buffer);
+			});
+
+			m_mapped_load_ms = measure_ms([&] {
+
+				m_pMesh = StaticMesh::load(m_path);
+			});
+			std::filesystem::remove(m_path);
+			return m_pMesh != nullptr;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& render_queue) override {
+
+			render_queue.submit(*m_pShaderProgram, m_pMesh->get_vertex_array(), m_material, glm::mat4(1.f));
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "mesh_file_mb", m_file_mb });
+			counters.push_back({ "mesh_vertices", static_cast<double>(m_pMesh->get_vertices_count()) });
+			counters.push_back({ "mapped_load_ms", m_mapped_load_ms });
+			counters.push_back({ "stream_load_ms", m_stream_load_ms });
+		}
+
+	private:
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::unique_ptr<StaticMesh> m_pMesh;
+		Material m_material;
+		std::string m_path;
+		double m_file_mb = 0.0;
+		double m_mapped_load_ms = 0.0;
+		double m_stream_load_ms = 0.0;
+	};
+
+	//Импорт OBJ одним потоком и на JobSystem; нарисованный меш - результат многопоточного импорта после оптимизации
+	class MeshImportScene : public BenchScene {
+	public:
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_material_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			const unsigned int side = std::max(2u, static_cast<unsigned int>(std::sqrt(static_cast<float>(objects_count)) * 8.f));
+			m_path = (std::filesystem::temp_directory_path() / "simple_engine_bench.obj").string();
+			{
+				std::ofstream stream(m_path);
+				for (unsigned int y = 0; y < side; ++y) {
+					for (unsigned int x = 0; x < side; ++x) {
+
+						const float u = static_cast<float>(x) / (side - 1);
+						const float v = static_cast<float>(y) / (side - 1);
+						stream << "v 0 " << u * 10.f - 5.f << " " << v * 10.f - 5.f << "\nvt " << u << " " << v << "\n";
+					}
+				}
+				for (unsigned int y = 0; y + 1 < side; ++y) {
+					for (unsigned int x = 0; x + 1 < side; ++x) {
+
+						const unsigned int corner = y * side + x + 1;
+						stream << "f " << corner << "/" << corner << " " << corner + 1 << "/" << corner + 1 << " "
+							   << corner + side + 1 << "/" << corner + side + 1 << " " << corner + side << "/" << corner + side << "\n";
+					}
+				}
+				if (!stream)
+					return false;
+			}
+			m_file_mb = static_cast<double>(std::filesystem::file_size(m_path)) / (1024.0 * 1024.0);
+
+			ImportedMesh mesh;
+			MeshImporter single_thread_importer;
+			const bool single_thread_result = single_thread_importer.import(m_path, mesh);
+			m_single_thread_statistics = single_thread_importer.get_statistics();
+
+			JobSystem job_system;
+			MeshImporter importer(&job_system);
+			const bool result = importer.import(m_path, mesh);
+			m_statistics = importer.get_statistics();
+			std::filesystem::remove(m_path);
+			if (!single_thread_result || !result)
+				return false;
+
+			//Тот же путь, что у конвертера: порядок под кэш вершин, затем под выборку, индексы по возможности 16-битные
+			m_acmr_before = analyze_vertex_cache(mesh.indexes.data(), mesh.indexes.size(), mesh.vertices_count).acmr;
+			if (!optimize_vertex_cache(mesh.indexes.data(), mesh.indexes.size(), mesh.vertices_count)
+				|| !optimize_vertex_fetch(mesh.vertex_data.data(), mesh.vertices_count, mesh.buffer_layout.get_stride(), mesh.indexes.data(), mesh.indexes.size()))
+				return false;
+			mesh.vertex_data.resize(mesh.vertices_count * mesh.buffer_layout.get_stride());
+			m_acmr_after = analyze_vertex_cache(mesh.indexes.data(), mesh.indexes.size(), mesh.vertices_count).acmr;
+
+			//uv шейдеру не нужен - только позиция и нормаль в роли цвета
+			m_mesh.p_vao = std::make_unique<VertexArray>();
+			m_mesh.p_vbo = std::make_unique<VertexBuffer>(mesh.vertex_data.data(), mesh.vertex_data.size(), mesh.buffer_layout);
+			std::vector<uint16_t> indexes16;
+			m_index_bits = narrow_indexes(mesh.indexes.data(), mesh.indexes.size(), mesh.vertices_count, indexes16) ? 16 : 32;
+			m_mesh.p_index_buffer = m_index_bits == 16
+				? std::make_unique<IndexBuffer>(indexes16.data(), indexes16.size(), VertexBuffer::EUsage::Static, IndexBuffer::EType::UnsignedShort)
+				: std::make_unique<IndexBuffer>(mesh.indexes.data(), mesh.indexes.size());
+			m_mesh.p_vao->add_vertex_buffer(*m_mesh.p_vbo);
+			m_mesh.p_vao->set_index_buffer(*m_mesh.p_index_buffer);
+			m_vertices_count = mesh.vertices_count;
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& render_queue) override {
+
+			render_queue.submit(*m_pShaderProgram, *m_mesh.p_vao, m_material, glm::mat4(1.f));
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "obj_file_mb", m_file_mb });
+			counters.push_back({ "mesh_vertices", static_cast<double>(m_vertices_count) });
+			counters.push_back({ "import_threads", static_cast<double>(m_statistics.threads_count) });
+			counters.push_back({ "import_mb_per_s", m_statistics.megabytes_per_second });
+			counters.push_back({ "import_mb_per_s_single_thread", m_single_thread_statistics.megabytes_per_second });
+			counters.push_back({ "import_peak_mb", m_statistics.peak_memory_bytes / (1024.0 * 1024.0) });
+			counters.push_back({ "acmr_before", m_acmr_before });
+			counters.push_back({ "acmr_after", m_acmr_after });
+			counters.push_back({ "index_bits", static_cast<double>(m_index_bits) });
+		}
+
+	private:
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		Mesh m_mesh;
+		Material m_material;
+		std::string m_path;
+		double m_file_mb = 0.0;
+		size_t m_vertices_count = 0;
+		MeshImporter::Statistics m_statistics;
+		MeshImporter::Statistics m_single_thread_statistics;
+		double m_acmr_before = 0.0;
+		double m_acmr_after = 0.0;
+		unsigned int m_index_bits = 32;
+	};
+
+	//Плотные сферы вдоль направления камеры на расстоянии от 2 до 300: с LodComponent дальние рисуются грубыми уровнями.
+	//lod_off - те же сущности с выключенным выбором, всегда уровень 0
+	class LodScene : public BenchScene {
+	public:
+		explicit LodScene(const bool use_lods) { m_lod_settings.enabled = use_lods; }
+
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(bench_vertex_shader, make_material_fragment_shader(1.f).c_str());
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			//UV-сфера без шва: вершины меридиана 0 и полюса общие, иначе simplify_mesh не тронет их окрестность
+			constexpr unsigned int segments = 96;
+			constexpr unsigned int rings = 48;
+			std::vector<float> positions_colors;
+			const auto add_vertex = [&positions_colors](const glm::vec3& position) {
+				positions_colors.insert(positions_colors.end(), { position.x, position.y, position.z, position.x * 0.5f + 0.5f, position.y * 0.5f + 0.5f, position.z * 0.5f + 0.5f });
+			};
+			add_vertex(glm::vec3(0.f, 1.f, 0.f));
+			for (unsigned int ring = 1; ring < rings; ++ring) {
+				const float theta = glm::pi<float>() * ring / rings;
+				for (unsigned int segment = 0; segment < segments; ++segment) {
+					const float phi = glm::two_pi<float>() * segment / segments;
+					add_vertex(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+				}
+			}
+			add_vertex(glm::vec3(0.f, -1.f, 0.f));
+			const uint32_t south_pole = 1 + (rings - 1) * segments;
+			const auto ring_vertex = [](const unsigned int ring, const unsigned int segment) { return 1 + (ring - 1) * segments + segment % segments; };
+			std::vector<uint32_t> indexes;
+			for (unsigned int segment = 0; segment < segments; ++segment) {
+				indexes.insert(indexes.end(), { 0, ring_vertex(1, segment + 1), ring_vertex(1, segment) });
+				indexes.insert(indexes.end(), { south_pole, ring_vertex(rings - 1, segment), ring_vertex(rings - 1, segment + 1) });
+			}
+			for (unsigned int ring = 1; ring + 1 < rings; ++ring) {
+				for (unsigned int segment = 0; segment < segments; ++segment) {
+					const uint32_t a = ring_vertex(ring, segment);
+					const uint32_t b = ring_vertex(ring, segment + 1);
+					const uint32_t c = ring_vertex(ring + 1, segment);
+					const uint32_t d = ring_vertex(ring + 1, segment + 1);
+					indexes.insert(indexes.end(), { a, b, d, a, d, c });
+				}
+			}
+
+			const size_t vertices_count = positions_colors.size() / 6;
+			m_lods = build_lod_chain(indexes, positions_colors.data(), vertices_count, 6 * sizeof(float), MeshFileHeader::max_lods, 0.1f, true);
+			m_mesh.p_vao = std::make_unique<VertexArray>();
+			m_mesh.p_vbo = std::make_unique<VertexBuffer>(positions_colors.data(), positions_colors.size() * sizeof(float),
+														  BufferLayout{ ShaderDataType::Float3, ShaderDataType::Float3 });
+			m_mesh.p_index_buffer = std::make_unique<IndexBuffer>(indexes.data(), indexes.size());
+			m_mesh.p_vao->add_vertex_buffer(*m_mesh.p_vbo);
+			m_mesh.p_vao->set_index_buffer(*m_mesh.p_index_buffer);
+			m_material.id = 0;
+
+			m_registry.reserve<TransformComponent>(objects_count);
+			m_registry.reserve<MeshRendererComponent>(objects_count);
+			m_registry.reserve<BoundsComponent>(objects_count);
+			m_registry.reserve<LodComponent>(objects_count);
+			m_transform_hierarchy.reserve(objects_count);
+			Random random(12345);
+			for (unsigned int i = 0; i < objects_count; ++i) {
+
+				const Entity entity = m_registry.create();
+				const TransformNode node = m_transform_hierarchy.create();
+				const float distance = random.next(2.f, 300.f);
+				const float spread = distance * 0.4f;
+				m_transform_hierarchy.set_local(node, glm::vec3(distance - 5.f, random.next(-spread, spread), random.next(-spread, spread)),
+												glm::vec3(0.f), glm::vec3(0.5f));
+				m_registry.emplace<TransformComponent>(entity, node);
+				m_registry.emplace<MeshRendererComponent>(entity, m_pShaderProgram.get(), m_mesh.p_vao.get(), &m_material);
+				m_registry.emplace<BoundsComponent>(entity, glm::vec3(0.f), 1.f);
+				m_registry.emplace<LodComponent>(entity, m_lods.data(), static_cast<unsigned int>(m_lods.size()), 0u);
+			}
+			m_transform_hierarchy.update();
+			return true;
+		}
+
+		void render(const Camera& camera, RenderQueue& render_queue) override {
+
+			m_statistics = select_lods(m_registry, m_transform_hierarchy, camera, static_cast<float>(frame_height), m_lod_settings);
+			const Frustum frustum = Frustum::from_matrix(camera.get_projection_matrix() * camera.get_view_matrix());
+			submit_visible_mesh_renderers(m_registry, m_transform_hierarchy, frustum, m_frustum_culler, render_queue);
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			counters.push_back({ "mesh_lods", static_cast<double>(m_lods.size()) });
+			counters.push_back({ "lod_objects", static_cast<double>(m_statistics.objects) });
+			counters.push_back({ "lod_triangles", static_cast<double>(m_statistics.triangles) });
+			counters.push_back({ "full_detail_triangles", static_cast<double>(m_statistics.full_detail_triangles) });
+			counters.push_back({ "objects_culled", static_cast<double>(m_frustum_culler.get_statistics().culled) });
+		}
+
+	private:
+		LodSettings m_lod_settings;
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		Mesh m_mesh;
+		Material m_material;
+		std::vector<MeshLod> m_lods;
+		Registry m_registry;
+		TransformHierarchy m_transform_hierarchy;
+		FrustumCuller m_frustum_culler;
+		LodStatistics m_statistics;
+	};
+
+	const char* textured_vertex_shader =
+		R"(#version 460
+		layout(location = 0) in vec3 vertex_position;
+		layout(location = 1) in vec3 vertex_color;
+		uniform mat4 model_matrix;
+		layout(std140) uniform CameraData {
+			mat4 view_matrix;
+			mat4 projection_matrix;
+			mat4 view_projection_matrix;
+			vec4 camera_position;
+		};
+		out vec2 uv;
+		void main() {
+			uv = vertex_position.yz + 0.5;
+			gl_Position = view_projection_matrix * model_matrix * vec4(vertex_position, 1.0);
+		})";
+
+	const char* textured_fragment_shader =
+		R"(#version 460
+		in vec2 uv;
+		uniform sampler2D albedo;
+		out vec4 frag_color;
+		void main() {
+			frag_color = texture(albedo, uv);
+		})";
+
+	void append_u32_be(std::string& data, const uint32_t value) {
+
+		const char bytes[4] = { static_cast<char>(value >> 24), static_cast<char>(value >> 16), static_cast<char>(value >> 8), static_cast<char>(value) };
+		data.append(bytes, 4);
+	}
+
+	void append_u32_le(std::string& data, const uint32_t value) {
+
+		const char bytes[4] = { static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+		data.append(bytes, 4);
+	}
+
+	uint32_t crc32(const std::string& data, const size_t offset) {
+
+		uint32_t crc = 0xFFFFFFFF;
+		for (size_t i = offset; i < data.size(); ++i) {
+			crc ^= static_cast<uint8_t>(data[i]);
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+		}
+		return ~crc;
+	}
+
+	void append_png_chunk(std::string& png, const char* type, const std::string& chunk) {
+
+		append_u32_be(png, static_cast<uint32_t>(chunk.size()));
+		const size_t type_offset = png.size();
+		png.append(type, 4);
+		png += chunk;
+		append_u32_be(png, crc32(png, type_offset));
+	}
+
+	//PNG со строками через фильтр Sub и zlib из несжатых deflate блоков: сжатие бенчмарку не нужно, а разбор тот же
+	std::string encode_png(const std::vector<uint8_t>& rgba, const uint32_t width, const uint32_t height) {
+
+		std::string filtered;
+		filtered.reserve((static_cast<size_t>(width) * 4 + 1) * height);
+		for (uint32_t y = 0; y < height; ++y) {
+			filtered += static_cast<char>(1);
+			const uint8_t* pRow = rgba.data() + static_cast<size_t>(y) * width * 4;
+			for (uint32_t i = 0; i < width * 4; ++i)
+				filtered += static_cast<char>(pRow[i] - (i >= 4 ? pRow[i - 4] : 0));
+		}
+
+		std::string zlib = { 0x78, 0x01 };
+		for (size_t offset = 0; offset < filtered.size(); offset += 65535) {
+			const uint32_t length = static_cast<uint32_t>(std::min<size_t>(65535, filtered.size() - offset));
+			const bool final_block = offset + length == filtered.size();
+			const char header[5] = { static_cast<char>(final_block ? 1 : 0), static_cast<char>(length), static_cast<char>(length >> 8),
+									 static_cast<char>(~length), static_cast<char>(~length >> 8) };
+			zlib.append(header, 5);
+			zlib.append(filtered, offset, length);
+		}
+		uint32_t a = 1;
+		uint32_t b = 0;
+		for (const char byte : filtered) {
+			a = (a + static_cast<uint8_t>(byte)) % 65521;
+			b = (b + a) % 65521;
+		}
+		append_u32_be(zlib, (b << 16) | a);
+
+		std::string png = "\x89PNG\r\n\x1A\n";
+		std::string header;
+		append_u32_be(header, width);
+		append_u32_be(header, height);
+		header += { 8, 6, 0, 0, 0 };
+		append_png_chunk(png, "IHDR", header);
+		append_png_chunk(png, "IDAT", zlib);
+		append_png_chunk(png, "IEND", std::string());
+		return png;
+	}
+
+	//Несжатый 32-битный TGA, строки сверху вниз
+	std::string encode_tga(const std::vector<uint8_t>& rgba, const uint32_t width, const uint32_t height) {
+
+		std::string tga(18, '\0');
+		tga[2] = 2;
+		tga[12] = static_cast<char>(width);
+		tga[13] = static_cast<char>(width >> 8);
+		tga[14] = static_cast<char>(height);
+		tga[15] = static_cast<char>(height >> 8);
+		tga[16] = 32;
+		tga[17] = 0x28;
+		for (size_t i = 0; i < rgba.size(); i += 4) {
+			const char bgra[4] = { static_cast<char>(rgba[i + 2]), static_cast<char>(rgba[i + 1]), static_cast<char>(rgba[i]), static_cast<char>(rgba[i + 3]) };
+			tga.append(bgra, 4);
+		}
+		return tga;
+	}
+
+	//KTX2 с одним уровнем R8G8B8A8_SRGB; без DFD - декодеру движка он не нужен
+	std::string encode_ktx2(const std::vector<uint8_t>& rgba, const uint32_t width, const uint32_t height) {
+
+		std::string ktx2 = "\xABKTX 20\xBB\r\n\x1A\n";
+		for (const uint32_t value : { 43u, 1u, width, height, 0u, 0u, 1u, 1u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u })
+			append_u32_le(ktx2, value);
+		const uint32_t data_offset = static_cast<uint32_t>(ktx2.size()) + 24;
+		for (const uint32_t value : { data_offset, 0u, static_cast<uint32_t>(rgba.size()), 0u, static_cast<uint32_t>(rgba.size()), 0u })
+			append_u32_le(ktx2, value);
+		ktx2.append(reinterpret_cast<const char*>(rgba.data()), rgba.size());
+		return ktx2;
+	}
+
+	//s_textures_count картинок (PNG, TGA, KTX2 по кругу) грузятся через TextureManager с бюджетом памяти в три четверти
+	//их полного размера. Видна половина текстур, окно сдвигается каждые s_window_frames кадров - невидимые теряют
+	//подробные уровни, а снова видимые перечитываются
+	class TexturesScene : public BenchScene {
+	public:
+		~TexturesScene() override {
+
+			//Задачи декодирования читают файлы - сначала дожидаемся их
+			m_pTextureManager = nullptr;
+			for (const std::string& path : m_paths)
+				std::filesystem::remove(path);
+		}
+
+		bool init(const unsigned int objects_count) override {
+
+			m_pShaderProgram = std::make_unique<ShaderProgram>(textured_vertex_shader, textured_fragment_shader);
+			if (!m_pShaderProgram->isCompiled())
+				return false;
+
+			Random random(4242);
+			std::vector<uint8_t> rgba(static_cast<size_t>(s_texture_size) * s_texture_size * 4);
+			for (unsigned int i = 0; i < s_textures_count; ++i) {
+
+				const uint8_t red = static_cast<uint8_t>(random.next(64.f, 255.f));
+				const uint8_t green = static_cast<uint8_t>(random.next(64.f, 255.f));
+				for (uint32_t y = 0; y < s_texture_size; ++y) {
+					for (uint32_t x = 0; x < s_texture_size; ++x) {
+
+						uint8_t* pPixel = rgba.data() + (static_cast<size_t>(y) * s_texture_size + x) * 4;
+						const bool checker = ((x / 32) + (y / 32)) % 2 == 0;
+						pPixel[0] = checker ? red : static_cast<uint8_t>(x / 2);
+						pPixel[1] = checker ? green : static_cast<uint8_t>(y / 2);
+						pPixel[2] = static_cast<uint8_t>(random.next(0.f, 255.f));
+						pPixel[3] = 255;
+					}
+				}
+
+				const char* extensions[] = { ".png", ".tga", ".ktx2" };
+				const std::string file_data = i % 3 == 0 ? encode_png(rgba, s_texture_size, s_texture_size)
+					: i % 3 == 1 ? encode_tga(rgba, s_texture_size, s_texture_size)
+					: encode_ktx2(rgba, s_texture_size, s_texture_size);
+				m_paths.push_back((std::filesystem::temp_directory_path() / ("simple_engine_bench_texture_" + std::to_string(i) + extensions[i % 3])).string());
+				std::ofstream stream(m_paths.back(), std::ios::binary);
+				stream.write(file_data.data(), file_data.size());
+				if (!stream)
+					return false;
+			}
+
+			m_pTextureManager = std::make_unique<TextureManager>(&m_job_system);
+			//Полная цепочка мипов - 4/3 нулевого уровня
+			const size_t texture_bytes = static_cast<size_t>(s_texture_size) * s_texture_size * 4 * 4 / 3;
+			m_pTextureManager->settings.memory_budget_bytes = texture_bytes * s_textures_count * 3 / 4;
+			m_pTextureManager->settings.upload_budget_bytes = texture_bytes * 2;
+			for (const std::string& path : m_paths)
+				m_textures.push_back(m_pTextureManager->load(path));
+
+			m_mesh = make_mesh(quad_positions_colors, quad_indexes);
+			m_model_matrices = make_model_matrices(objects_count);
+			return true;
+		}
+
+		void render(const Camera& /*camera*/, RenderQueue& /*render_queue*/) override {
+
+			m_pTextureManager->update();
+			const size_t window_start = m_frame / s_window_frames * s_textures_count / 4;
+			++m_frame;
+
+			m_pShaderProgram->bind();
+			for (size_t i = 0; i < m_model_matrices.size(); ++i) {
+
+				const size_t texture = m_textures[(window_start + i % (s_textures_count / 2)) % s_textures_count];
+				const Texture2D* pTexture = m_pTextureManager->use(texture);
+				if (!pTexture)
+					continue;
+				pTexture->bind(0);
+				m_pShaderProgram->setMatrix4(model_matrix_uniform, m_model_matrices[i]);
+				Renderer_OpenGL::draw(*m_mesh.p_vao);
+			}
+		}
+
+		void get_counters(std::vector<Counter>& counters) const override {
+
+			const TextureManager::Statistics& statistics = m_pTextureManager->get_statistics();
+			counters.push_back({ "textures_ready", static_cast<double>(statistics.ready) });
+			counters.push_back({ "textures_failed", static_cast<double>(statistics.failed) });
+			counters.push_back({ "decode_mb_per_s", statistics.decode_megabytes_per_second });
+			counters.push_back({ "decoded_mb", statistics.decoded_bytes / (1024.0 * 1024.0) });
+			counters.push_back({ "uploaded_mb", statistics.uploaded_bytes / (1024.0 * 1024.0) });
+			counters.push_back({ "upload_ms", statistics.upload_ms });
+			counters.push_back({ "resident_mb", statistics.resident_bytes / (1024.0 * 1024.0) });
+			counters.push_back({ "budget_mb", m_pTextureManager->settings.memory_budget_bytes / (1024.0 * 1024.0) });
+			counters.push_back({ "evicted_levels", static_cast<double>(statistics.evicted_levels) });
+			counters.push_back({ "restored_textures", static_cast<double>(statistics.restored_textures) });
+			counters.push_back({ "failed_restores", static_cast<double>(statistics.failed_restores) });
+		}
+
+	private:
+		static constexpr unsigned int s_textures_count = 24;
+		static constexpr uint32_t s_texture_size = 512;
+		static constexpr unsigned int s_window_frames = 30;
+		JobSystem m_job_system;
+		std::unique_ptr<TextureManager> m_pTextureManager;
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::vector<std::string> m_paths;
+		std::vector<size_t> m_textures;
+		Mesh m_mesh;
+		std::vector<glm::mat4> m_model_matrices;
+		size_t m_frame = 0;
+	};
+
+	void run_bvh_benchmark(const unsigned int primitives_count, std::ostream& stream) {
+
+		constexpr unsigned int frustum_queries_count = 100;
+		constexpr unsigned int ray_queries_count = 100000;
+		constexpr unsigned int aabb_queries_count = 100000;
+		constexpr float world_size = 1000.f;
+
+		Random random(12345);
+		std::vector<Aabb> bounds(primitives_count);
+		for (Aabb& box : bounds) {
+
+			const glm::vec3 center(random.next(-world_size, world_size), random.next(-world_size, world_size), random.next(-world_size, world_size));
+			const glm::vec3 half_size(random.next(0.1f, 2.f), random.next(0.1f, 2.f), random.next(0.1f, 2.f));
+			box = { center - half_size, center + half_size };
+		}
+
+		Bvh bvh;
+		const double build_ms = measure_ms([&] { bvh.build(bounds); });
+
+		//Все коробки немного сдвинулись - типичный кадр с движущимися объектами
+		for (Aabb& box : bounds) {
+
+			const glm::vec3 offset(random.next(-1.f, 1.f), random.next(-1.f, 1.f), random.next(-1.f, 1.f));
+			box.min += offset;
+			box.max += offset;
+		}
+		const double refit_ms = measure_ms([&] { bvh.refit(bounds); });
+
+		std::vector<uint32_t> result;
+		size_t frustum_visible_total = 0;
+		unsigned long long nodes_visited_total = 0;
+		const glm::mat4 projection_matrix = glm::perspective(glm::radians(60.f), 4.f / 3.f, 0.1f, world_size);
+		const double frustum_ms = measure_ms([&] {
+			for (unsigned int i = 0; i < frustum_queries_count; ++i) {
+
+				const float angle = glm::radians(360.f * i / frustum_queries_count);
+				const glm::mat4 view_matrix = glm::lookAt(glm::vec3(0.f), glm::vec3(std::cos(angle), std::sin(angle), 0.f), glm::vec3(0.f, 0.f, 1.f));
+				bvh.cull(Frustum::from_matrix(projection_matrix * view_matrix), result);
+				frustum_visible_total += result.size();
+				nodes_visited_total += bvh.get_statistics().nodes_visited;
+			}
+		});
+
+		unsigned int ray_hits = 0;
+		const double ray_ms = measure_ms([&] {
+			RayHit hit;
+			for (unsigned int i = 0; i < ray_queries_count; ++i) {
+
+				Ray ray;
+				ray.origin = glm::vec3(random.next(-world_size, world_size), random.next(-world_size, world_size), random.next(-world_size, world_size));
+				ray.direction = glm::vec3(random.next(-1.f, 1.f), random.next(-1.f, 1.f), random.next(-1.f, 1.f));
+				if (bvh.raycast(ray, hit))
+					++ray_hits;
+			}
+		});
+
+		size_t aabb_results_total = 0;
+		const double aabb_ms = measure_ms([&] {
+			for (unsigned int i = 0; i < aabb_queries_count; ++i) {
+
+				const glm::vec3 center(random.next(-world_size, world_size), random.next(-world_size, world_size), random.next(-world_size, world_size));
+				bvh.query_aabb({ center - glm::vec3(10.f), center + glm::vec3(10.f) }, result);
+				aabb_results_total += result.size();
+			}
+		});
+
+		const Bvh::Statistics& statistics = bvh.get_statistics();
+		stream << "{\n  \"bvh\": {\n";
+		stream << "    \"primitives\": " << primitives_count << ",\n";
+		stream << "    \"nodes\": " << statistics.nodes << ",\n";
+		stream << "    \"leaves\": " << statistics.leaves << ",\n";
+		stream << "    \"max_depth\": " << statistics.max_depth << ",\n";
+		stream << "    \"build_ms\": " << build_ms << ",\n";
+		stream << "    \"refit_ms\": " << refit_ms << ",\n";
+		stream << "    \"frustum_queries\": " << frustum_queries_count << ",\n";
+		stream << "    \"frustum_query_ms_mean\": " << frustum_ms / frustum_queries_count << ",\n";
+		stream << "    \"frustum_visible_mean\": " << static_cast<double>(frustum_visible_total) / frustum_queries_count << ",\n";
+		stream << "    \"frustum_nodes_visited_mean\": " << static_cast<double>(nodes_visited_total) / frustum_queries_count << ",\n";
+		stream << "    \"ray_queries\": " << ray_queries_count << ",\n";
+		stream << "    \"ray_queries_per_s\": " << (ray_ms > 0 ? ray_queries_count * 1000.0 / ray_ms : 0.0) << ",\n";
+		stream << "    \"ray_hits\": " << ray_hits << ",\n";
+		stream << "    \"aabb_queries\": " << aabb_queries_count << ",\n";
+		stream << "    \"aabb_queries_per_s\": " << (aabb_ms > 0 ? aabb_queries_count * 1000.0 / aabb_ms : 0.0) << ",\n";
+		stream << "    \"aabb_results_mean\": " << static_cast<double>(aabb_results_total) / aabb_queries_count << "\n";
+		stream << "  }\n}\n";
+	}
+
+	void run_jobs_scaling_benchmark(const unsigned int objects_count, std::ostream& stream) {
+
+		constexpr unsigned int iterations_count = 20;
+		const unsigned int max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+		//Та же форма, что в transforms_hierarchy: корни по 15 детей, все узлы грязные каждую итерацию
+		Random random(12345);
+		TransformHierarchy transform_hierarchy;
+		std::vector<TransformNode> roots;
+		transform_hierarchy.reserve(objects_count);
+		for (unsigned int i = 0; i < objects_count; ++i) {
+
+			const bool root = i % 16 == 0;
+			const TransformNode node = transform_hierarchy.create(root ? invalid_transform_node : roots.back());
+			transform_hierarchy.set_local(node, glm::vec3(random.next(-50.f, 50.f), random.next(-50.f, 50.f), random.next(-50.f, 50.f)),
+										  glm::vec3(0.f, 0.f, random.next(0.f, 360.f)), glm::vec3(root ? 1.f : 0.1f));
+			if (root)
+				roots.push_back(node);
+		}
+
+		FrustumCuller frustum_culler;
+		frustum_culler.reserve(objects_count);
+		for (unsigned int i = 0; i < objects_count; ++i) {
+			frustum_culler.add_sphere(glm::vec3(random.next(-50.f, 50.f), random.next(-50.f, 50.f), random.next(-50.f, 50.f)), 0.8661f);
+		}
+		const glm::mat4 projection_matrix = glm::perspective(glm::radians(60.f), 4.f / 3.f, 0.1f, 100.f);
+		const glm::mat4 view_matrix = glm::lookAt(glm::vec3(-5.f, 0.f, 0.f), glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f));
+		const Frustum frustum = Frustum::from_matrix(projection_matrix * view_matrix);
+
+		stream << "{\n  \"jobs_scaling\": {\n";
+		stream << "    \"objects\": " << objects_count << ",\n";
+		stream << "    \"iterations\": " << iterations_count << ",\n";
+		stream << "    \"runs\": [\n";
+		double transforms_single_ms = 0, culling_single_ms = 0;
+		for (unsigned int threads_count = 1; threads_count <= max_threads; ++threads_count) {
+
+			//JobSystem(0) взял бы все ядра, поэтому однопоточный прогон - вовсе без неё
+			const std::unique_ptr<JobSystem> pJobSystem = threads_count > 1 ? std::make_unique<JobSystem>(threads_count - 1) : nullptr;
+			const double transforms_ms = measure_ms([&] {
+				for (unsigned int iteration = 0; iteration < iterations_count; ++iteration) {
+
+					for (const TransformNode root : roots) {
+						transform_hierarchy.set_rotation(root, transform_hierarchy.get_rotation(root) + glm::vec3(0.f, 0.f, 1.f));
+					}
+					transform_hierarchy.update(pJobSystem.get());
+				}
+			}) / iterations_count;
+			const double culling_ms = measure_ms([&] {
+				for (unsigned int iteration = 0; iteration < iterations_count; ++iteration) {
+					frustum_culler.cull(frustum, pJobSystem.get());
+				}
+			}) / iterations_count;
+
+			if (threads_count == 1) {
+				transforms_single_ms = transforms_ms;
+				culling_single_ms = culling_ms;
+			}
+			stream << "      { \"threads\": " << threads_count
+				   << ", \"transforms_update_ms\": " << transforms_ms
+				   << ", \"transforms_speedup\": " << (transforms_ms > 0 ? transforms_single_ms / transforms_ms : 0.0)
+				   << ", \"frustum_cull_ms\": " << culling_ms
+				   << ", \"frustum_cull_speedup\": " << (culling_ms > 0 ? culling_single_ms / culling_ms : 0.0)
+				   << " }" << (threads_count < max_threads ? "," : "") << "\n";
+		}
+		stream << "    ]\n  }\n}\n";
+	}
+
+	struct SceneFactory {
+
+		const char* name;
+		std::function<std::unique_ptr<BenchScene>()> create;
+	};
+
+	const std::vector<SceneFactory>& get_scene_factories() {
+
+		static const std::vector<SceneFactory> scene_factories = {
+			{ "quads",   [] { return std::make_unique<SingleMeshScene>(false); } },
+			{ "cubes",   [] { return std::make_unique<SingleMeshScene>(true); } },
+			{ "shaders", [] { return std::make_unique<ManyShadersScene>(); } },
+			{ "shader_compile_sync", [] { return std::make_unique<ShaderCompileScene>(false); } },
+			{ "shader_compile_async", [] { return std::make_unique<ShaderCompileScene>(true); } },
+			{ "vaos",    [] { return std::make_unique<ManyVaosScene>(); } },
+			{ "batch_quads", [] { return std::make_unique<BatchScene>(false); } },
+			{ "batch_cubes", [] { return std::make_unique<BatchScene>(true); } },
+			{ "instanced_cubes", [] { return std::make_unique<InstancedScene>(); } },
+			{ "render_queue", [] { return std::make_unique<RenderQueueScene>(); } },
+			{ "shader_variants", [] { return std::make_unique<ShaderVariantsScene>(); } },
+			{ "multi_draw_indirect", [] { return std::make_unique<MultiDrawIndirectScene>(); } },
+			{ "ecs", [] { return std::make_unique<EcsScene>(); } },
+			{ "transforms_flat", [] { return std::make_unique<FlatTransformsScene>(); } },
+			{ "transforms_hierarchy", [] { return std::make_unique<HierarchyTransformsScene>(0.01f); } },
+			{ "transforms_hierarchy_all_dirty", [] { return std::make_unique<HierarchyTransformsScene>(1.f); } },
+			{ "culling_off", [] { return std::make_unique<CullingScene>(CullingScene::Mode::Off); } },
+			{ "culling", [] { return std::make_unique<CullingScene>(CullingScene::Mode::Flat); } },
+			{ "culling_bvh", [] { return std::make_unique<CullingScene>(CullingScene::Mode::Bvh); } },
+			{ "mesh_file", [] { return std::make_unique<MeshFileScene>(); } },
+			{ "mesh_import", [] { return std::make_unique<MeshImportScene>(); } },
+			{ "lod", [] { return std::make_unique<LodScene>(true); } },
+			{ "lod_off", [] { return std::make_unique<LodScene>(false); } },
+			{ "textures", [] { return std::make_unique<TexturesScene>(); } },
+		};
+		return scene_factories;
+	}
+
+	std::unique_ptr<BenchScene> create_scene(const std::string& name) {
+
+		for (const SceneFactory& factory : get_scene_factories()) {
+			if (name == factory.name)
+				return factory.create();
+		}
+		return nullptr;
+	}
+
+	std::vector<std::string> get_scene_names() {
+
+		std::vector<std::string> names;
+		for (const SceneFactory& factory : get_scene_factories()) {
+			names.emplace_back(factory.name);
+		}
+		return names;
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "BenchReport.hpp"
+
+namespace SimpleEngine {
+	class Camera;
+	class RenderQueue;
+}
+
+namespace Bench {
+
+	class BenchScene {
+	public:
+		virtual ~BenchScene() = default;
+
+		//Вызывается один раз, когда контекст OpenGL уже создан
+		virtual bool init(const unsigned int objects_count) = 0;
+		//Можно рисовать сразу или отправить в render_queue - она выполнится после on_render
+		virtual void render(const SimpleEngine::Camera& camera, SimpleEngine::RenderQueue& render_queue) = 0;
+		//Дополнительные счётчики кадра, одинаковые по составу на каждом кадре
+		virtual void get_counters(std::vector<Counter>& /*counters*/) const {}
+
+		//Высота кадра в пикселях, выставляется перед каждым render
+		unsigned int frame_height = 0;
+	};
+
+	std::unique_ptr<BenchScene> create_scene(const std::string& name);
+	std::vector<std::string> get_scene_names();
+
+	//Без GL и окна: время build/refit и пропускная способность запросов Bvh на primitives_count случайных коробках, результат - JSON
+	void run_bvh_benchmark(const unsigned int primitives_count, std::ostream& stream);
+	//Без GL и окна: TransformHierarchy::update и FrustumCuller::cull на JobSystem от 1 до числа ядер потоков
+	void run_jobs_scaling_benchmark(const unsigned int objects_count, std::ostream& stream);
+}
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <SimpleEngineCore/Application.hpp>
+#include "SimpleEngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+
+#include "BenchScenes.hpp"
+#include "BenchReport.hpp"
+
+class SimpleEngineBench : public SimpleEngine::Application {
+public:
+    SimpleEngineBench(std::unique_ptr<Bench::BenchScene> pScene, const unsigned int objects_count, const unsigned int warmup_frames, const unsigned int frames_count)
+        : m_pScene(std::move(pScene))
+        , m_objects_count(objects_count)
+        , m_warmup_frames(warmup_frames)
+        , m_total_frames(warmup_frames + frames_count) {
+
+        camera.set_position_rotation(glm::vec3(-5, 0, 0), glm::vec3(0, 0, 0));
+    }
+
+    virtual void on_render() override {
+
+        if (!m_scene_initialized) {
+            m_scene_initialized = true;
+            m_scene_valid = m_pScene->init(m_objects_count);
+            //Отсчёт первого кадра - отсюда: прошлого on_update ещё не было, а с --warmup 0 он уже измеряется.
+            //Инициализация сцены в него не входит
+            m_last_frame_time = std::chrono::steady_clock::now();
+        }
+        if (m_scene_valid && m_pScene) {
+            m_pScene->frame_height = get_frame_height();
+            m_pScene->render(camera, get_render_queue());
+        }
+    }
+
+    virtual void on_update() override {
+
+        const auto now = std::chrono::steady_clock::now();
+        if (m_frame_index >= m_warmup_frames) {
+
+            const SimpleEngine::Renderer_OpenGL::FrameStatistics& statistics = SimpleEngine::Renderer_OpenGL::get_frame_statistics();
+            Bench::FrameSample sample;
+            sample.cpu_ms = std::chrono::duration<double, std::milli>(now - m_last_frame_time).count();
+            sample.draw_calls = statistics.draw_calls;
+            sample.state_changes = statistics.state_changes;
+            sample.state_changes_elided = statistics.state_changes_elided;
+            //Шаги симуляции идут по реальному времени, поэтому их число за кадр плавает вместе с его длительностью
+            sample.counters.push_back({ "simulation_steps", static_cast<double>(get_fixed_steps_done() - m_fixed_steps_before) });
+            if (m_scene_valid)
+                m_pScene->get_counters(sample.counters);
+            m_samples.push_back(sample);
+        }
+        m_last_frame_time = now;
+        m_fixed_steps_before = get_fixed_steps_done();
+        ++m_frame_index;
+
+        //Последний кадр: GL ресурсы сцены освобождаем, пока контекст ещё жив
+        if (m_frame_index == m_total_frames)
+            m_pScene = nullptr;
+
+        //Пролёт камеры: одинаковый для всех сцен и запусков
+        camera.add_movement_and_rotation(glm::vec3(0.02f, 0.f, 0.f), glm::vec3(0.f, 0.f, 0.1f));
+    }
+
+    bool is_scene_valid() const { return m_scene_valid; }
+    std::vector<Bench::FrameSample>& get_samples() { return m_samples; }
+
+private:
+    std::unique_ptr<Bench::BenchScene> m_pScene;
+    unsigned int m_objects_count;
+    unsigned int m_warmup_frames;
+    unsigned int m_total_frames;
+    unsigned int m_frame_index = 0;
+    unsigned int m_fixed_steps_before = 0;
+    bool m_scene_initialized = false;
+    bool m_scene_valid = false;
+    std::chrono::steady_clock::time_point m_last_frame_time;
+    std::vector<Bench::FrameSample> m_samples;
+};
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> scene_names = Bench::get_scene_names();
+    unsigned int objects_count = 10000;
+    unsigned int frames_count = 300;
+    unsigned int warmup_frames = 10;
+    unsigned int width = 1024;
+    unsigned int height = 768;
+    //Движок пишет лог в stdout, поэтому результаты - только в файл
+    const char* output_path = "bench_results.json";
+    unsigned int bvh_primitives_count = 0;
+    unsigned int jobs_objects_count = 0;
+    const char* shader_cache_directory = "";
+
+    for (int i = 1; i < argc; ++i) {
+
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--scene") == 0 && has_value && std::strcmp(argv[i + 1], "all") != 0) {
+            scene_names = { argv[++i] };
+        }
+        else if (std::strcmp(argv[i], "--scene") == 0 && has_value) {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--objects") == 0 && has_value) {
+            objects_count = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && has_value) {
+            frames_count = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0 && has_value) {
+            warmup_frames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+            output_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--shader-cache") == 0 && has_value) {
+            shader_cache_directory = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--bvh") == 0 && has_value) {
+            bvh_primitives_count = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--jobs-scaling") == 0 && has_value) {
+            jobs_objects_count = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else {
+            std::cerr << "Usage: SimpleEngineBench [--scene <name>|all] [--objects N] [--frames N] [--warmup N] [--output file.json] [--shader-cache dir]\n";
+            std::cerr << "       SimpleEngineBench --bvh N [--output file.json]  (BVH micro-benchmark, no window)\n";
+            std::cerr << "       SimpleEngineBench --jobs-scaling N [--output file.json]  (job system scaling over 1..cores threads, no window)\n";
+            std::cerr << "Scenes:";
+            for (const std::string& name : Bench::get_scene_names())
+                std::cerr << " " << name;
+            std::cerr << "\n";
+            return -1;
+        }
+    }
+
+    if (bvh_primitives_count > 0 || jobs_objects_count > 0) {
+
+        std::ofstream output(output_path);
+        if (!output) {
+            std::cerr << "Can't open " << output_path << "\n";
+            return -1;
+        }
+        if (bvh_primitives_count > 0)
+            Bench::run_bvh_benchmark(bvh_primitives_count, output);
+        else
+            Bench::run_jobs_scaling_benchmark(jobs_objects_count, output);
+        std::cout << "Results written to " << output_path << "\n";
+        return 0;
+    }
+
+    std::vector<Bench::SceneResult> results;
+    for (const std::string& scene_name : scene_names) {
+
+        std::unique_ptr<Bench::BenchScene> pScene = Bench::create_scene(scene_name);
+        if (!pScene) {
+            std::cerr << "Unknown scene: " << scene_name << "\n";
+            return -1;
+        }
+
+        auto pBench = std::make_unique<SimpleEngineBench>(std::move(pScene), objects_count, warmup_frames, frames_count);
+        pBench->shader_cache_directory = shader_cache_directory;
+        const int returnCode = pBench->start_headless(width, height, frames_count + warmup_frames);
+        if (returnCode != 0 || !pBench->is_scene_valid()) {
+            std::cerr << "Scene " << scene_name << " failed\n";
+            return returnCode != 0 ? returnCode : -1;
+        }
+
+        Bench::SceneResult result;
+        result.scene = scene_name;
+        result.objects = objects_count;
+        result.frames = std::move(pBench->get_samples());
+        results.push_back(std::move(result));
+    }
+
+    std::ofstream output(output_path);
+    if (!output) {
+        std::cerr << "Can't open " << output_path << "\n";
+        return -1;
+    }
+    Bench::write_json(output, results);
+    std::cout << "Results written to " << output_path << "\n";
+    return 0;
+}
@@ -1,10 +1,30 @@
 #pragma once
 #include "SimpleEngineCore/Event.hpp"
 #include "SimpleEngineCore/Camera.hpp"
+#include "SimpleEngineCore/Registry.hpp"
+#include "SimpleEngineCore/TransformHierarchy.hpp"
+#include "SimpleEngineCore/Frustum.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+#include <functional>
 #include <memory>
+#include <string>
 
 namespace SimpleEngine {
 
+    class RenderQueue;
+    class RenderCommandList;
+    class RenderThread;
+    class ShaderProgram;
+    class ShaderCompiler;
+    class ShaderLibrary;
+    class TextureManager;
+    class VertexBuffer;
+    class IndexBuffer;
+    class VertexArray;
+    class UniformBuffer;
+    class RingBuffer;
+
     class Application {
     public:
         Application();
@@ -14,21 +34,127 @@ namespace SimpleEngine {
         Application& operator=(Application&&) = delete;
 
         virtual int start(unsigned int window_width, unsigned int window_height, const char* title);
+        //Запуск без дисплея: рисуем frames_count кадров во внеэкранный буфер без swap/vsync
+        virtual int start_headless(unsigned int frame_width, unsigned int frame_height, unsigned int frames_count);
+        //Раз за кадр, после отрисовки
         virtual void on_update() {}
+        //Шаг симуляции: вызывается с постоянным delta_time = fixed_timestep столько раз, сколько шагов набежало с прошлого кадра.
+        //Трансформации и камера, изменённые здесь, рисуются с интерполяцией между двумя последними шагами
+        virtual void on_fixed_update(float /*delta_time*/) {}
+        //Вызывается после отрисовки встроенной сцены, до UI
+        virtual void on_render() {}
         virtual void on_ui_draw() {}
 
         float camera_position[3] = { 0.f, 0.f, 1.f };
         float camera_rotation[3] = { 0.f, 0.f, 0.f };
         bool perspective_camera = true;
 
+        //Секунды на шаг симуляции
+        float fixed_timestep = 1.f / 60.f;
+        //Больше шагов за кадр не делаем, остаток отбрасывается - иначе медленный кадр тормозит и следующий
+        unsigned int max_fixed_steps_per_frame = 5;
+        //0 - рисуем без ограничения, иначе ждём до конца 1 / max_render_fps секунды кадра
+        float max_render_fps = 0.f;
+        //Задаётся до start(): GL контекст уходит отдельному потоку, который рисует кадр N-1, пока пишется кадр N.
+        //on_render() и on_ui_draw() тогда не вызывают GL сами - только очередь и enqueue_render_command(),
+        //а ресурсы из очереди должны жить ещё кадр. FrameStatistics Renderer_OpenGL пишет поток отрисовки
+        bool use_render_thread = false;
+        //Задаётся до start(): каталог кэша бинарников шейдерных программ, пустой - всегда компиляция из исходников
+        std::string shader_cache_directory;
+        //Задаётся до start(): откуда ShaderLibrary читает GLSL, по умолчанию - shaders в исходниках движка.
+        //Файлов движка там нет - используются их копии, вшитые при сборке
+        std::string shader_directory;
+
+        //Выбор уровня детализации для сущностей с LodComponent, перед отсечением каждый кадр
+        LodSettings lod_settings;
+
+        //Используется, если в registry нет сущности с CameraComponent::primary
         Camera camera{ glm::vec3(-5, 0, 0) };
 
+        unsigned int get_frames_rendered() const { return m_frames_rendered; }
+        //Размер кадра в пикселях - окна или внеэкранного буфера в start_headless
+        unsigned int get_frame_width() const;
+        unsigned int get_frame_height() const;
+        unsigned int get_fixed_steps_done() const { return m_fixed_steps_done; }
+        //Доля следующего шага симуляции, прошедшая к текущему кадру, in [0, 1)
+        float get_interpolation_alpha() const { return m_interpolation_alpha; }
+        //Всё, что отправлено в очередь в on_render, сортируется и рисуется после него
+        RenderQueue& get_render_queue();
+        //GL работа кадра в потоке, где контекст: после очистки и заливки камеры, перед очередью
+        void enqueue_render_command(std::function<void()> command);
+        //Сущности с TransformComponent + MeshRendererComponent рисуются каждый кадр сами
+        Registry& get_registry() { return m_registry; }
+        //Узлы для TransformComponent, пересчитывается на каждом шаге симуляции после on_fixed_update
+        TransformHierarchy& get_transform_hierarchy() { return m_transform_hierarchy; }
+        //Сколько сущностей с BoundsComponent проверено и отсечено в последнем кадре
+        const FrustumCuller::Statistics& get_culling_statistics() const { return m_frustum_culler.get_statistics(); }
+        //Треугольники сущностей с LodComponent в последнем кадре - с выбранными уровнями и без LOD'ов
+        const LodStatistics& get_lod_statistics() const { return m_lod_statistics; }
+        //Рабочие потоки для систем кадра; GL вызовы - только из потока с контекстом
+        JobSystem& get_job_system() { return *m_pJobSystem; }
+        //Программы компилируются, пока кадры идут дальше; опрашивается в начале каждого кадра в потоке с контекстом.
+        //С use_render_thread submit и get - только из команд enqueue_render_command, из основного потока submit
+        //отказывает. Живёт, пока идёт run()
+        ShaderCompiler& get_shader_compiler() { return *m_pShaderCompiler; }
+        //Программы из файлов shader_directory с вариантами по #define, общие для всех материалов. Живёт, пока идёт run()
+        ShaderLibrary& get_shader_library() { return *m_pShaderLibrary; }
+        //Текстуры из файлов: декодирование в рабочих потоках, загрузка и бюджет памяти - в начале каждого кадра
+        //в потоке с контекстом. Как и у ShaderCompiler, с use_render_thread load и use - только из команд
+        //enqueue_render_command, из основного потока load отказывает. Живёт, пока идёт run()
+        TextureManager& get_texture_manager() { return *m_pTextureManager; }
+        Camera& get_active_camera();
+
         virtual ~Application();
 
     private:
-        std::unique_ptr<class Window> m_pWindow; //!!!!!!!!!  Window ,   class Window
+        int run(unsigned int frames_count);
+        //Шаги симуляции, набежавшие за delta_seconds, возвращает камеру для отрисовки этого кадра
+        const Camera& run_fixed_steps(const float delta_seconds);
+        //Кадр из списка команд: до on_render (очистка, камера) и после него (команды, очередь, UI)
+        void execute_frame_begin(RenderCommandList& command_list);
+        void execute_frame_end(RenderCommandList& command_list);
+
+        std::unique_ptr<class Window> m_pWindow; //!!!!!!!!! Класс Window неизвестен, поэтому пишем class Window
+
+        std::unique_ptr<JobSystem> m_pJobSystem;
+        //Без потока отрисовки кадр пишется в этот список и выполняется сразу
+        std::unique_ptr<RenderCommandList> m_pCommandList;
+        std::unique_ptr<RenderThread> m_pRenderThread;
+        RenderCommandList* m_pRecordingList = nullptr;
+        Registry m_registry;
+        TransformHierarchy m_transform_hierarchy;
+        FrustumCuller m_frustum_culler;
+        LodStatistics m_lod_statistics;
+
+        //Встроенный квадрат и блок камеры, живут только пока идёт run()
+        std::unique_ptr<ShaderCompiler> m_pShaderCompiler;
+        std::unique_ptr<ShaderLibrary> m_pShaderLibrary;
+        std::unique_ptr<TextureManager> m_pTextureManager;
+        ShaderProgram* m_pShaderProgram = nullptr;
+        std::unique_ptr<VertexBuffer> m_pPositionsColorsVbo;
+        std::unique_ptr<IndexBuffer> m_pIndexBuffer;
+        std::unique_ptr<VertexArray> m_pVao;
+        std::unique_ptr<UniformBuffer> m_pCameraUniformBuffer;
+        std::unique_ptr<RingBuffer> m_pCameraRingBuffer;
+        //Чья камера залита и её update_count. Не указатель: компоненты в пуле переезжают при удалении соседей,
+        //и на старом адресе может оказаться другая камера с тем же счётчиком. null_entity - Application::camera
+        bool m_bCameraUploaded = false;
+        Entity m_uploaded_camera_entity = null_entity;
+        unsigned int m_camera_uniform_buffer_update_count = 0;
+
+        float m_fixed_time_accumulator = 0.f;
+        float m_interpolation_alpha = 0.f;
+        unsigned int m_fixed_steps_done = 0;
+        //Камера до и после последнего шага; если её двигали вне шага - рисуем как есть
+        const Camera* m_pSteppedCamera = nullptr;
+        glm::vec3 m_previous_camera_position{ 0.f };
+        glm::vec3 m_previous_camera_rotation{ 0.f };
+        glm::vec3 m_stepped_camera_position{ 0.f };
+        glm::vec3 m_stepped_camera_rotation{ 0.f };
+        Camera m_interpolated_camera;
 
         EventDispatcher m_event_dispatcher;
         bool m_bCloseWindow = false;
+        unsigned int m_frames_rendered = 0;
     };
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "SimpleEngineCore/Frustum.hpp"
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace SimpleEngine {
+
+	struct Aabb {
+
+		glm::vec3 min{ 0.f };
+		glm::vec3 max{ 0.f };
+	};
+
+	struct Ray {
+
+		glm::vec3 origin{ 0.f };
+		glm::vec3 direction{ 1.f, 0.f, 0.f };//Не обязательно нормирован, distance тогда в его длинах
+		float max_distance = std::numeric_limits<float>::max();
+	};
+
+	struct RayHit {
+
+		uint32_t primitive = ~0u;
+		float distance = 0.f;
+	};
+
+	//BVH по AABB примитивов (примитив - индекс в массиве, переданном в build).
+	//Строится по SAH корзинами, узлы лежат в одном массиве в порядке обхода в глубину:
+	//левый ребёнок сразу за родителем, поэтому refit - один обратный проход без рекурсии
+	class Bvh {
+	public:
+		struct Statistics {
+
+			unsigned int nodes = 0;
+			unsigned int leaves = 0;
+			unsigned int max_depth = 0;
+			//Последний cull()
+			unsigned int nodes_visited = 0;
+			unsigned int primitives_tested = 0;
+		};
+
+		void build(const std::vector<Aabb>& primitive_bounds);
+		//Те же примитивы сдвинулись - пересчитываем границы узлов, топологию не трогаем.
+		//Качество дерева со временем падает, при больших перемещениях лучше build()
+		void refit(const std::vector<Aabb>& primitive_bounds);
+		void clear();
+		size_t get_primitives_count() const { return m_primitive_indexes.size(); }
+
+		//Поддеревья целиком внутри frustum принимаются без проверок, целиком снаружи - отбрасываются
+		void cull(const Frustum& frustum, std::vector<uint32_t>& visible);
+		//Ближайший примитив, чей AABB пересекает луч
+		bool raycast(const Ray& ray, RayHit& hit) const;
+		void query_aabb(const Aabb& bounds, std::vector<uint32_t>& result) const;
+
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		//32 байта, два узла в кэш-линии
+		struct Node {
+
+			glm::vec3 min;
+			uint32_t first_or_right;//Лист - первый примитив в m_primitive_indexes, иначе - индекс правого ребёнка
+			glm::vec3 max;
+			uint32_t count;//0 - внутренний узел
+		};
+
+		//Копия границ с центрами, переставляется на месте при делении - сборка читает память подряд
+		struct BuildPrimitive {
+
+			Aabb bounds;
+			glm::vec3 centroid;
+			uint32_t index;
+		};
+
+		void build_node(const uint32_t node_index, const uint32_t first, const uint32_t count, std::vector<BuildPrimitive>& primitives, const unsigned int depth);
+
+		std::vector<Node> m_nodes;
+		std::vector<uint32_t> m_primitive_indexes;
+		std::vector<Aabb> m_leaf_bounds;//В порядке m_primitive_indexes, чтобы листья читались подряд
+		Statistics m_statistics;
+	};
+}
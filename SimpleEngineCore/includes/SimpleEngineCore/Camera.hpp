@@ -22,6 +22,8 @@ namespace SimpleEngine {
 		void set_projection_mode(const ProjectionMode projection_mode);
 		glm::mat4 get_view_matrix() const { return m_view_matrix; }
 		glm::mat4 get_projection_matrix() const { return m_projection_matrix; }
+		//Растёт при каждом пересчёте матриц - по нему видно, что их пора перезалить на GPU
+		unsigned int get_update_count() const { return m_update_count; }
 
 		void move_forward(const float delta);
 		void move_right(const float delta);
@@ -50,5 +52,6 @@ namespace SimpleEngine {
 
 		glm::mat4 m_view_matrix;
 		glm::mat4 m_projection_matrix;
+		unsigned int m_update_count = 0;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include "SimpleEngineCore/Camera.hpp"
+#include "SimpleEngineCore/TransformHierarchy.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+
+namespace SimpleEngine {
+
+	class ShaderProgram;
+	class VertexArray;
+	struct Material;
+
+	//Сами position/rotation/scale и матрицы лежат в TransformHierarchy, здесь только ссылка на узел
+	struct TransformComponent {
+
+		TransformNode node = invalid_transform_node;
+	};
+
+	//Ресурсы не принадлежат компоненте - ими владеет тот, кто создал сущность
+	struct MeshRendererComponent {
+
+		const ShaderProgram* pShaderProgram = nullptr;
+		const VertexArray* pVertexArray = nullptr;
+		const Material* pMaterial = nullptr;
+		unsigned int pass = 0;
+		//Диапазон индексов VAO; indexes_count == 0 - все. С LodComponent его каждый кадр выставляет select_lods
+		uint32_t first_index = 0;
+		uint32_t indexes_count = 0;
+	};
+
+	//Уровни детализации меша из MeshRendererComponent; для выбора нужен и BoundsComponent
+	struct LodComponent {
+
+		const MeshLod* pLods = nullptr;//Принадлежат мешу, как и VAO
+		unsigned int lods_count = 0;
+		unsigned int current_lod = 0;//Выбранный в прошлом кадре - от него считается гистерезис
+	};
+
+	//Сфера в локальных координатах меша, по ней сущность отсекается по frustum камеры
+	struct BoundsComponent {
+
+		glm::vec3 center{ 0.f };
+		float radius = 0.f;
+	};
+
+	struct CameraComponent {
+
+		Camera camera;
+		bool primary = false;
+	};
+}
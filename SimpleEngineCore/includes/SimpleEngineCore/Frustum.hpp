@@ -0,0 +1,59 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace SimpleEngine {
+
+	class JobSystem;
+
+	//Шесть плоскостей (a, b, c, d) с нормалями внутрь: точка p внутри, если dot(abc, p) + d >= 0 для всех
+	struct Frustum {
+
+		enum Plane { Left = 0, Right, Bottom, Top, Near, Far, PlanesCount };
+
+		glm::vec4 planes[PlanesCount];
+
+		//view_projection = projection * view, глубина OpenGL [-1, 1]
+		static Frustum from_matrix(const glm::mat4& view_projection_matrix);
+
+		bool intersects_sphere(const glm::vec3& center, const float radius) const;
+		bool intersects_aabb(const glm::vec3& min, const glm::vec3& max) const;
+	};
+
+	//Сферы копятся в SoA массивах и проверяются пачками по 4 за SSE инструкцию,
+	//на выходе - плотный список индексов видимых (в порядке add_sphere)
+	class FrustumCuller {
+	public:
+		struct Statistics {
+
+			unsigned int tested = 0;
+			unsigned int culled = 0;
+		};
+
+		void clear();
+		void reserve(const size_t count);
+		void add_sphere(const glm::vec3& center, const float radius);
+		size_t get_spheres_count() const { return m_radii.size(); }
+
+		//С pJobSystem сферы проверяются кусками параллельно, порядок результата тот же
+		const std::vector<uint32_t>& cull(const Frustum& frustum, JobSystem* pJobSystem = nullptr);
+		const std::vector<uint32_t>& get_visible() const { return m_visible; }
+
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		//1 в visible_flags[i - begin] для видимых сфер из [begin, end)
+		void cull_range(const Frustum& frustum, const size_t begin, const size_t end, uint8_t* visible_flags) const;
+
+		std::vector<float> m_centers_x;
+		std::vector<float> m_centers_y;
+		std::vector<float> m_centers_z;
+		std::vector<float> m_radii;
+		std::vector<uint32_t> m_visible;
+		std::vector<uint8_t> m_visible_flags;
+		Statistics m_statistics;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Keys.hpp"
+#include <cstddef>
 
 namespace SimpleEngine {
 
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Счётчик незавершённых задач для fork/join: run() увеличивает, завершение задачи - уменьшает
+	struct JobCounter {
+
+		std::atomic<uint32_t> pending{ 0 };
+	};
+
+	//Пул потоков с очередью на каждый поток: владелец берёт задачи с конца своей очереди,
+	//свободные потоки крадут с начала чужих. Поток, создавший JobSystem (основной, с GL контекстом),
+	//тоже выполняет задачи, пока ждёт в wait(); сами задачи GL трогать не должны
+	class JobSystem {
+	public:
+		//workers_count == 0 - по числу ядер минус основной поток
+		explicit JobSystem(unsigned int workers_count = 0);
+		~JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		//Вместе с основным потоком
+		unsigned int get_threads_count() const { return static_cast<unsigned int>(m_queues.size()); }
+
+		//func() должен жить до wait(counter) - копии не делаются
+		template<typename Func>
+		void run(Func& func, JobCounter& counter) {
+			push({ [](void* pData, uint32_t, uint32_t) { (*static_cast<Func*>(pData))(); }, to_data(func), 0, 0, &counter });
+		}
+
+		//Ждущий поток не простаивает, а выполняет задачи из очередей
+		void wait(JobCounter& counter);
+
+		//func(begin, end) на кусках [0, count) не больше grain элементов, возврат - когда все куски выполнены
+		template<typename Func>
+		void parallel_for(const uint32_t count, const uint32_t grain, Func&& func) {
+
+			if (count == 0)
+				return;
+			if (count <= grain || m_queues.size() == 1) {
+				func(0u, count);
+				return;
+			}
+
+			JobCounter counter;
+			for (uint32_t begin = 0; begin < count; begin += grain) {
+				push({ [](void* pData, const uint32_t begin, const uint32_t end) { (*static_cast<std::remove_reference_t<Func>*>(pData))(begin, end); },
+					   to_data(func), begin, std::min(count, begin + grain), &counter });
+			}
+			wait(counter);
+		}
+
+	private:
+		struct Job {
+
+			void (*function)(void* pData, uint32_t begin, uint32_t end);
+			void* pData;
+			uint32_t begin;
+			uint32_t end;
+			JobCounter* pCounter;
+		};
+
+		struct WorkerQueue {
+
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		template<typename Func>
+		static void* to_data(Func& func) { return const_cast<void*>(static_cast<const void*>(&func)); }
+
+		void push(const Job& job);
+		bool try_execute_one(const unsigned int thread_index);
+		void worker_loop(const unsigned int thread_index);
+		unsigned int get_current_thread_index() const;
+
+		//0 - основной поток, 1.. - рабочие
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_sleep_mutex;
+		std::condition_variable m_wake_condition;
+		std::atomic<uint32_t> m_queued_jobs{ 0 };
+		bool m_bStop = false;
+	};
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace SimpleEngine {
+
+	class Camera;
+
+	//Уровень детализации - диапазон общего IndexBuffer меша, все уровни ссылаются на одни вершины
+	struct MeshLod {
+
+		uint32_t first_index = 0;
+		uint32_t indexes_count = 0;
+		float error = 0.f;//Отклонение от исходной поверхности в долях радиуса ограничивающей сферы меша
+	};
+
+	struct LodSettings {
+
+		bool enabled = true;
+		//Сколько пикселей отклонения от полной модели допустимо на экране
+		float max_pixel_error = 1.f;
+		//На более грубый уровень переходим, только когда его ошибка меньше порога на эту долю, -
+		//иначе объект на границе порога переключался бы каждый кадр
+		float hysteresis = 0.25f;
+	};
+
+	struct LodStatistics {
+
+		size_t objects = 0;
+		size_t triangles = 0;//С выбранными уровнями
+		size_t full_detail_triangles = 0;//Если бы все рисовались с уровнем 0
+	};
+
+	//Пикселей на единицу длины на расстоянии 1 от камеры (для ортографической проекции - на любом расстоянии)
+	float get_lod_pixel_scale(const Camera& camera, const float viewport_height);
+
+	//Проекция радиуса ограничивающей сферы в пикселях; distance - от камеры до центра сферы
+	float get_projected_radius(const Camera& camera, const float pixel_scale, const float radius, const float distance);
+
+	//Самый грубый уровень, ошибка которого на экране не больше max_pixel_error, с гистерезисом относительно current_lod
+	unsigned int select_lod(const MeshLod* pLods, const unsigned int lods_count, const unsigned int current_lod,
+							const float projected_radius, const LodSettings& settings);
+}
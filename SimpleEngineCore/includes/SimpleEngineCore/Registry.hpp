@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Младшие 24 бита - индекс, старшие 8 - поколение: после destroy старый Entity перестаёт быть живым
+	using Entity = uint32_t;
+	constexpr Entity null_entity = ~0u;
+
+	//Последний индекс не выдаётся: с поколением 0xFF он дал бы null_entity
+	constexpr uint32_t max_entities = 0x00FFFFFF;
+
+	constexpr uint32_t entity_index(const Entity entity) { return entity & 0x00FFFFFF; }
+	constexpr uint32_t entity_generation(const Entity entity) { return entity >> 24; }
+
+	class BaseComponentPool {
+	public:
+		virtual ~BaseComponentPool() = default;
+
+		virtual void remove(const Entity entity) = 0;
+
+		bool contains(const Entity entity) const {
+
+			const uint32_t index = entity_index(entity);
+			return index < m_sparse.size() && m_sparse[index] != s_invalid && m_entities[m_sparse[index]] == entity;
+		}
+
+		size_t size() const { return m_entities.size(); }
+		//Плотный массив владельцев: i-я компонента пула принадлежит get_entities()[i]
+		const std::vector<Entity>& get_entities() const { return m_entities; }
+
+	protected:
+		static constexpr uint32_t s_invalid = ~0u;
+
+		std::vector<uint32_t> m_sparse;//Индекс сущности -> позиция в плотных массивах
+		std::vector<Entity> m_entities;
+	};
+
+	//Sparse set: компоненты одного типа лежат подряд без дыр, удаление - перенос последней на место удалённой
+	template<typename T>
+	class ComponentPool : public BaseComponentPool {
+	public:
+		template<typename... Args>
+		T& emplace(const Entity entity, Args&&... args) {
+
+			if (contains(entity)) {
+				T& component = m_components[m_sparse[entity_index(entity)]];
+				component = T{ std::forward<Args>(args)... };
+				return component;
+			}
+
+			const uint32_t index = entity_index(entity);
+			if (index >= m_sparse.size())
+				m_sparse.resize(index + 1, s_invalid);
+
+			m_sparse[index] = static_cast<uint32_t>(m_entities.size());
+			m_entities.push_back(entity);
+			m_components.push_back(T{ std::forward<Args>(args)... });
+			return m_components.back();
+		}
+
+		void remove(const Entity entity) override {
+
+			if (!contains(entity))
+				return;
+
+			const uint32_t position = m_sparse[entity_index(entity)];
+			const Entity last_entity = m_entities.back();
+			m_entities[position] = last_entity;
+			m_components[position] = std::move(m_components.back());
+			m_sparse[entity_index(last_entity)] = position;
+			m_sparse[entity_index(entity)] = s_invalid;
+			m_entities.pop_back();
+			m_components.pop_back();
+		}
+
+		T& get(const Entity entity) { return m_components[m_sparse[entity_index(entity)]]; }
+		const T& get(const Entity entity) const { return m_components[m_sparse[entity_index(entity)]]; }
+		T* try_get(const Entity entity) { return contains(entity) ? &get(entity) : nullptr; }
+
+		void reserve(const size_t count) {
+
+			m_entities.reserve(count);
+			m_components.reserve(count);
+		}
+
+		std::vector<T>& get_components() { return m_components; }
+		const std::vector<T>& get_components() const { return m_components; }
+
+	private:
+		std::vector<T> m_components;
+	};
+
+	inline size_t next_component_type_id() {
+
+		static size_t next_id = 0;
+		return next_id++;
+	}
+
+	template<typename T>
+	size_t component_type_id() {
+
+		static const size_t id = next_component_type_id();
+		return id;
+	}
+
+	class Registry {
+	public:
+		Registry() = default;
+		Registry(const Registry&) = delete;
+		Registry& operator=(const Registry&) = delete;
+
+		//null_entity, если все max_entities индексов заняты
+		Entity create();
+		void destroy(const Entity entity);
+		bool is_alive(const Entity entity) const;
+		size_t get_alive_count() const { return m_entities.size() - m_free_indexes.size(); }
+		void clear();
+
+		template<typename T, typename... Args>
+		T& emplace(const Entity entity, Args&&... args) {
+			return get_pool<T>().emplace(entity, std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		void remove(const Entity entity) { get_pool<T>().remove(entity); }
+
+		template<typename T>
+		bool has(const Entity entity) const {
+
+			const ComponentPool<T>* pPool = find_pool<T>();
+			return pPool && pPool->contains(entity);
+		}
+
+		template<typename T>
+		T& get(const Entity entity) { return get_pool<T>().get(entity); }
+
+		template<typename T>
+		T* try_get(const Entity entity) { return get_pool<T>().try_get(entity); }
+
+		template<typename T>
+		void reserve(const size_t count) { get_pool<T>().reserve(count); }
+
+		template<typename T>
+		ComponentPool<T>& get_pool() {
+
+			const size_t type_id = component_type_id<T>();
+			if (type_id >= m_pools.size())
+				m_pools.resize(type_id + 1);
+			if (!m_pools[type_id])
+				m_pools[type_id] = std::make_unique<ComponentPool<T>>();
+			return static_cast<ComponentPool<T>&>(*m_pools[type_id]);
+		}
+
+		//Линейный проход по плотному массиву T; остальные компоненты достаются через sparse индекс.
+		//Первым ставить самый редкий тип. func(Entity, T&, Others&...)
+		template<typename T, typename... Others, typename Func>
+		void each(Func&& func) {
+			each_in_pools(func, get_pool<T>(), get_pool<Others>()...);
+		}
+
+	private:
+		template<typename Func, typename T, typename... Others>
+		static void each_in_pools(Func& func, ComponentPool<T>& pool, ComponentPool<Others>&... other_pools) {
+
+			const std::vector<Entity>& entities = pool.get_entities();
+			std::vector<T>& components = pool.get_components();
+			for (size_t i = 0; i < entities.size(); ++i) {
+
+				const Entity entity = entities[i];
+				if ((other_pools.contains(entity) && ...))
+					func(entity, components[i], other_pools.get(entity)...);
+			}
+		}
+
+		template<typename T>
+		const ComponentPool<T>* find_pool() const {
+
+			const size_t type_id = component_type_id<T>();
+			return type_id < m_pools.size() ? static_cast<const ComponentPool<T>*>(m_pools[type_id].get()) : nullptr;
+		}
+
+		std::vector<std::unique_ptr<BaseComponentPool>> m_pools;
+		std::vector<Entity> m_entities;//По индексу - текущий Entity этого слота (с поколением)
+		std::vector<uint32_t> m_free_indexes;
+	};
+}
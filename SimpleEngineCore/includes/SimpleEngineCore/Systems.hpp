@@ -0,0 +1,41 @@
+#pragma once
+#include "SimpleEngineCore/Registry.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+#include <vector>
+
+namespace SimpleEngine {
+
+	class RenderQueue;
+	class Camera;
+	class TransformHierarchy;
+	class FrustumCuller;
+	class Bvh;
+	class JobSystem;
+	struct Frustum;
+	struct Aabb;
+
+	//Системы проходят по плотным массивам компонент Registry подряд, без аллокаций на сущность
+
+	//Все сущности с TransformComponent + MeshRendererComponent отправляются в очередь,
+	//матрицы берутся из transform_hierarchy.get_render_matrix() - update() (и interpolate()) для неё уже должны быть сделаны
+	void submit_mesh_renderers(Registry& registry, const TransformHierarchy& transform_hierarchy, RenderQueue& render_queue);
+	//То же, но сущности с BoundsComponent сначала проверяются по frustum пачкой через frustum_culler
+	//и в очередь уходят только видимые; без BoundsComponent сущность отправляется всегда.
+	//С pJobSystem сама проверка сфер идёт параллельно, отправка в очередь - в вызывающем потоке
+	void submit_visible_mesh_renderers(Registry& registry, const TransformHierarchy& transform_hierarchy, const Frustum& frustum,
+									   FrustumCuller& frustum_culler, RenderQueue& render_queue, JobSystem* pJobSystem = nullptr);
+	//Мировые AABB всех сущностей с TransformComponent + BoundsComponent: bounds[i] принадлежит entities[i].
+	//Порядок стабилен, пока сущности не добавляются и не удаляются, поэтому годится и для Bvh::refit
+	void gather_world_bounds(Registry& registry, const TransformHierarchy& transform_hierarchy, std::vector<Entity>& entities, std::vector<Aabb>& bounds);
+	//Иерархическое отсечение: bvh построен по gather_world_bounds, bvh_entities - его entities.
+	//Сущности без BoundsComponent в bvh не попадают и, как и без bvh, отправляются всегда
+	void submit_visible_mesh_renderers(Registry& registry, const TransformHierarchy& transform_hierarchy, const Frustum& frustum,
+									   Bvh& bvh, const std::vector<Entity>& bvh_entities, std::vector<uint32_t>& visible, RenderQueue& render_queue);
+	//Уровень детализации сущностей с LodComponent + MeshRendererComponent + TransformComponent + BoundsComponent
+	//по размеру ограничивающей сферы на экране; выбранный диапазон индексов записывается в MeshRendererComponent.
+	//Вызывать до submit_*: отсечение тут не делается, поэтому статистика - по всем таким сущностям
+	LodStatistics select_lods(Registry& registry, const TransformHierarchy& transform_hierarchy, const Camera& camera,
+							  const float viewport_height, const LodSettings& settings);
+	//Камера первой сущности с CameraComponent::primary, nullptr если такой нет. В pEntity - эта сущность или null_entity
+	Camera* find_primary_camera(Registry& registry, Entity* pEntity = nullptr);
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <glm/vec3.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Постоянный идентификатор узла: позиция узла в массивах меняется при сортировке и удалении
+	using TransformNode = uint32_t;
+	constexpr TransformNode invalid_transform_node = ~0u;
+
+	class JobSystem;
+
+	//Иерархия трансформаций в SoA массивах, отсортированных по уровням (сначала корни, потом их дети и т.д.),
+	//поэтому родитель всегда стоит раньше детей и update() - один линейный проход.
+	//Матрицы пересчитываются только у изменённых узлов и их поддеревьев.
+	class TransformHierarchy {
+	public:
+		struct Statistics {
+
+			unsigned int nodes = 0;
+			unsigned int local_matrices_recomputed = 0;
+			unsigned int world_matrices_recomputed = 0;
+		};
+
+		TransformNode create(const TransformNode parent = invalid_transform_node);
+		//Удаляет узел вместе со всем поддеревом
+		void destroy(const TransformNode node);
+		bool is_valid(const TransformNode node) const;
+		void reserve(const size_t count);
+		void clear();
+
+		void set_position(const TransformNode node, const glm::vec3& position);
+		//Градусы, x - Roll, y - Pitch, z - Yaw, как у Camera
+		void set_rotation(const TransformNode node, const glm::vec3& rotation);
+		void set_scale(const TransformNode node, const glm::vec3& scale);
+		void set_local(const TransformNode node, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+
+		const glm::vec3& get_position(const TransformNode node) const { return m_positions[m_node_to_index[node]]; }
+		const glm::vec3& get_rotation(const TransformNode node) const { return m_rotations[m_node_to_index[node]]; }
+		const glm::vec3& get_scale(const TransformNode node) const { return m_scales[m_node_to_index[node]]; }
+		TransformNode get_parent(const TransformNode node) const;
+		//Актуальна после update()
+		const glm::mat4& get_world_matrix(const TransformNode node) const { return m_world_matrices[m_node_to_index[node]]; }
+		//Между двумя последними update() по alpha из interpolate(); без interpolate() - та же get_world_matrix()
+		const glm::mat4& get_render_matrix(const TransformNode node) const {
+
+			const uint32_t index = m_node_to_index[node];
+			return m_bInterpolated && (m_flags[index] & WorldChanged) ? m_render_matrices[index] : m_world_matrices[index];
+		}
+
+		//С pJobSystem узлы одного уровня пересчитываются параллельно, уровни - по очереди
+		void update(JobSystem* pJobSystem = nullptr);
+		//Для шага симуляции с фиксированным dt: alpha in [0, 1] - доля следующего шага, уже прошедшая к моменту кадра.
+		//Трогает только узлы, изменённые последним update(), остальные и так стоят на месте
+		void interpolate(const float alpha);
+
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		enum Flags : uint8_t {
+
+			LocalDirty = 1 << 0,
+			WorldChanged = 1 << 1,
+			Created = 1 << 2//Предыдущей мировой матрицы ещё нет - не интерполируем из единичной
+		};
+
+		static constexpr uint32_t s_no_parent = ~0u;
+
+		void sort_breadth_first();
+		void update_range(const size_t begin, const size_t end, Statistics& statistics);
+		void remove_marked(const std::vector<uint8_t>& removed);
+
+		//Все массивы индексируются позицией узла
+		std::vector<glm::vec3> m_positions;
+		std::vector<glm::vec3> m_rotations;
+		std::vector<glm::vec3> m_scales;
+		std::vector<glm::mat4> m_local_matrices;
+		std::vector<glm::mat4> m_world_matrices;
+		std::vector<glm::mat4> m_previous_world_matrices;//До последнего update(), значимы только при WorldChanged
+		std::vector<glm::mat4> m_render_matrices;
+		std::vector<uint32_t> m_parents;//Позиция родителя или s_no_parent
+		std::vector<uint32_t> m_depths;
+		std::vector<uint8_t> m_flags;
+		std::vector<TransformNode> m_index_to_node;
+
+		std::vector<uint32_t> m_node_to_index;//invalid_transform_node - узел свободен
+		std::vector<TransformNode> m_free_nodes;
+		bool m_bOrderDirty = false;
+		bool m_bInterpolated = false;
+
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,6 @@
+layout(std140) uniform CameraData {
+    mat4 view_matrix;
+    mat4 projection_matrix;
+    mat4 view_projection_matrix;
+    vec4 camera_position;
+};
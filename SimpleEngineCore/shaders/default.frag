@@ -0,0 +1,7 @@
+#version 460
+in vec3 color;
+uniform vec4 material_color;
+out vec4 frag_color;
+void main() {
+    frag_color = vec4(color, 1.0) * material_color;
+}
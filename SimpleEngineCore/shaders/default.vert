@@ -0,0 +1,24 @@
+#version 460
+#include "camera_data.glsl"
+layout(location = 0) in vec3 vertex_position;
+#ifdef VERTEX_COLOR
+layout(location = 1) in vec3 vertex_color;
+#endif
+#ifdef INSTANCING
+layout(location = 2) in mat4 instance_model_matrix;
+#else
+uniform mat4 model_matrix;
+#endif
+out vec3 color;
+void main() {
+#ifdef VERTEX_COLOR
+    color = vertex_color;
+#else
+    color = vec3(1.0);
+#endif
+#ifdef INSTANCING
+    gl_Position = view_projection_matrix * instance_model_matrix * vec4(vertex_position, 1.0);
+#else
+    gl_Position = view_projection_matrix * model_matrix * vec4(vertex_position, 1.0);
+#endif
+}
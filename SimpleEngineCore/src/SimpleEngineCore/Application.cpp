@@ -4,16 +4,31 @@
 #include "SimpleEngineCore/Input.hpp"
 
 #include "SimpleEngineCore/Rendering/OpenGL/ShaderProgram.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ProgramBinaryCache.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ShaderCompiler.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/ShaderLibrary.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/EmbeddedShaders.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/TextureManager.hpp"
 #include "SimpleEngineCore/Rendering/OpenGL/VertexBuffer.hpp"
 #include "SimpleEngineCore/Rendering/OpenGL/VertexArray.hpp"
 #include "SimpleEngineCore/Rendering/OpenGL/IndexBuffer.hpp"
 #include "SimpleEngineCore/Camera.hpp"
 #include "SimpleEngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/UniformBuffer.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/RingBuffer.hpp"
+#include "SimpleEngineCore/Components.hpp"
+#include "SimpleEngineCore/Systems.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/RenderQueue.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/RenderCommandList.hpp"
+#include "SimpleEngineCore/RenderThread.hpp"
 
 #include <glm/mat3x3.hpp>
 #include <glm/trigonometric.hpp>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <chrono>
+#include <cmath>
+#include <thread>
 
 
 #include <imgui/imgui.h>
@@ -34,47 +49,36 @@ namespace SimpleEngine {
         0, 1, 2, 3, 2, 1
     };
 
-    const char* vertex_shader =
-        R"(#version 460
-        layout(location = 0) in vec3 vertex_position;
-        layout(location = 1) in vec3 vertex_color;
-        #      
-        uniform mat4 model_matrix;
-        #  
-        uniform mat4 view_projection_matrix;
-        out vec3 color;
-        void main() {
-            color = vertex_color;
-            gl_Position = view_projection_matrix * model_matrix * vec4(vertex_position, 1.0);
-        })";
-
-    const char* fragment_shader =
-        R"(#version 460
-        in vec3 color;
-        out vec4 frag_color;
-        void main() {
-            frag_color = vec4(color, 1.0);
-        })";
-
-    std::unique_ptr<ShaderProgram> p_shader_program;
-    std::unique_ptr<VertexBuffer> p_positions_colors_vbo;
-    std::unique_ptr<IndexBuffer> p_index_buffer;
-    std::unique_ptr<VertexArray> p_vao;
-
-    float scale[3] = { 1.f, 1.f, 1.f };
-    float rotate = 0.f;
-    float translate[3] = { 0.f, 0.f, 0.f };
     float m_background_color[4] = { 0.33f, 0.33f, 0.66f, 0 };
+    const Material default_material;
 
 
-    Application::Application() {
+    Application::Application()
+        : m_pJobSystem(std::make_unique<JobSystem>())
+        , m_pCommandList(std::make_unique<RenderCommandList>())
+        , m_pRecordingList(m_pCommandList.get()) {
 
+        shader_directory = SIMPLE_ENGINE_SHADERS_DIR;
         std::cout << "Starting Application!\n";
     }
 
     int Application::start(unsigned int window_width, unsigned int window_height, const char* title) {
 
         m_pWindow = std::make_unique<Window>(title, window_width, window_height);
+        if (!m_pWindow->is_valid())
+            return -1;
+        return run(0);
+    }
+
+    int Application::start_headless(unsigned int frame_width, unsigned int frame_height, unsigned int frames_count) {
+
+        m_pWindow = std::make_unique<Window>("headless", frame_width, frame_height, Window::EMode::Headless);
+        if (!m_pWindow->is_valid())
+            return -1;
+        return run(frames_count);
+    }
+
+    int Application::run(unsigned int frames_count) {
 
         m_event_dispatcher.add_event_listener<EventMouseMoved>(
             [](EventMouseMoved& event) {
@@ -117,9 +121,18 @@ namespace SimpleEngine {
             }
         );
 
+        //До первой программы: ключи кэша включают строки драйвера, а они есть только с контекстом
+        ProgramBinaryCache::open(shader_cache_directory);
+        m_pShaderCompiler = std::make_unique<ShaderCompiler>();
+        m_pShaderLibrary = std::make_unique<ShaderLibrary>(shader_directory);
+        //Без исходников рядом (установленный бинарник) шейдеры движка берутся из вшитых копий
+        for (size_t i = 0; i < embedded_shaders_count; ++i)
+            m_pShaderLibrary->add_fallback_source(embedded_shaders[i].name, embedded_shaders[i].source);
+        m_pTextureManager = std::make_unique<TextureManager>(m_pJobSystem.get());
+
         //****************************************************//
-        p_shader_program = std::make_unique<ShaderProgram>(vertex_shader, fragment_shader);
-        if (!p_shader_program->isCompiled())
+        m_pShaderProgram = m_pShaderLibrary->get_program("default.vert", "default.frag", { "VERTEX_COLOR" });
+        if (!m_pShaderProgram)
             return false;
 
         BufferLayout buffer_layout_1vec3{
@@ -133,64 +146,105 @@ namespace SimpleEngine {
             ShaderDataType::Float3
         };
 
-        p_vao = std::make_unique<VertexArray>();
-        p_positions_colors_vbo = std::make_unique<VertexBuffer>(positions_colors2, sizeof(positions_colors2), buffer_layout_2vec3);
-        p_index_buffer = std::make_unique<IndexBuffer>(indexes, sizeof(indexes) / sizeof(GLuint));
+        m_pVao = std::make_unique<VertexArray>();
+        m_pPositionsColorsVbo = std::make_unique<VertexBuffer>(positions_colors2, sizeof(positions_colors2), buffer_layout_2vec3);
+        m_pIndexBuffer = std::make_unique<IndexBuffer>(indexes, sizeof(indexes) / sizeof(GLuint));
 
-        p_vao->add_vertex_buffer(*p_positions_colors_vbo);
-        p_vao->set_index_buffer(*p_index_buffer);
-        //****************************************************//
+        m_pVao->add_vertex_buffer(*m_pPositionsColorsVbo);
+        m_pVao->set_index_buffer(*m_pIndexBuffer);
 
+        const Entity quad_entity = m_registry.create();
+        m_registry.emplace<TransformComponent>(quad_entity, m_transform_hierarchy.create());
+        m_registry.emplace<MeshRendererComponent>(quad_entity, m_pShaderProgram, m_pVao.get(), &default_material);
+        m_registry.emplace<BoundsComponent>(quad_entity, glm::vec3(0.f), 0.7072f);
 
-        while (!m_bCloseWindow) {
+        //Новые данные камеры пишутся в следующий кусок кольца, а не поверх того, что ещё читает GPU
+        const size_t camera_data_stride = (sizeof(CameraData) + UniformBuffer::get_offset_alignment() - 1) / UniformBuffer::get_offset_alignment() * UniformBuffer::get_offset_alignment();
+        m_pCameraUniformBuffer = std::make_unique<UniformBuffer>(camera_data_stride * 3, UniformBlockBinding::Camera, true);
+        m_pCameraRingBuffer = std::make_unique<RingBuffer>(*m_pCameraUniformBuffer, 3);
+        m_bCameraUploaded = false;
+        //****************************************************//
 
-            Renderer_OpenGL::set_clear_color(m_background_color[0], m_background_color[1], m_background_color[2], m_background_color[3]);
-            Renderer_OpenGL::clear();
+        if (use_render_thread) {
 
-            p_shader_program->bind();
+            //Шейдеры и шрифт ImGui бэкенд создаёт в первом NewFrame - пока контекст ещё у этого потока
+            ImGui_ImplOpenGL3_NewFrame();
+            m_pRenderThread = std::make_unique<RenderThread>(*m_pWindow,
+                [this](RenderCommandList& command_list) {
+                    execute_frame_begin(command_list);
+                    execute_frame_end(command_list);
+                });
+        }
 
-            glm::mat4 scale_matrix(scale[0], 0, 0, 0,
-                0, scale[1], 0, 0,
-                0, 0, scale[2], 0,
-                0, 0, 0, 1);
 
-            float rotate_in_radians = glm::radians(rotate);
-            glm::mat4 rotate_matrix(cos(rotate_in_radians), sin(rotate_in_radians), 0, 0,
-                -sin(rotate_in_radians), cos(rotate_in_radians), 0, 0,
-                0, 0, 1, 0,
-                0, 0, 0, 1);
+        m_frames_rendered = 0;
+        m_fixed_steps_done = 0;
+        //Первый кадр сразу делает один шаг - иначе он нарисовал бы ещё не пересчитанные трансформации
+        m_fixed_time_accumulator = fixed_timestep;
+        m_pSteppedCamera = nullptr;
+        const auto loop_start_time = std::chrono::steady_clock::now();
+        auto last_frame_time = loop_start_time;
 
-            glm::mat4 translate_matrix(1, 0, 0, 0,
-                0, 1, 0, 0,
-                0, 0, 1, 0,
-                translate[0], translate[1], translate[2], 1);
+        //frames_count == 0 - крутимся, пока окно не закроют
+        while (!m_bCloseWindow && (frames_count == 0 || m_frames_rendered < frames_count)) {
 
-            //p_shader_program->setMatrix4("scale_matrix", scale_matrix);
-            //p_shader_program->setMatrix4("rotate_matrix", rotate_matrix);
-            //p_shader_program->setMatrix4("translate_matrix", translate_matrix);
+            const auto frame_start_time = std::chrono::steady_clock::now();
+            const Camera& render_camera = run_fixed_steps(std::chrono::duration<float>(frame_start_time - last_frame_time).count());
+            last_frame_time = frame_start_time;
 
-            glm::mat4 model_matrix = translate_matrix * rotate_matrix * scale_matrix;
-            p_shader_program->setMatrix4("model_matrix", model_matrix);
+            //Без потока отрисовки кадр пишется в единственный список и тут же выполняется
+            m_pRecordingList = m_pRenderThread ? &m_pRenderThread->get_recording_list() : m_pCommandList.get();
+            RenderCommandList& command_list = *m_pRecordingList;
+            command_list.begin(render_camera.get_view_matrix());
+            command_list.set_clear_color(glm::vec4(m_background_color[0], m_background_color[1], m_background_color[2], m_background_color[3]));
+            unsigned int viewport_width = 0;
+            unsigned int viewport_height = 0;
+            if (m_pWindow->take_pending_viewport(viewport_width, viewport_height))
+                command_list.set_viewport(viewport_width, viewport_height);
 
             //camera.set_position_rotation(glm::vec3(camera_position[0], camera_position[1], camera_position[2]), glm::vec3(camera_rotation[0], camera_rotation[1], camera_rotation[2]));
-            camera.set_projection_mode(perspective_camera ? Camera::ProjectionMode::Perspective : Camera::ProjectionMode::Orthographic);
-            p_shader_program->setMatrix4("view_projection_matrix", camera.get_projection_matrix() * camera.get_view_matrix());
+            //Камеру заливаем один раз за кадр и только если её матрицы поменялись.
+            //Интерполированная камера - всегда один объект, её update_count может совпасть с прошлым кадром
+            Entity camera_entity = null_entity;
+            find_primary_camera(m_registry, &camera_entity);
+            if (&render_camera == &m_interpolated_camera || !m_bCameraUploaded || camera_entity != m_uploaded_camera_entity
+                || render_camera.get_update_count() != m_camera_uniform_buffer_update_count) {
+
+                CameraData camera_data;
+                camera_data.view_matrix = render_camera.get_view_matrix();
+                camera_data.projection_matrix = render_camera.get_projection_matrix();
+                camera_data.view_projection_matrix = camera_data.projection_matrix * camera_data.view_matrix;
+                camera_data.camera_position = glm::vec4(render_camera.get_camera_position(), 1.f);
+                command_list.set_camera_data(camera_data);
+                m_camera_uniform_buffer_update_count = render_camera.get_update_count();
+                m_uploaded_camera_entity = camera_entity;
+                m_bCameraUploaded = true;
+            }
+
+            //on_render() может рисовать напрямую - очистка и камера должны быть до него
+            if (!m_pRenderThread)
+                execute_frame_begin(command_list);
 
-            Renderer_OpenGL::draw(*p_vao);
+            m_lod_statistics = select_lods(m_registry, m_transform_hierarchy, render_camera, static_cast<float>(get_frame_height()), lod_settings);
+            const Frustum frustum = Frustum::from_matrix(render_camera.get_projection_matrix() * render_camera.get_view_matrix());
+            submit_visible_mesh_renderers(m_registry, m_transform_hierarchy, frustum, m_frustum_culler, command_list.get_render_queue(), m_pJobSystem.get());
+
+            on_render();
 
             //****************************************************//
             ImGuiIO& io = ImGui::GetIO();
             //io.DisplaySize.x = static_cast<float>(get_width());
             //io.DisplaySize.y = static_cast<float>(get_height());
-            ImGui_ImplOpenGL3_NewFrame();
+            if (!m_pRenderThread)
+                ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplGlfw_NewFrame();
             ImGui::NewFrame();
             //ImGui::ShowDemoWindow();
             //ImGui::Begin("Background Color Window");
             //ImGui::ColorEdit4("Background Color", m_background_color);
-            //ImGui::SliderFloat3("scale", scale, 0.f, 2.f);
-            //ImGui::SliderFloat("rotate", &rotate, 0.f, 360.f);
-            //ImGui::SliderFloat3("translate", translate, -1.f, 1.f);
+            //ImGui::SliderFloat3("scale", &quad_transform.scale.x, 0.f, 2.f);
+            //ImGui::SliderFloat("rotate", &quad_transform.rotation.z, 0.f, 360.f);
+            //ImGui::SliderFloat3("translate", &quad_transform.position.x, -1.f, 1.f);
             //ImGui::SliderFloat3("camera position", camera_position, -10.f, 10.f);
             //ImGui::SliderFloat3("camera rotation", camera_rotation, 0, 360.f);
             //ImGui::Checkbox("Perspective camera", &perspective_camera);
@@ -200,17 +254,170 @@ namespace SimpleEngine {
             on_ui_draw();
 
             ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-            
+            //Поток отрисовки возьмёт кадр, когда здесь уже пойдёт следующий NewFrame - нужна копия
+            command_list.set_ui_draw_data(ImGui::GetDrawData(), m_pRenderThread != nullptr);
 
-            m_pWindow->on_update();
+            if (m_pRenderThread) {
+                m_pRenderThread->submit();
+            }
+            else {
+                execute_frame_end(command_list);
+                m_pWindow->swap_buffers();
+            }
+
+            m_pWindow->poll_events();
             on_update();
+            ++m_frames_rendered;
+
+            if (max_render_fps > 0.f)
+                std::this_thread::sleep_until(frame_start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.f / max_render_fps)));
+        }
+
+        //Дорисовываем последний кадр и забираем контекст обратно
+        const double render_thread_wait_ms = m_pRenderThread ? m_pRenderThread->get_statistics().main_wait_ms : 0.0;
+        m_pRenderThread = nullptr;
+        m_pRecordingList = m_pCommandList.get();
+        m_pCommandList->begin(glm::mat4(1.f));
+
+        //GL объекты удаляем, пока жив контекст окна
+        //Компоненты ссылаются на ресурсы выше - сцену чистим вместе с ними
+        m_registry.clear();
+        m_transform_hierarchy.clear();
+        m_pCameraRingBuffer = nullptr;
+        m_pCameraUniformBuffer = nullptr;
+        m_pVao = nullptr;
+        m_pIndexBuffer = nullptr;
+        m_pPositionsColorsVbo = nullptr;
+        m_pShaderProgram = nullptr;
+        m_pTextureManager = nullptr;
+        m_pShaderLibrary = nullptr;
+        m_pShaderCompiler = nullptr;
+
+        if (m_pWindow->is_headless()) {
+
+            const std::chrono::duration<double, std::milli> loop_time = std::chrono::steady_clock::now() - loop_start_time;
+            std::cout << "Headless: " << m_frames_rendered << " frames in " << loop_time.count() << " ms ("
+                      << (loop_time.count() > 0 ? m_frames_rendered * 1000.0 / loop_time.count() : 0.0) << " fps), "
+                      << m_fixed_steps_done << " simulation steps ("
+                      << (loop_time.count() > 0 ? m_fixed_steps_done * 1000.0 / loop_time.count() : 0.0) << " per second)\n";
+            if (use_render_thread)
+                std::cout << "Render thread: main thread waited " << render_thread_wait_ms << " ms for the previous frame\n";
         }
         m_pWindow = nullptr;
 
         return 0;
     }
 
+    void Application::execute_frame_begin(RenderCommandList& command_list) {
+
+        Renderer_OpenGL::reset_frame_statistics();
+        //Здесь контекст есть в обоих режимах: без потока отрисовки это основной поток перед on_render(),
+        //с ним - поток отрисовки перед командами кадра
+        m_pShaderCompiler->poll();
+        m_pTextureManager->update();
+
+        unsigned int viewport_width = 0;
+        unsigned int viewport_height = 0;
+        if (command_list.get_viewport(viewport_width, viewport_height))
+            Renderer_OpenGL::set_viewport(viewport_width, viewport_height);
+
+        const glm::vec4& clear_color = command_list.get_clear_color();
+        Renderer_OpenGL::set_clear_color(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
+        Renderer_OpenGL::clear();
+
+        if (const CameraData* pCameraData = command_list.get_camera_data()) {
+
+            const size_t camera_data_offset = m_pCameraRingBuffer->write(pCameraData, sizeof(CameraData), UniformBuffer::get_offset_alignment());
+            m_pCameraUniformBuffer->bind_range(camera_data_offset, sizeof(CameraData));
+        }
+    }
+
+    void Application::execute_frame_end(RenderCommandList& command_list) {
+
+        command_list.execute_commands();
+        command_list.get_render_queue().execute();
+        m_pCameraRingBuffer->end_frame();
+
+        command_list.execute_ui();
+        //ImGui меняет GL состояние в обход кэша Renderer_OpenGL
+        Renderer_OpenGL::invalidate_state_cache();
+    }
+
+    unsigned int Application::get_frame_width() const {
+
+        return m_pWindow ? m_pWindow->get_framebuffer_width() : 0;
+    }
+
+    unsigned int Application::get_frame_height() const {
+
+        return m_pWindow ? m_pWindow->get_framebuffer_height() : 0;
+    }
+
+    RenderQueue& Application::get_render_queue() {
+
+        return m_pRecordingList->get_render_queue();
+    }
+
+    void Application::enqueue_render_command(std::function<void()> command) {
+
+        m_pRecordingList->add_command(std::move(command));
+    }
+
+    //Угол в градусах по кратчайшему пути, чтобы 359 -> 1 не крутилось через 180
+    static float lerp_angle(const float from, const float to, const float alpha) {
+
+        const float delta = std::fmod(std::fmod(to - from, 360.f) + 540.f, 360.f) - 180.f;
+        return from + delta * alpha;
+    }
+
+    const Camera& Application::run_fixed_steps(const float delta_seconds) {
+
+        m_fixed_time_accumulator += delta_seconds;
+        unsigned int steps_count = 0;
+        while (m_fixed_time_accumulator >= fixed_timestep && steps_count < max_fixed_steps_per_frame) {
+
+            const Camera& stepped_camera = get_active_camera();
+            m_pSteppedCamera = &stepped_camera;
+            m_previous_camera_position = stepped_camera.get_camera_position();
+            m_previous_camera_rotation = stepped_camera.get_camera_rotation();
+
+            on_fixed_update(fixed_timestep);
+            m_transform_hierarchy.update(m_pJobSystem.get());
+
+            m_stepped_camera_position = stepped_camera.get_camera_position();
+            m_stepped_camera_rotation = stepped_camera.get_camera_rotation();
+            m_fixed_time_accumulator -= fixed_timestep;
+            ++steps_count;
+            ++m_fixed_steps_done;
+        }
+        //Не успеваем - теряем время симуляции, но сохраняем фазу шага
+        if (m_fixed_time_accumulator >= fixed_timestep)
+            m_fixed_time_accumulator = std::fmod(m_fixed_time_accumulator, fixed_timestep);
+
+        m_interpolation_alpha = m_fixed_time_accumulator / fixed_timestep;
+        m_transform_hierarchy.interpolate(m_interpolation_alpha);
+
+        Camera& active_camera = get_active_camera();
+        active_camera.set_projection_mode(perspective_camera ? Camera::ProjectionMode::Perspective : Camera::ProjectionMode::Orthographic);
+        const bool moved_by_step = m_previous_camera_position != m_stepped_camera_position || m_previous_camera_rotation != m_stepped_camera_rotation;
+        const bool moved_outside_step = active_camera.get_camera_position() != m_stepped_camera_position || active_camera.get_camera_rotation() != m_stepped_camera_rotation;
+        if (&active_camera != m_pSteppedCamera || !moved_by_step || moved_outside_step)
+            return active_camera;
+
+        const glm::vec3 rotation(lerp_angle(m_previous_camera_rotation.x, m_stepped_camera_rotation.x, m_interpolation_alpha),
+                                 lerp_angle(m_previous_camera_rotation.y, m_stepped_camera_rotation.y, m_interpolation_alpha),
+                                 lerp_angle(m_previous_camera_rotation.z, m_stepped_camera_rotation.z, m_interpolation_alpha));
+        m_interpolated_camera = active_camera;
+        m_interpolated_camera.set_position_rotation(m_previous_camera_position + (m_stepped_camera_position - m_previous_camera_position) * m_interpolation_alpha, rotation);
+        return m_interpolated_camera;
+    }
+
+    Camera& Application::get_active_camera() {
+
+        Camera* pPrimaryCamera = find_primary_camera(m_registry);
+        return pPrimaryCamera ? *pPrimaryCamera : camera;
+    }
+
     Application::~Application() {
 
         std::cout << "Closing Application!\n";
@@ -0,0 +1,384 @@
+#include "SimpleEngineCore/Bvh.hpp"
+
+#include <glm/common.hpp>
+#include <algorithm>
+
+namespace SimpleEngine {
+
+	constexpr unsigned int s_bins_count = 16;
+	constexpr uint32_t s_max_leaf_primitives = 4;
+	//Стек обхода на глубину дерева + 1, глубже узлы становятся листьями
+	constexpr unsigned int s_max_stack_depth = 64;
+
+	static float half_area(const glm::vec3& min, const glm::vec3& max) {
+
+		const glm::vec3 extent = max - min;
+		return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+	}
+
+	static bool overlaps(const glm::vec3& min_a, const glm::vec3& max_a, const glm::vec3& min_b, const glm::vec3& max_b) {
+
+		return min_a.x <= max_b.x && max_a.x >= min_b.x
+			&& min_a.y <= max_b.y && max_a.y >= min_b.y
+			&& min_a.z <= max_b.z && max_a.z >= min_b.z;
+	}
+
+	//Slab тест, t_near - вход в коробку (или 0, если начало луча внутри)
+	static bool intersect_ray(const glm::vec3& origin, const glm::vec3& inverse_direction, const float max_distance,
+							  const glm::vec3& min, const glm::vec3& max, float& t_near) {
+
+		const glm::vec3 t0 = (min - origin) * inverse_direction;
+		const glm::vec3 t1 = (max - origin) * inverse_direction;
+		const glm::vec3 t_min = glm::min(t0, t1);
+		const glm::vec3 t_max = glm::max(t0, t1);
+		t_near = std::max(std::max(t_min.x, t_min.y), std::max(t_min.z, 0.f));
+		const float t_far = std::min(std::min(t_max.x, t_max.y), std::min(t_max.z, max_distance));
+		return t_near <= t_far;
+	}
+
+	//Бит плоскости снимается, когда коробка целиком по её внутреннюю сторону - детям её уже не проверять.
+	//false - коробка снаружи
+	static bool classify_aabb(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max, uint32_t& plane_mask) {
+
+		for (int plane_index = 0; plane_index < Frustum::PlanesCount; ++plane_index) {
+
+			if (!(plane_mask & (1u << plane_index)))
+				continue;
+
+			const glm::vec4& plane = frustum.planes[plane_index];
+			const glm::vec3 positive_vertex(plane.x >= 0.f ? max.x : min.x, plane.y >= 0.f ? max.y : min.y, plane.z >= 0.f ? max.z : min.z);
+			if (plane.x * positive_vertex.x + plane.y * positive_vertex.y + plane.z * positive_vertex.z + plane.w < 0.f)
+				return false;
+
+			const glm::vec3 negative_vertex(plane.x >= 0.f ? min.x : max.x, plane.y >= 0.f ? min.y : max.y, plane.z >= 0.f ? min.z : max.z);
+			if (plane.x * negative_vertex.x + plane.y * negative_vertex.y + plane.z * negative_vertex.z + plane.w >= 0.f)
+				plane_mask &= ~(1u << plane_index);
+		}
+		return true;
+	}
+
+	void Bvh::build(const std::vector<Aabb>& primitive_bounds) {
+
+		const uint32_t count = static_cast<uint32_t>(primitive_bounds.size());
+		m_nodes.clear();
+		m_statistics = Statistics();
+
+		std::vector<BuildPrimitive> primitives(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			primitives[i] = { primitive_bounds[i], (primitive_bounds[i].min + primitive_bounds[i].max) * 0.5f, i };
+		}
+
+		if (count > 0) {
+
+			m_nodes.reserve(2 * (count / s_max_leaf_primitives + 1));
+			m_nodes.emplace_back();
+			build_node(0, 0, count, primitives, 0);
+		}
+		m_statistics.nodes = static_cast<unsigned int>(m_nodes.size());
+
+		m_primitive_indexes.resize(count);
+		m_leaf_bounds.resize(count);
+		for (uint32_t i = 0; i < count; ++i) {
+
+			m_primitive_indexes[i] = primitives[i].index;
+			m_leaf_bounds[i] = primitives[i].bounds;
+		}
+	}
+
+	void Bvh::build_node(const uint32_t node_index, const uint32_t first, const uint32_t count, std::vector<BuildPrimitive>& primitives, const unsigned int depth) {
+
+		glm::vec3 min(std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+		glm::vec3 centroid_min = min, centroid_max = max;
+		for (uint32_t i = first; i < first + count; ++i) {
+
+			min = glm::min(min, primitives[i].bounds.min);
+			max = glm::max(max, primitives[i].bounds.max);
+			centroid_min = glm::min(centroid_min, primitives[i].centroid);
+			centroid_max = glm::max(centroid_max, primitives[i].centroid);
+		}
+		m_nodes[node_index].min = min;
+		m_nodes[node_index].max = max;
+		m_statistics.max_depth = std::max(m_statistics.max_depth, depth);
+
+		auto make_leaf = [this, node_index, first, count]() {
+			m_nodes[node_index].first_or_right = first;
+			m_nodes[node_index].count = count;
+			++m_statistics.leaves;
+		};
+
+		if (count <= s_max_leaf_primitives) {
+			make_leaf();
+			return;
+		}
+
+		//Корзины по центрам примитивов вдоль каждой оси (все три за один проход),
+		//стоимость разбиения - площади детей на число примитивов в них
+		struct Bin {
+
+			glm::vec3 min{ std::numeric_limits<float>::max() };
+			glm::vec3 max{ -std::numeric_limits<float>::max() };
+			uint32_t count = 0;
+		} bins[3][s_bins_count];
+
+		const glm::vec3 centroid_extent = centroid_max - centroid_min;
+		glm::vec3 scale;
+		for (int axis = 0; axis < 3; ++axis) {
+			scale[axis] = centroid_extent[axis] > 0.f ? s_bins_count / centroid_extent[axis] : 0.f;
+		}
+		auto get_bin_index = [&centroid_min, &scale](const glm::vec3& centroid, const int axis) {
+			return std::min(s_bins_count - 1, static_cast<unsigned int>((centroid[axis] - centroid_min[axis]) * scale[axis]));
+		};
+
+		for (uint32_t i = first; i < first + count; ++i) {
+
+			const BuildPrimitive& primitive = primitives[i];
+			for (int axis = 0; axis < 3; ++axis) {
+
+				Bin& bin = bins[axis][get_bin_index(primitive.centroid, axis)];
+				bin.min = glm::min(bin.min, primitive.bounds.min);
+				bin.max = glm::max(bin.max, primitive.bounds.max);
+				++bin.count;
+			}
+		}
+
+		int best_axis = -1;
+		unsigned int best_split = 0;
+		float best_cost = std::numeric_limits<float>::max();
+		for (int axis = 0; axis < 3; ++axis) {
+
+			if (centroid_extent[axis] <= 0.f)
+				continue;
+
+			//Справа налево копим правые части, слева направо - левые
+			float right_costs[s_bins_count];
+			Bin right;
+			for (unsigned int split = s_bins_count - 1; split > 0; --split) {
+
+				right.min = glm::min(right.min, bins[axis][split].min);
+				right.max = glm::max(right.max, bins[axis][split].max);
+				right.count += bins[axis][split].count;
+				right_costs[split] = right.count ? half_area(right.min, right.max) * right.count : 0.f;
+			}
+
+			Bin left;
+			for (unsigned int split = 1; split < s_bins_count; ++split) {
+
+				left.min = glm::min(left.min, bins[axis][split - 1].min);
+				left.max = glm::max(left.max, bins[axis][split - 1].max);
+				left.count += bins[axis][split - 1].count;
+				if (left.count == 0 || left.count == count)
+					continue;
+
+				const float cost = half_area(left.min, left.max) * left.count + right_costs[split];
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_axis = axis;
+					best_split = split;
+				}
+			}
+		}
+
+		uint32_t left_count = 0;
+		if (best_axis >= 0 && depth < s_max_stack_depth - 1) {
+
+			//Лист выгоднее, если обход детей дороже, чем проверить все примитивы разом
+			if (count <= 4 * s_max_leaf_primitives && best_cost >= half_area(min, max) * count) {
+				make_leaf();
+				return;
+			}
+
+			const auto middle = std::partition(primitives.begin() + first, primitives.begin() + first + count,
+				[&get_bin_index, best_axis, best_split](const BuildPrimitive& primitive) {
+					return get_bin_index(primitive.centroid, best_axis) < best_split;
+				});
+			left_count = static_cast<uint32_t>(middle - (primitives.begin() + first));
+		}
+		else if (depth < s_max_stack_depth - 1) {
+
+			//Все центры совпали - делим пополам, чтобы не получить огромный лист
+			left_count = count / 2;
+		}
+		else {
+			make_leaf();
+			return;
+		}
+
+		const uint32_t left_index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+		build_node(left_index, first, left_count, primitives, depth + 1);
+
+		const uint32_t right_index = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+		build_node(right_index, first + left_count, count - left_count, primitives, depth + 1);
+
+		m_nodes[node_index].first_or_right = right_index;
+		m_nodes[node_index].count = 0;
+	}
+
+	void Bvh::refit(const std::vector<Aabb>& primitive_bounds) {
+
+		for (size_t i = 0; i < m_primitive_indexes.size(); ++i) {
+			m_leaf_bounds[i] = primitive_bounds[m_primitive_indexes[i]];
+		}
+
+		//Дети всегда стоят после родителя
+		for (size_t i = m_nodes.size(); i-- > 0;) {
+
+			Node& node = m_nodes[i];
+			if (node.count > 0) {
+
+				node.min = m_leaf_bounds[node.first_or_right].min;
+				node.max = m_leaf_bounds[node.first_or_right].max;
+				for (uint32_t j = node.first_or_right + 1; j < node.first_or_right + node.count; ++j) {
+
+					node.min = glm::min(node.min, m_leaf_bounds[j].min);
+					node.max = glm::max(node.max, m_leaf_bounds[j].max);
+				}
+			}
+			else {
+
+				const Node& left = m_nodes[i + 1];
+				const Node& right = m_nodes[node.first_or_right];
+				node.min = glm::min(left.min, right.min);
+				node.max = glm::max(left.max, right.max);
+			}
+		}
+	}
+
+	void Bvh::clear() {
+
+		m_nodes.clear();
+		m_primitive_indexes.clear();
+		m_leaf_bounds.clear();
+		m_statistics = Statistics();
+	}
+
+	void Bvh::cull(const Frustum& frustum, std::vector<uint32_t>& visible) {
+
+		visible.clear();
+		m_statistics.nodes_visited = 0;
+		m_statistics.primitives_tested = 0;
+		if (m_nodes.empty())
+			return;
+
+		struct StackEntry {
+
+			uint32_t node;
+			uint32_t plane_mask;
+		} stack[s_max_stack_depth];
+		unsigned int stack_size = 0;
+		stack[stack_size++] = { 0, (1u << Frustum::PlanesCount) - 1 };
+
+		while (stack_size > 0) {
+
+			const StackEntry entry = stack[--stack_size];
+			const Node& node = m_nodes[entry.node];
+			uint32_t plane_mask = entry.plane_mask;
+			++m_statistics.nodes_visited;
+			if (plane_mask && !classify_aabb(frustum, node.min, node.max, plane_mask))
+				continue;
+
+			if (node.count == 0) {
+
+				stack[stack_size++] = { node.first_or_right, plane_mask };
+				stack[stack_size++] = { entry.node + 1, plane_mask };
+				continue;
+			}
+
+			for (uint32_t i = node.first_or_right; i < node.first_or_right + node.count; ++i) {
+
+				uint32_t primitive_mask = plane_mask;
+				if (primitive_mask) {
+					++m_statistics.primitives_tested;
+					if (!classify_aabb(frustum, m_leaf_bounds[i].min, m_leaf_bounds[i].max, primitive_mask))
+						continue;
+				}
+				visible.push_back(m_primitive_indexes[i]);
+			}
+		}
+	}
+
+	bool Bvh::raycast(const Ray& ray, RayHit& hit) const {
+
+		hit = RayHit();
+		if (m_nodes.empty())
+			return false;
+
+		//Деление на 0 даёт inf, slab тест с ним корректен
+		const glm::vec3 inverse_direction = 1.f / ray.direction;
+		float closest = ray.max_distance;
+		float t_near;
+
+		uint32_t stack[s_max_stack_depth];
+		unsigned int stack_size = 0;
+		if (intersect_ray(ray.origin, inverse_direction, closest, m_nodes[0].min, m_nodes[0].max, t_near))
+			stack[stack_size++] = 0;
+
+		while (stack_size > 0) {
+
+			const Node& node = m_nodes[stack[--stack_size]];
+			if (node.count > 0) {
+
+				for (uint32_t i = node.first_or_right; i < node.first_or_right + node.count; ++i) {
+
+					if (intersect_ray(ray.origin, inverse_direction, closest, m_leaf_bounds[i].min, m_leaf_bounds[i].max, t_near)) {
+						closest = t_near;
+						hit.primitive = m_primitive_indexes[i];
+						hit.distance = t_near;
+					}
+				}
+				continue;
+			}
+
+			//Ближнего ребёнка кладём последним, чтобы он снялся первым и быстрее сократил closest
+			const uint32_t left_index = static_cast<uint32_t>(&node - m_nodes.data()) + 1;
+			const uint32_t right_index = node.first_or_right;
+			float t_left, t_right;
+			const bool hit_left = intersect_ray(ray.origin, inverse_direction, closest, m_nodes[left_index].min, m_nodes[left_index].max, t_left);
+			const bool hit_right = intersect_ray(ray.origin, inverse_direction, closest, m_nodes[right_index].min, m_nodes[right_index].max, t_right);
+			if (hit_left && hit_right) {
+
+				const bool left_first = t_left <= t_right;
+				stack[stack_size++] = left_first ? right_index : left_index;
+				stack[stack_size++] = left_first ? left_index : right_index;
+			}
+			else if (hit_left) {
+				stack[stack_size++] = left_index;
+			}
+			else if (hit_right) {
+				stack[stack_size++] = right_index;
+			}
+		}
+		return hit.primitive != ~0u;
+	}
+
+	void Bvh::query_aabb(const Aabb& bounds, std::vector<uint32_t>& result) const {
+
+		result.clear();
+		if (m_nodes.empty())
+			return;
+
+		uint32_t stack[s_max_stack_depth];
+		unsigned int stack_size = 0;
+		stack[stack_size++] = 0;
+
+		while (stack_size > 0) {
+
+			const uint32_t node_index = stack[--stack_size];
+			const Node& node = m_nodes[node_index];
+			if (!overlaps(node.min, node.max, bounds.min, bounds.max))
+				continue;
+
+			if (node.count == 0) {
+				stack[stack_size++] = node.first_or_right;
+				stack[stack_size++] = node_index + 1;
+				continue;
+			}
+
+			for (uint32_t i = node.first_or_right; i < node.first_or_right + node.count; ++i) {
+				if (overlaps(m_leaf_bounds[i].min, m_leaf_bounds[i].max, bounds.min, bounds.max))
+					result.push_back(m_primitive_indexes[i]);
+			}
+		}
+	}
+}
@@ -46,6 +46,7 @@ namespace SimpleEngine {
 		m_up = glm::cross(m_right, m_direction);
 		//m_view_matrix = rotate_matrix_y * rotate_matrix_x * translate_matrix;
 		m_view_matrix = glm::lookAt(m_position, m_position + m_direction, m_up);
+		++m_update_count;
 	}
 
 	void Camera::update_projection_matrix() {
@@ -70,6 +71,7 @@ namespace SimpleEngine {
 											0, 0, -2 / (f - n), 0,
 											0, 0, (-f - n) / (f - n), 1);
 		}
+		++m_update_count;
 	}
 
 	void Camera::set_position(const glm::vec3& position) {
@@ -92,6 +94,8 @@ namespace SimpleEngine {
 	}
 
 	void Camera::set_projection_mode(const ProjectionMode projection_mode) {
+		if (m_projection_mode == projection_mode)
+			return;
 		m_projection_mode = projection_mode;
 		update_projection_matrix();
 	}
@@ -114,7 +118,7 @@ namespace SimpleEngine {
 		update_view_matrix();
 	}
 
-	//   
+	//Для нескольких движений одновременно
 	void Camera::add_movement_and_rotation(const glm::vec3& movement_delta, const glm::vec3& rotation_delta) {
 
 		m_position += m_direction * movement_delta.x;
@@ -0,0 +1,153 @@
+#include "SimpleEngineCore/Frustum.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+#include "SimpleEngineCore/Simd.hpp"
+
+#include <glm/geometric.hpp>
+
+namespace SimpleEngine {
+
+	Frustum Frustum::from_matrix(const glm::mat4& view_projection_matrix) {
+
+		//glm хранит по столбцам, строка i - (m[0][i], m[1][i], m[2][i], m[3][i]) (Gribb/Hartmann)
+		const glm::mat4& m = view_projection_matrix;
+		const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+		const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+		const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+		const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+		Frustum frustum;
+		frustum.planes[Left] = row3 + row0;
+		frustum.planes[Right] = row3 - row0;
+		frustum.planes[Bottom] = row3 + row1;
+		frustum.planes[Top] = row3 - row1;
+		frustum.planes[Near] = row3 + row2;
+		frustum.planes[Far] = row3 - row2;
+
+		//Нормируем, чтобы расстояние до плоскости сравнивалось с радиусом напрямую
+		for (glm::vec4& plane : frustum.planes) {
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return frustum;
+	}
+
+	bool Frustum::intersects_sphere(const glm::vec3& center, const float radius) const {
+
+		for (const glm::vec4& plane : planes) {
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	bool Frustum::intersects_aabb(const glm::vec3& min, const glm::vec3& max) const {
+
+		//Берём вершину коробки, дальше всех продвинутую вдоль нормали плоскости
+		for (const glm::vec4& plane : planes) {
+
+			const glm::vec3 positive_vertex(plane.x >= 0.f ? max.x : min.x,
+											plane.y >= 0.f ? max.y : min.y,
+											plane.z >= 0.f ? max.z : min.z);
+			if (glm::dot(glm::vec3(plane), positive_vertex) + plane.w < 0.f)
+				return false;
+		}
+		return true;
+	}
+
+	void FrustumCuller::clear() {
+
+		m_centers_x.clear();
+		m_centers_y.clear();
+		m_centers_z.clear();
+		m_radii.clear();
+		m_visible.clear();
+	}
+
+	void FrustumCuller::reserve(const size_t count) {
+
+		m_centers_x.reserve(count);
+		m_centers_y.reserve(count);
+		m_centers_z.reserve(count);
+		m_radii.reserve(count);
+		m_visible.reserve(count);
+		m_visible_flags.reserve(count);
+	}
+
+	void FrustumCuller::add_sphere(const glm::vec3& center, const float radius) {
+
+		m_centers_x.push_back(center.x);
+		m_centers_y.push_back(center.y);
+		m_centers_z.push_back(center.z);
+		m_radii.push_back(radius);
+	}
+
+	const std::vector<uint32_t>& FrustumCuller::cull(const Frustum& frustum, JobSystem* pJobSystem) {
+
+		//Кратен 4, чтобы куски не дробили SSE пачки
+		constexpr uint32_t parallel_grain = 4096;
+
+		const size_t count = m_radii.size();
+		m_visible_flags.resize(count);
+		if (pJobSystem) {
+			pJobSystem->parallel_for(static_cast<uint32_t>(count), parallel_grain, [this, &frustum](const uint32_t begin, const uint32_t end) {
+				cull_range(frustum, begin, end, m_visible_flags.data() + begin);
+			});
+		}
+		else {
+			cull_range(frustum, 0, count, m_visible_flags.data());
+		}
+
+		m_visible.clear();
+		for (size_t i = 0; i < count; ++i) {
+			if (m_visible_flags[i])
+				m_visible.push_back(static_cast<uint32_t>(i));
+		}
+
+		m_statistics.tested = static_cast<unsigned int>(count);
+		m_statistics.culled = static_cast<unsigned int>(count - m_visible.size());
+		return m_visible;
+	}
+
+	void FrustumCuller::cull_range(const Frustum& frustum, const size_t begin, const size_t end, uint8_t* visible_flags) const {
+
+		size_t i = begin;
+
+#ifdef SIMPLE_ENGINE_USE_SSE
+		__m128 plane_x[Frustum::PlanesCount], plane_y[Frustum::PlanesCount], plane_z[Frustum::PlanesCount], plane_w[Frustum::PlanesCount];
+		for (int plane = 0; plane < Frustum::PlanesCount; ++plane) {
+
+			plane_x[plane] = _mm_set1_ps(frustum.planes[plane].x);
+			plane_y[plane] = _mm_set1_ps(frustum.planes[plane].y);
+			plane_z[plane] = _mm_set1_ps(frustum.planes[plane].z);
+			plane_w[plane] = _mm_set1_ps(frustum.planes[plane].w);
+		}
+
+		const __m128 zero = _mm_setzero_ps();
+		for (; i + 4 <= end; i += 4) {
+
+			const __m128 x = _mm_loadu_ps(&m_centers_x[i]);
+			const __m128 y = _mm_loadu_ps(&m_centers_y[i]);
+			const __m128 z = _mm_loadu_ps(&m_centers_z[i]);
+			const __m128 negative_radius = _mm_sub_ps(zero, _mm_loadu_ps(&m_radii[i]));
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for (int plane = 0; plane < Frustum::PlanesCount; ++plane) {
+
+				__m128 distance = _mm_add_ps(_mm_mul_ps(plane_x[plane], x), plane_w[plane]);
+				distance = _mm_add_ps(distance, _mm_mul_ps(plane_y[plane], y));
+				distance = _mm_add_ps(distance, _mm_mul_ps(plane_z[plane], z));
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negative_radius));
+			}
+
+			const int inside_mask = _mm_movemask_ps(inside);
+			for (int lane = 0; lane < 4; ++lane) {
+				visible_flags[i - begin + lane] = (inside_mask >> lane) & 1;
+			}
+		}
+#endif
+
+		//Хвост (и всё, если SSE нет)
+		for (; i < end; ++i) {
+			visible_flags[i - begin] = frustum.intersects_sphere(glm::vec3(m_centers_x[i], m_centers_y[i], m_centers_z[i]), m_radii[i]) ? 1 : 0;
+		}
+	}
+}
@@ -0,0 +1,852 @@
+#include "ImageDecoder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace SimpleEngine {
+
+	bool is_block_compressed(const EImageFormat format) {
+
+		return format != EImageFormat::RGBA8;
+	}
+
+	size_t get_image_level_size(const EImageFormat format, const uint32_t width, const uint32_t height) {
+
+		const size_t blocks_count = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+		switch (format) {
+		case EImageFormat::RGBA8:	return static_cast<size_t>(width) * height * 4;
+		case EImageFormat::BC1:
+		case EImageFormat::BC1A:	return blocks_count * 8;
+		case EImageFormat::BC3:
+		case EImageFormat::BC7:		return blocks_count * 16;
+		}
+		return 0;
+	}
+
+	unsigned int get_mip_levels_count(uint32_t width, uint32_t height) {
+
+		unsigned int levels_count = 1;
+		while (width > 1 || height > 1) {
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+			++levels_count;
+		}
+		return levels_count;
+	}
+
+	static uint32_t read_u16_le(const uint8_t* p) { return p[0] | (p[1] << 8); }
+	static uint32_t read_u32_le(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24); }
+	static uint64_t read_u64_le(const uint8_t* p) { return read_u32_le(p) | (static_cast<uint64_t>(read_u32_le(p + 4)) << 32); }
+	static uint32_t read_u32_be(const uint8_t* p) { return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3]; }
+
+	//Защита от заголовков с огромными размерами: дальше выделяется width * height * 4 байт
+	static constexpr uint32_t s_max_dimension = 16384;
+
+	static void set_single_level(Image& image, const uint32_t width, const uint32_t height) {
+
+		image.format = EImageFormat::RGBA8;
+		image.levels.assign(1, ImageLevel{ width, height, 0, static_cast<size_t>(width) * height * 4 });
+		image.data.resize(image.levels[0].size);
+	}
+
+	//----- inflate (RFC 1951) для PNG -----
+
+	class BitReader {
+	public:
+		BitReader(const uint8_t* pData, const size_t size) : m_pData(pData), m_size(size) {}
+
+		uint32_t get_bits(const unsigned int count) {
+
+			refill();
+			const uint32_t value = static_cast<uint32_t>(m_bits & ((1ull << count) - 1));
+			m_bits >>= count;
+			m_bits_count -= count;
+			return value;
+		}
+
+		uint32_t peek_bits(const unsigned int count) {
+
+			refill();
+			return static_cast<uint32_t>(m_bits & ((1ull << count) - 1));
+		}
+
+		void skip_bits(const unsigned int count) {
+
+			m_bits >>= count;
+			m_bits_count -= count;
+		}
+
+		//Для stored блоков: остаток текущего байта отбрасывается, уже прочитанные в m_bits байты возвращаются
+		void align_to_byte() {
+
+			skip_bits(m_bits_count % 8);
+			m_position -= m_bits_count / 8;
+			m_bits = 0;
+			m_bits_count = 0;
+		}
+
+		const uint8_t* get_bytes(const size_t count) {
+
+			if (m_position + count > m_size)
+				return nullptr;
+			const uint8_t* pBytes = m_pData + m_position;
+			m_position += count;
+			return pBytes;
+		}
+
+		//Чтение за концом даёт нули - ошибку видно только здесь. refill() забирает байты наперёд, поэтому считаем по битам
+		bool is_overrun() const { return m_position * 8 - m_bits_count > m_size * 8; }
+
+	private:
+		void refill() {
+
+			while (m_bits_count <= 56) {
+				const uint64_t byte = m_position < m_size ? m_pData[m_position] : 0;
+				++m_position;
+				m_bits |= byte << m_bits_count;
+				m_bits_count += 8;
+			}
+		}
+
+		const uint8_t* m_pData;
+		size_t m_size;
+		size_t m_position = 0;
+		uint64_t m_bits = 0;
+		unsigned int m_bits_count = 0;
+	};
+
+	//Канонический код Хаффмана: короткие коды - по таблице на s_fast_bits бит, длинные - по длинам
+	class Huffman {
+	public:
+		bool build(const uint8_t* lengths, const unsigned int count) {
+
+			uint16_t offsets[16] = {};
+			std::memset(m_counts, 0, sizeof(m_counts));
+			for (unsigned int symbol = 0; symbol < count; ++symbol)
+				++m_counts[lengths[symbol]];
+			m_counts[0] = 0;
+
+			int left = 1;
+			for (unsigned int length = 1; length < 16; ++length) {
+				left = left * 2 - m_counts[length];
+				if (left < 0)
+					return false;//Кодов больше, чем помещается
+				offsets[length] = static_cast<uint16_t>(length == 1 ? 0 : offsets[length - 1] + m_counts[length - 1]);
+			}
+			for (unsigned int symbol = 0; symbol < count; ++symbol) {
+				if (lengths[symbol] != 0)
+					m_symbols[offsets[lengths[symbol]]++] = static_cast<uint16_t>(symbol);
+			}
+
+			std::fill(std::begin(m_fast), std::end(m_fast), uint16_t(0));
+			unsigned int code = 0;
+			unsigned int index = 0;
+			for (unsigned int length = 1; length <= s_fast_bits; ++length) {
+				for (unsigned int i = 0; i < m_counts[length]; ++i, ++code, ++index) {
+					//В потоке код идёт старшим битом вперёд, а биты читаются с младшего - в таблице он развёрнут
+					unsigned int reversed = 0;
+					for (unsigned int bit = 0; bit < length; ++bit)
+						reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+					for (unsigned int fill = reversed; fill < (1u << s_fast_bits); fill += 1u << length)
+						m_fast[fill] = static_cast<uint16_t>((m_symbols[index] << 4) | length);
+				}
+				code <<= 1;
+			}
+			return true;
+		}
+
+		//-1 - неверный код
+		int decode(BitReader& reader) const {
+
+			const uint16_t entry = m_fast[reader.peek_bits(s_fast_bits)];
+			if (entry != 0) {
+				reader.skip_bits(entry & 15);
+				return entry >> 4;
+			}
+
+			int code = 0;
+			int first = 0;
+			int index = 0;
+			for (unsigned int length = 1; length < 16; ++length) {
+				code |= static_cast<int>(reader.get_bits(1));
+				const int count = m_counts[length];
+				if (code - first < count)
+					return m_symbols[index + code - first];
+				index += count;
+				first = (first + count) << 1;
+				code <<= 1;
+			}
+			return -1;
+		}
+
+	private:
+		static constexpr unsigned int s_fast_bits = 9;
+
+		uint16_t m_counts[16] = {};
+		uint16_t m_symbols[288] = {};
+		//symbol << 4 | длина, 0 - код длиннее s_fast_bits
+		uint16_t m_fast[1 << s_fast_bits] = {};
+	};
+
+	//output растёт сразу с запасом, занятое - первые output_size байт: без push_back на каждый байт.
+	//Больше max_size не растёт (nullptr): размер из заголовка картинки - верхняя граница, а не первое выделение
+	static uint8_t* reserve_output(std::vector<uint8_t>& output, const size_t output_size, const size_t count, const size_t max_size) {
+
+		if (output_size + count > output.size()) {
+			if (output_size + count > max_size)
+				return nullptr;
+			output.resize(std::min(std::max(output.size() * 2, output_size + count), max_size));
+		}
+		return output.data() + output_size;
+	}
+
+	static bool inflate_block(BitReader& reader, const Huffman& literals, const Huffman& distances, std::vector<uint8_t>& output, size_t& output_size, const size_t max_size) {
+
+		static const uint16_t length_bases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		static const uint8_t length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		static const uint16_t distance_bases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+		static const uint8_t distance_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+		while (true) {
+
+			const int symbol = literals.decode(reader);
+			if (symbol < 0 || reader.is_overrun())
+				return false;
+			if (symbol < 256) {
+				uint8_t* pOutput = reserve_output(output, output_size, 1, max_size);
+				if (!pOutput)
+					return false;
+				*pOutput = static_cast<uint8_t>(symbol);
+				++output_size;
+				continue;
+			}
+			if (symbol == 256)
+				return true;
+			if (symbol > 285)
+				return false;
+
+			const size_t length = length_bases[symbol - 257] + reader.get_bits(length_extra[symbol - 257]);
+			const int distance_symbol = distances.decode(reader);
+			if (distance_symbol < 0 || distance_symbol > 29)
+				return false;
+			const size_t distance = distance_bases[distance_symbol] + reader.get_bits(distance_extra[distance_symbol]);
+			if (distance > output_size)
+				return false;
+
+			//Источник может перекрываться с тем, что пишем (distance < length) - копия побайтно
+			uint8_t* pOutput = reserve_output(output, output_size, length, max_size);
+			if (!pOutput)
+				return false;
+			const uint8_t* pSource = pOutput - distance;
+			for (size_t i = 0; i < length; ++i)
+				pOutput[i] = pSource[i];
+			output_size += length;
+		}
+	}
+
+	//zlib поток (RFC 1950): заголовок, deflate блоки, adler32. Распакованное больше max_size - ошибка
+	static bool inflate_zlib(const uint8_t* pData, const size_t size, std::vector<uint8_t>& output, const size_t max_size, std::string& error) {
+
+		if (size < 6 || (pData[0] & 0x0F) != 8 || ((pData[0] << 8) | pData[1]) % 31 != 0 || (pData[1] & 0x20)) {
+			error = "bad zlib header";
+			return false;
+		}
+
+		//Заголовок может обещать гигабайты при паре килобайт данных - начинаем с оценки по сжатому размеру
+		output.resize(std::min(max_size, std::max<size_t>(size * 4, 1024)));
+		size_t output_size = 0;
+		BitReader reader(pData + 2, size - 2);
+		Huffman literals;
+		Huffman distances;
+		bool final_block = false;
+		while (!final_block) {
+
+			final_block = reader.get_bits(1) != 0;
+			const uint32_t type = reader.get_bits(2);
+			if (type == 0) {
+				reader.align_to_byte();
+				const uint8_t* pHeader = reader.get_bytes(4);
+				if (!pHeader || (read_u16_le(pHeader) ^ read_u16_le(pHeader + 2)) != 0xFFFF) {
+					error = "bad stored deflate block";
+					return false;
+				}
+				const uint32_t length = read_u16_le(pHeader);
+				const uint8_t* pBytes = reader.get_bytes(length);
+				if (!pBytes) {
+					error = "truncated deflate stream";
+					return false;
+				}
+				uint8_t* pOutput = reserve_output(output, output_size, length, max_size);
+				if (!pOutput) {
+					error = "deflate stream is larger than the image";
+					return false;
+				}
+				std::memcpy(pOutput, pBytes, length);
+				output_size += length;
+				continue;
+			}
+
+			uint8_t lengths[288 + 32];
+			if (type == 1) {
+				std::fill(lengths, lengths + 144, uint8_t(8));
+				std::fill(lengths + 144, lengths + 256, uint8_t(9));
+				std::fill(lengths + 256, lengths + 280, uint8_t(7));
+				std::fill(lengths + 280, lengths + 288, uint8_t(8));
+				literals.build(lengths, 288);
+				std::fill(lengths, lengths + 30, uint8_t(5));
+				distances.build(lengths, 30);
+			}
+			else if (type == 2) {
+				static const uint8_t code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+				const unsigned int literals_count = reader.get_bits(5) + 257;
+				const unsigned int distances_count = reader.get_bits(5) + 1;
+				const unsigned int code_lengths_count = reader.get_bits(4) + 4;
+				if (literals_count > 286 || distances_count > 30) {
+					error = "bad dynamic deflate block";
+					return false;
+				}
+
+				uint8_t code_lengths[19] = {};
+				for (unsigned int i = 0; i < code_lengths_count; ++i)
+					code_lengths[code_length_order[i]] = static_cast<uint8_t>(reader.get_bits(3));
+				Huffman code_lengths_huffman;
+				if (!code_lengths_huffman.build(code_lengths, 19)) {
+					error = "bad dynamic deflate block";
+					return false;
+				}
+
+				const unsigned int total_count = literals_count + distances_count;
+				for (unsigned int i = 0; i < total_count;) {
+
+					const int symbol = code_lengths_huffman.decode(reader);
+					unsigned int repeat = 1;
+					uint8_t value = 0;
+					if (symbol < 0) {
+						error = "bad dynamic deflate block";
+						return false;
+					}
+					if (symbol < 16) {
+						value = static_cast<uint8_t>(symbol);
+					}
+					else if (symbol == 16) {
+						if (i == 0) {
+							error = "bad dynamic deflate block";
+							return false;
+						}
+						value = lengths[i - 1];
+						repeat = 3 + reader.get_bits(2);
+					}
+					else {
+						repeat = symbol == 17 ? 3 + reader.get_bits(3) : 11 + reader.get_bits(7);
+					}
+					if (i + repeat > total_count) {
+						error = "bad dynamic deflate block";
+						return false;
+					}
+					std::fill(lengths + i, lengths + i + repeat, value);
+					i += repeat;
+				}
+				if (!literals.build(lengths, literals_count) || !distances.build(lengths + literals_count, distances_count)) {
+					error = "bad dynamic deflate block";
+					return false;
+				}
+			}
+			else {
+				error = "bad deflate block type";
+				return false;
+			}
+
+			if (!inflate_block(reader, literals, distances, output, output_size, max_size)) {
+				error = "corrupted deflate stream";
+				return false;
+			}
+		}
+
+		output.resize(output_size);
+		reader.align_to_byte();
+		const uint8_t* pAdler = reader.get_bytes(4);
+		if (!pAdler) {
+			error = "truncated zlib stream";
+			return false;
+		}
+		uint32_t a = 1;
+		uint32_t b = 0;
+		for (size_t offset = 0; offset < output.size();) {
+			//5552 - наибольший кусок, после которого b ещё не переполняется
+			const size_t end = std::min(output.size(), offset + 5552);
+			for (; offset < end; ++offset) {
+				a += output[offset];
+				b += a;
+			}
+			a %= 65521;
+			b %= 65521;
+		}
+		if (((b << 16) | a) != read_u32_be(pAdler)) {
+			error = "zlib checksum mismatch";
+			return false;
+		}
+		return true;
+	}
+
+	//----- PNG -----
+
+	static uint8_t paeth(const int a, const int b, const int c) {
+
+		const int p = a + b - c;
+		const int pa = std::abs(p - a);
+		const int pb = std::abs(p - b);
+		const int pc = std::abs(p - c);
+		if (pa <= pb && pa <= pc)
+			return static_cast<uint8_t>(a);
+		return static_cast<uint8_t>(pb <= pc ? b : c);
+	}
+
+	static bool unfilter_png(uint8_t* pData, const uint32_t height, const size_t stride, const size_t pixel_bytes) {
+
+		//Над первой строкой - нулевая, так в циклах не нужно проверять её наличие
+		std::vector<uint8_t> zero_row(stride, 0);
+		const uint8_t* pPrevious = zero_row.data();
+		for (uint32_t y = 0; y < height; ++y) {
+
+			const uint8_t filter = pData[0];
+			uint8_t* pRow = pData + 1;
+			//Первые pixel_bytes байт строки - без соседа слева
+			switch (filter) {
+			case 0:
+				break;
+			case 1:
+				for (size_t i = pixel_bytes; i < stride; ++i)
+					pRow[i] = static_cast<uint8_t>(pRow[i] + pRow[i - pixel_bytes]);
+				break;
+			case 2:
+				for (size_t i = 0; i < stride; ++i)
+					pRow[i] = static_cast<uint8_t>(pRow[i] + pPrevious[i]);
+				break;
+			case 3:
+				for (size_t i = 0; i < pixel_bytes; ++i)
+					pRow[i] = static_cast<uint8_t>(pRow[i] + (pPrevious[i] >> 1));
+				for (size_t i = pixel_bytes; i < stride; ++i)
+					pRow[i] = static_cast<uint8_t>(pRow[i] + ((pRow[i - pixel_bytes] + pPrevious[i]) >> 1));
+				break;
+			case 4:
+				for (size_t i = 0; i < pixel_bytes; ++i)
+					pRow[i] = static_cast<uint8_t>(pRow[i] + pPrevious[i]);
+				for (size_t i = pixel_bytes; i < stride; ++i)
+					pRow[i] = static_cast<uint8_t>(pRow[i] + paeth(pRow[i - pixel_bytes], pPrevious[i], pPrevious[i - pixel_bytes]));
+				break;
+			default:
+				return false;
+			}
+			pPrevious = pRow;
+			pData += stride + 1;
+		}
+		return true;
+	}
+
+	static bool decode_png(const uint8_t* pData, const size_t size, Image& image, std::string& error) {
+
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t bit_depth = 0;
+		uint32_t color_type = 0;
+		uint8_t palette[256 * 4];
+		uint32_t palette_count = 0;
+		std::vector<uint8_t> compressed;
+
+		bool has_header = false;
+		bool has_end = false;
+		size_t offset = 8;
+		while (!has_end) {
+
+			if (offset + 12 > size) {
+				error = "truncated PNG";
+				return false;
+			}
+			const uint32_t length = read_u32_be(pData + offset);
+			const uint8_t* pType = pData + offset + 4;
+			const uint8_t* pChunk = pData + offset + 8;
+			if (length > size - offset - 12) {
+				error = "truncated PNG";
+				return false;
+			}
+			offset += 12 + static_cast<size_t>(length);
+
+			if (std::memcmp(pType, "IHDR", 4) == 0) {
+				if (length != 13) {
+					error = "bad PNG header";
+					return false;
+				}
+				width = read_u32_be(pChunk);
+				height = read_u32_be(pChunk + 4);
+				bit_depth = pChunk[8];
+				color_type = pChunk[9];
+				if (pChunk[12] != 0) {
+					error = "interlaced PNG is not supported";
+					return false;
+				}
+				const bool valid_depth = color_type == 3 ? (bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8)
+					: color_type == 0 ? (bit_depth == 1 || bit_depth == 2 || bit_depth == 4 || bit_depth == 8 || bit_depth == 16)
+					: (color_type == 2 || color_type == 4 || color_type == 6) && (bit_depth == 8 || bit_depth == 16);
+				if (!valid_depth || width == 0 || height == 0 || pChunk[10] != 0 || pChunk[11] != 0) {
+					error = "unsupported PNG format";
+					return false;
+				}
+				if (width > s_max_dimension || height > s_max_dimension) {
+					error = "PNG is too large";
+					return false;
+				}
+				has_header = true;
+			}
+			else if (std::memcmp(pType, "PLTE", 4) == 0) {
+				palette_count = std::min(256u, length / 3);
+				for (uint32_t i = 0; i < palette_count; ++i) {
+					std::memcpy(palette + i * 4, pChunk + i * 3, 3);
+					palette[i * 4 + 3] = 255;
+				}
+			}
+			else if (std::memcmp(pType, "tRNS", 4) == 0) {
+				//Прозрачность поддерживаем только для палитры - цветовой ключ у truecolor почти не встречается
+				for (uint32_t i = 0; color_type == 3 && i < std::min(length, palette_count); ++i)
+					palette[i * 4 + 3] = pChunk[i];
+			}
+			else if (std::memcmp(pType, "IDAT", 4) == 0) {
+				compressed.insert(compressed.end(), pChunk, pChunk + length);
+			}
+			else if (std::memcmp(pType, "IEND", 4) == 0) {
+				has_end = true;
+			}
+			else if (!(pType[0] & 0x20)) {
+				//Строчная первая буква - вспомогательный блок, остальные пропускать нельзя
+				error = "unknown critical PNG chunk " + std::string(reinterpret_cast<const char*>(pType), 4);
+				return false;
+			}
+		}
+		if (!has_header || compressed.empty() || (color_type == 3 && palette_count == 0)) {
+			error = "incomplete PNG";
+			return false;
+		}
+
+		static const uint32_t channels_by_color_type[7] = { 1, 0, 3, 1, 2, 0, 4 };
+		const uint32_t channels = channels_by_color_type[color_type];
+		const size_t stride = (static_cast<size_t>(width) * channels * bit_depth + 7) / 8;
+		const size_t pixel_bytes = std::max<size_t>(1, channels * bit_depth / 8);
+
+		std::vector<uint8_t> filtered;
+		if (!inflate_zlib(compressed.data(), compressed.size(), filtered, (stride + 1) * height, error))
+			return false;
+		if (filtered.size() < (stride + 1) * height) {
+			error = "truncated PNG image data";
+			return false;
+		}
+		if (!unfilter_png(filtered.data(), height, stride, pixel_bytes)) {
+			error = "bad PNG filter";
+			return false;
+		}
+
+		set_single_level(image, width, height);
+		uint8_t* pOutput = image.data.data();
+		for (uint32_t y = 0; y < height; ++y) {
+
+			const uint8_t* pRow = filtered.data() + y * (stride + 1) + 1;
+			if (color_type == 6 && bit_depth == 8) {
+				std::memcpy(pOutput, pRow, stride);
+				pOutput += stride;
+				continue;
+			}
+			for (uint32_t x = 0; x < width; ++x, pOutput += 4) {
+
+				if (bit_depth < 8) {
+					//Пиксели упакованы в байт старшими битами вперёд
+					const uint32_t bit = x * bit_depth;
+					const uint32_t value = (pRow[bit / 8] >> (8 - bit_depth - bit % 8)) & ((1u << bit_depth) - 1);
+					if (color_type == 3) {
+						std::memcpy(pOutput, palette + std::min(value, palette_count - 1) * 4, 4);
+					}
+					else {
+						const uint8_t gray = static_cast<uint8_t>(value * 255 / ((1u << bit_depth) - 1));
+						pOutput[0] = pOutput[1] = pOutput[2] = gray;
+						pOutput[3] = 255;
+					}
+					continue;
+				}
+
+				//16 бит - берём старший байт
+				const size_t step = bit_depth / 8;
+				const uint8_t* pPixel = pRow + x * channels * step;
+				uint8_t values[4];
+				for (uint32_t channel = 0; channel < channels; ++channel)
+					values[channel] = pPixel[channel * step];
+
+				switch (color_type) {
+				case 0:	pOutput[0] = pOutput[1] = pOutput[2] = values[0]; pOutput[3] = 255; break;
+				case 2:	pOutput[0] = values[0]; pOutput[1] = values[1]; pOutput[2] = values[2]; pOutput[3] = 255; break;
+				case 3:	std::memcpy(pOutput, palette + std::min<uint32_t>(values[0], palette_count - 1) * 4, 4); break;
+				case 4:	pOutput[0] = pOutput[1] = pOutput[2] = values[0]; pOutput[3] = values[1]; break;
+				default: std::memcpy(pOutput, values, 4); break;
+				}
+			}
+		}
+		return true;
+	}
+
+	//----- TGA -----
+
+	static bool decode_tga(const uint8_t* pData, const size_t size, Image& image, std::string& error) {
+
+		const uint32_t id_length = pData[0];
+		const uint32_t color_map_type = pData[1];
+		const uint32_t image_type = pData[2];
+		const uint32_t color_map_bytes = color_map_type ? read_u16_le(pData + 5) * ((pData[7] + 7) / 8) : 0;
+		const uint32_t width = read_u16_le(pData + 12);
+		const uint32_t height = read_u16_le(pData + 14);
+		const uint32_t bits_per_pixel = pData[16];
+		const bool top_to_bottom = (pData[17] & 0x20) != 0;
+
+		const bool rle = image_type == 10 || image_type == 11;
+		const bool gray = image_type == 3 || image_type == 11;
+		if (!(image_type == 2 || image_type == 3 || rle) || (gray ? bits_per_pixel != 8 : (bits_per_pixel != 24 && bits_per_pixel != 32))) {
+			error = "unsupported TGA format: only 24/32-bit truecolor and 8-bit grayscale";
+			return false;
+		}
+		if (width == 0 || height == 0 || width > s_max_dimension || height > s_max_dimension) {
+			error = "bad TGA size";
+			return false;
+		}
+
+		const uint32_t pixel_bytes = bits_per_pixel / 8;
+		const size_t pixels_count = static_cast<size_t>(width) * height;
+		size_t offset = 18 + id_length + color_map_bytes;
+		if (!rle && offset + pixels_count * pixel_bytes > size) {
+			error = "truncated TGA";
+			return false;
+		}
+
+		set_single_level(image, width, height);
+		//TGA хранит BGR(A)
+		auto write_pixel = [&](const uint8_t* pPixel, const size_t index) {
+
+			const uint32_t x = static_cast<uint32_t>(index % width);
+			const uint32_t y = static_cast<uint32_t>(index / width);
+			//По умолчанию строки идут снизу вверх, а GL ждёт первой верхнюю
+			uint8_t* pOutput = image.data.data() + (static_cast<size_t>(top_to_bottom ? y : height - 1 - y) * width + x) * 4;
+			if (gray) {
+				pOutput[0] = pOutput[1] = pOutput[2] = pPixel[0];
+				pOutput[3] = 255;
+				return;
+			}
+			pOutput[0] = pPixel[2];
+			pOutput[1] = pPixel[1];
+			pOutput[2] = pPixel[0];
+			pOutput[3] = pixel_bytes == 4 ? pPixel[3] : 255;
+		};
+
+		if (!rle) {
+			for (size_t i = 0; i < pixels_count; ++i)
+				write_pixel(pData + offset + i * pixel_bytes, i);
+			return true;
+		}
+
+		for (size_t i = 0; i < pixels_count;) {
+
+			if (offset >= size) {
+				error = "truncated TGA";
+				return false;
+			}
+			const uint8_t packet = pData[offset++];
+			const size_t count = std::min<size_t>((packet & 0x7F) + 1, pixels_count - i);
+			//Старший бит - повтор одного пикселя, иначе count пикселей как есть
+			const size_t packet_bytes = (packet & 0x80) ? pixel_bytes : count * pixel_bytes;
+			if (offset + packet_bytes > size) {
+				error = "truncated TGA";
+				return false;
+			}
+			for (size_t j = 0; j < count; ++j, ++i)
+				write_pixel(pData + offset + ((packet & 0x80) ? 0 : j * pixel_bytes), i);
+			offset += packet_bytes;
+		}
+		return true;
+	}
+
+	//----- KTX2 -----
+
+	static const uint8_t s_ktx2_identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	static bool decode_ktx2(const uint8_t* pData, const size_t size, Image& image, std::string& error) {
+
+		static constexpr size_t header_size = 80;
+		if (size < header_size) {
+			error = "truncated KTX2";
+			return false;
+		}
+
+		const uint32_t vk_format = read_u32_le(pData + 12);
+		const uint32_t width = read_u32_le(pData + 20);
+		const uint32_t height = read_u32_le(pData + 24);
+		const uint32_t depth = read_u32_le(pData + 28);
+		const uint32_t layers_count = read_u32_le(pData + 32);
+		const uint32_t faces_count = read_u32_le(pData + 36);
+		const uint32_t levels_count = read_u32_le(pData + 40);
+		const uint32_t supercompression = read_u32_le(pData + 44);
+
+		//Номера VkFormat
+		switch (vk_format) {
+		case 37:	image.format = EImageFormat::RGBA8;	image.srgb = false; break;
+		case 43:	image.format = EImageFormat::RGBA8;	image.srgb = true; break;
+		case 131:	image.format = EImageFormat::BC1;	image.srgb = false; break;
+		case 132:	image.format = EImageFormat::BC1;	image.srgb = true; break;
+		case 133:	image.format = EImageFormat::BC1A;	image.srgb = false; break;
+		case 134:	image.format = EImageFormat::BC1A;	image.srgb = true; break;
+		case 137:	image.format = EImageFormat::BC3;	image.srgb = false; break;
+		case 138:	image.format = EImageFormat::BC3;	image.srgb = true; break;
+		case 145:	image.format = EImageFormat::BC7;	image.srgb = false; break;
+		case 146:	image.format = EImageFormat::BC7;	image.srgb = true; break;
+		default:
+			error = "unsupported KTX2 format " + std::to_string(vk_format) + ": expected RGBA8, BC1, BC3 or BC7";
+			return false;
+		}
+		if (supercompression != 0) {
+			error = "KTX2 supercompression is not supported";
+			return false;
+		}
+		if (depth > 1 || layers_count > 1 || faces_count != 1 || width == 0 || height == 0 || width > s_max_dimension || height > s_max_dimension) {
+			error = "only 2D KTX2 textures are supported";
+			return false;
+		}
+
+		//0 - мипы должен построить загрузчик
+		const uint32_t stored_levels_count = std::max(1u, levels_count);
+		if (stored_levels_count > get_mip_levels_count(width, height) || header_size + stored_levels_count * 24 > size) {
+			error = "bad KTX2 level index";
+			return false;
+		}
+
+		image.levels.resize(stored_levels_count);
+		size_t data_size = 0;
+		for (uint32_t level = 0; level < stored_levels_count; ++level) {
+
+			ImageLevel& image_level = image.levels[level];
+			image_level.width = std::max(1u, width >> level);
+			image_level.height = std::max(1u, height >> level);
+			image_level.offset = data_size;
+			image_level.size = get_image_level_size(image.format, image_level.width, image_level.height);
+			data_size += image_level.size;
+		}
+		image.data.resize(data_size);
+
+		for (uint32_t level = 0; level < stored_levels_count; ++level) {
+
+			const uint8_t* pEntry = pData + header_size + level * 24;
+			const uint64_t offset = read_u64_le(pEntry);
+			const uint64_t length = read_u64_le(pEntry + 8);
+			const ImageLevel& image_level = image.levels[level];
+			if (length != image_level.size || offset > size || length > size - offset) {
+				error = "bad KTX2 level " + std::to_string(level);
+				return false;
+			}
+			std::memcpy(image.data.data() + image_level.offset, pData + offset, image_level.size);
+		}
+		return true;
+	}
+
+	bool decode_image(const void* pData, const size_t size, Image& image, std::string& error) {
+
+		static const uint8_t png_signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+		image = Image();
+
+		bool result = false;
+		if (size >= sizeof(png_signature) && std::memcmp(pBytes, png_signature, sizeof(png_signature)) == 0) {
+			result = decode_png(pBytes, size, image, error);
+		}
+		else if (size >= sizeof(s_ktx2_identifier) && std::memcmp(pBytes, s_ktx2_identifier, sizeof(s_ktx2_identifier)) == 0) {
+			result = decode_ktx2(pBytes, size, image, error);
+		}
+		//У TGA нет сигнатуры - узнаём по типу картинки в заголовке
+		else if (size >= 18 && (pBytes[2] == 2 || pBytes[2] == 3 || pBytes[2] == 10 || pBytes[2] == 11)) {
+			result = decode_tga(pBytes, size, image, error);
+		}
+		else {
+			error = "unknown image format, expected PNG, TGA or KTX2";
+		}
+
+		if (!result)
+			image = Image();
+		return result;
+	}
+
+	bool generate_mips(Image& image) {
+
+		if (image.format != EImageFormat::RGBA8 || image.levels.size() != 1)
+			return false;
+
+		static float s_srgb_to_linear[256];
+		//Обратное преобразование по таблице: 4096 ступеней линейной яркости хватает для 8 бит sRGB
+		static uint8_t s_linear_to_srgb[4097];
+		static const bool s_tables_ready = [] {
+
+			for (int i = 0; i < 256; ++i) {
+				const float value = i / 255.f;
+				s_srgb_to_linear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+			}
+			for (int i = 0; i <= 4096; ++i) {
+				const float value = i / 4096.f;
+				const float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+				s_linear_to_srgb[i] = static_cast<uint8_t>(std::lround(std::clamp(srgb, 0.f, 1.f) * 255.f));
+			}
+			return true;
+		}();
+		(void)s_tables_ready;
+
+		const unsigned int levels_count = get_mip_levels_count(image.levels[0].width, image.levels[0].height);
+		size_t data_size = image.levels[0].size;
+		for (unsigned int level = 1; level < levels_count; ++level) {
+
+			ImageLevel image_level;
+			image_level.width = std::max(1u, image.levels[0].width >> level);
+			image_level.height = std::max(1u, image.levels[0].height >> level);
+			image_level.offset = data_size;
+			image_level.size = get_image_level_size(EImageFormat::RGBA8, image_level.width, image_level.height);
+			data_size += image_level.size;
+			image.levels.push_back(image_level);
+		}
+		image.data.resize(data_size);
+
+		for (unsigned int level = 1; level < levels_count; ++level) {
+
+			const ImageLevel& source = image.levels[level - 1];
+			const ImageLevel& target = image.levels[level];
+			const uint8_t* pSource = image.data.data() + source.offset;
+			uint8_t* pTarget = image.data.data() + target.offset;
+			for (uint32_t y = 0; y < target.height; ++y) {
+
+				//Сторона в 1 пиксель не делится - берём ту же строку/столбец дважды
+				const uint32_t y0 = std::min(y * 2, source.height - 1);
+				const uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+				for (uint32_t x = 0; x < target.width; ++x) {
+
+					const uint32_t x0 = std::min(x * 2, source.width - 1);
+					const uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+					const uint8_t* pPixels[4] = {
+						pSource + (static_cast<size_t>(y0) * source.width + x0) * 4, pSource + (static_cast<size_t>(y0) * source.width + x1) * 4,
+						pSource + (static_cast<size_t>(y1) * source.width + x0) * 4, pSource + (static_cast<size_t>(y1) * source.width + x1) * 4 };
+					uint8_t* pOutput = pTarget + (static_cast<size_t>(y) * target.width + x) * 4;
+
+					for (int channel = 0; channel < 3; ++channel) {
+						if (image.srgb) {
+							const float sum = s_srgb_to_linear[pPixels[0][channel]] + s_srgb_to_linear[pPixels[1][channel]]
+								+ s_srgb_to_linear[pPixels[2][channel]] + s_srgb_to_linear[pPixels[3][channel]];
+							pOutput[channel] = s_linear_to_srgb[static_cast<int>(sum * 1024.f + 0.5f)];
+						}
+						else {
+							pOutput[channel] = static_cast<uint8_t>((pPixels[0][channel] + pPixels[1][channel] + pPixels[2][channel] + pPixels[3][channel] + 2) / 4);
+						}
+					}
+					//Альфа линейна всегда
+					pOutput[3] = static_cast<uint8_t>((pPixels[0][3] + pPixels[1][3] + pPixels[2][3] + pPixels[3][3] + 2) / 4);
+				}
+			}
+		}
+		return true;
+	}
+}
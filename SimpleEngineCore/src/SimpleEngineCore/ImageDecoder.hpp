@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SimpleEngine {
+
+	enum class EImageFormat {
+
+		RGBA8,
+		BC1,//RGB, 8 байт на блок 4x4
+		BC1A,//BC1 с 1-битной альфой
+		BC3,//RGBA, 16 байт на блок
+		BC7//RGBA, 16 байт на блок
+	};
+
+	struct ImageLevel {
+
+		uint32_t width = 0;
+		uint32_t height = 0;
+		size_t offset = 0;//В Image::data
+		size_t size = 0;
+	};
+
+	//Декодированная картинка: уровни мипов подряд в data, levels[0] - самый подробный
+	struct Image {
+
+		EImageFormat format = EImageFormat::RGBA8;
+		bool srgb = true;
+		std::vector<ImageLevel> levels;
+		std::vector<uint8_t> data;
+
+		uint32_t get_width() const { return levels.empty() ? 0 : levels[0].width; }
+		uint32_t get_height() const { return levels.empty() ? 0 : levels[0].height; }
+	};
+
+	bool is_block_compressed(const EImageFormat format);
+	size_t get_image_level_size(const EImageFormat format, const uint32_t width, const uint32_t height);
+	//Полная цепочка до 1x1
+	unsigned int get_mip_levels_count(const uint32_t width, const uint32_t height);
+
+	//Формат по сигнатуре: PNG (8/16 бит, палитра, без interlace), TGA (truecolor/grayscale, RLE) или KTX2
+	//(RGBA8, BC1/BC3/BC7 без суперкомпрессии). Без GL - можно звать из рабочих потоков. Ошибка - в error
+	bool decode_image(const void* data, const size_t size, Image& image, std::string& error);
+
+	//Мипы для RGBA8 с одним уровнем: фильтр 2x2, для srgb усреднение в линейном пространстве - иначе мипы темнеют
+	bool generate_mips(Image& image);
+}
@@ -0,0 +1,122 @@
+#include "SimpleEngineCore/JobSystem.hpp"
+
+namespace SimpleEngine {
+
+	//Индекс очереди текущего рабочего потока; у потоков вне пула - ~0u
+	thread_local unsigned int t_worker_index = ~0u;
+	thread_local const JobSystem* t_pWorkerJobSystem = nullptr;
+
+	JobSystem::JobSystem(unsigned int workers_count) {
+
+		if (workers_count == 0) {
+
+			const unsigned int hardware_threads = std::thread::hardware_concurrency();
+			workers_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+		}
+
+		for (unsigned int i = 0; i <= workers_count; ++i) {
+			m_queues.push_back(std::make_unique<WorkerQueue>());
+		}
+		for (unsigned int i = 1; i <= workers_count; ++i) {
+			m_workers.emplace_back(&JobSystem::worker_loop, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem() {
+
+		{
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+			m_bStop = true;
+		}
+		m_wake_condition.notify_all();
+		for (std::thread& worker : m_workers) {
+			worker.join();
+		}
+	}
+
+	unsigned int JobSystem::get_current_thread_index() const {
+
+		//Чужие потоки (не основной и не из пула) кладут задачи в очередь основного
+		return t_pWorkerJobSystem == this ? t_worker_index : 0;
+	}
+
+	void JobSystem::push(const Job& job) {
+
+		job.pCounter->pending.fetch_add(1, std::memory_order_relaxed);
+		//Счётчик меняем под мьютексом сна, иначе рабочий может проверить его и уснуть, пропустив notify.
+		//И до того, как задача попадёт в очередь, чтобы чужой fetch_sub не увёл его ниже нуля
+		{
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+			m_queued_jobs.fetch_add(1, std::memory_order_relaxed);
+		}
+		{
+			WorkerQueue& queue = *m_queues[get_current_thread_index()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(job);
+		}
+		m_wake_condition.notify_one();
+	}
+
+	bool JobSystem::try_execute_one(const unsigned int thread_index) {
+
+		Job job;
+		bool found = false;
+		{
+			WorkerQueue& own_queue = *m_queues[thread_index];
+			std::lock_guard<std::mutex> lock(own_queue.mutex);
+			if (!own_queue.jobs.empty()) {
+				job = own_queue.jobs.back();
+				own_queue.jobs.pop_back();
+				found = true;
+			}
+		}
+
+		//Кража: начинаем с соседа, чтобы потоки не ломились в одну очередь
+		const size_t queues_count = m_queues.size();
+		for (size_t offset = 1; !found && offset < queues_count; ++offset) {
+
+			WorkerQueue& victim_queue = *m_queues[(thread_index + offset) % queues_count];
+			std::lock_guard<std::mutex> lock(victim_queue.mutex);
+			if (!victim_queue.jobs.empty()) {
+				job = victim_queue.jobs.front();
+				victim_queue.jobs.pop_front();
+				found = true;
+			}
+		}
+
+		if (!found)
+			return false;
+
+		m_queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+		job.function(job.pData, job.begin, job.end);
+		job.pCounter->pending.fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	void JobSystem::wait(JobCounter& counter) {
+
+		const unsigned int thread_index = get_current_thread_index();
+		while (counter.pending.load(std::memory_order_acquire) > 0) {
+
+			//Остаток задач уже выполняется в других потоках
+			if (!try_execute_one(thread_index))
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::worker_loop(const unsigned int thread_index) {
+
+		t_worker_index = thread_index;
+		t_pWorkerJobSystem = this;
+		while (true) {
+
+			if (try_execute_one(thread_index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleep_mutex);
+			m_wake_condition.wait(lock, [this] { return m_bStop || m_queued_jobs.load(std::memory_order_relaxed) > 0; });
+			if (m_bStop)
+				return;
+		}
+	}
+}
@@ -0,0 +1,272 @@
+#include "Json.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace SimpleEngine {
+
+	//Рекурсивный спуск; глубина ограничена, чтобы битый файл не сорвал стек
+	class JsonParser {
+	public:
+		JsonParser(const char* begin, const char* end) : m_pCurrent(begin), m_pBegin(begin), m_pEnd(end) {}
+
+		bool parse_document(JsonValue& value) {
+
+			if (!parse_value(value, 0))
+				return false;
+			skip_spaces();
+			return m_pCurrent == m_pEnd || fail("unexpected data after the document");
+		}
+
+		const std::string& get_error() const { return m_error; }
+
+	private:
+		static constexpr unsigned int max_depth = 256;
+
+		bool fail(const char* reason) {
+
+			if (m_error.empty())
+				m_error = std::string(reason) + " at offset " + std::to_string(m_pCurrent - m_pBegin);
+			return false;
+		}
+
+		void skip_spaces() {
+
+			while (m_pCurrent < m_pEnd && (*m_pCurrent == ' ' || *m_pCurrent == '\t' || *m_pCurrent == '\n' || *m_pCurrent == '\r'))
+				++m_pCurrent;
+		}
+
+		bool match(const char* literal) {
+
+			const size_t length = std::strlen(literal);
+			if (static_cast<size_t>(m_pEnd - m_pCurrent) < length || std::memcmp(m_pCurrent, literal, length) != 0)
+				return false;
+			m_pCurrent += length;
+			return true;
+		}
+
+		bool parse_value(JsonValue& value, const unsigned int depth) {
+
+			if (depth > max_depth)
+				return fail("nesting is too deep");
+			skip_spaces();
+			if (m_pCurrent == m_pEnd)
+				return fail("unexpected end");
+
+			switch (*m_pCurrent) {
+				case '{': return parse_object(value, depth);
+				case '[': return parse_array(value, depth);
+				case '"':
+					value.m_type = JsonValue::EType::String;
+					return parse_string(value.m_string);
+				case 't':
+				case 'f':
+					value.m_type = JsonValue::EType::Bool;
+					value.m_bool = *m_pCurrent == 't';
+					return match(value.m_bool ? "true" : "false") || fail("invalid literal");
+				case 'n':
+					value.m_type = JsonValue::EType::Null;
+					return match("null") || fail("invalid literal");
+				default:
+					return parse_number(value);
+			}
+		}
+
+		bool parse_number(JsonValue& value) {
+
+			//from_chars не зависит от локали (strtod с LC_NUMERIC=ru_RU остановился бы на '.') и не требует нуля в конце.
+			//Символы ограничены заранее - inf, nan и hex JSON не разрешает
+			size_t length = 0;
+			while (m_pCurrent + length < m_pEnd && m_pCurrent[length] != '\0' && std::strchr("+-0123456789.eE", m_pCurrent[length]))
+				++length;
+			if (length == 0)
+				return fail("unexpected character");
+
+			value.m_type = JsonValue::EType::Number;
+			const std::from_chars_result result = std::from_chars(m_pCurrent, m_pCurrent + length, value.m_number);
+			if (result.ec == std::errc::result_out_of_range)
+				return fail("number is out of range");
+			if (result.ec != std::errc() || result.ptr != m_pCurrent + length)
+				return fail("invalid number");
+			m_pCurrent += length;
+			return true;
+		}
+
+		static void append_utf8(std::string& string, const unsigned int code_point) {
+
+			if (code_point < 0x80) {
+				string += static_cast<char>(code_point);
+			}
+			else if (code_point < 0x800) {
+				string += static_cast<char>(0xC0 | (code_point >> 6));
+				string += static_cast<char>(0x80 | (code_point & 0x3F));
+			}
+			else {
+				string += static_cast<char>(0xE0 | (code_point >> 12));
+				string += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+				string += static_cast<char>(0x80 | (code_point & 0x3F));
+			}
+		}
+
+		bool parse_string(std::string& string) {
+
+			++m_pCurrent;//"
+			string.clear();
+			while (m_pCurrent < m_pEnd && *m_pCurrent != '"') {
+
+				if (*m_pCurrent != '\\') {
+					string += *m_pCurrent++;
+					continue;
+				}
+
+				if (++m_pCurrent == m_pEnd)
+					break;
+				const char escaped = *m_pCurrent++;
+				switch (escaped) {
+					case 'b': string += '\b'; break;
+					case 'f': string += '\f'; break;
+					case 'n': string += '\n'; break;
+					case 'r': string += '\r'; break;
+					case 't': string += '\t'; break;
+					case 'u': {
+						if (m_pEnd - m_pCurrent < 4)
+							return fail("invalid escape");
+						const std::string hex(m_pCurrent, 4);
+						char* pHexEnd = nullptr;
+						const unsigned long code_point = std::strtoul(hex.c_str(), &pHexEnd, 16);
+						if (pHexEnd != hex.c_str() + 4)
+							return fail("invalid escape");
+						append_utf8(string, static_cast<unsigned int>(code_point));
+						m_pCurrent += 4;
+						break;
+					}
+					default: string += escaped; break;
+				}
+			}
+			if (m_pCurrent == m_pEnd)
+				return fail("unterminated string");
+			++m_pCurrent;//"
+			return true;
+		}
+
+		bool parse_array(JsonValue& value, const unsigned int depth) {
+
+			++m_pCurrent;//[
+			value.m_type = JsonValue::EType::Array;
+			skip_spaces();
+			if (m_pCurrent < m_pEnd && *m_pCurrent == ']') {
+				++m_pCurrent;
+				return true;
+			}
+
+			while (true) {
+
+				value.m_array.emplace_back();
+				if (!parse_value(value.m_array.back(), depth + 1))
+					return false;
+				skip_spaces();
+				if (m_pCurrent == m_pEnd)
+					return fail("unterminated array");
+				if (*m_pCurrent++ == ']')
+					return true;
+				if (m_pCurrent[-1] != ',')
+					return fail("expected ',' or ']'");
+			}
+		}
+
+		bool parse_object(JsonValue& value, const unsigned int depth) {
+
+			++m_pCurrent;//{
+			value.m_type = JsonValue::EType::Object;
+			skip_spaces();
+			if (m_pCurrent < m_pEnd && *m_pCurrent == '}') {
+				++m_pCurrent;
+				return true;
+			}
+
+			while (true) {
+
+				skip_spaces();
+				if (m_pCurrent == m_pEnd || *m_pCurrent != '"')
+					return fail("expected a key");
+				value.m_object.emplace_back();
+				if (!parse_string(value.m_object.back().first))
+					return false;
+				skip_spaces();
+				if (m_pCurrent == m_pEnd || *m_pCurrent++ != ':')
+					return fail("expected ':'");
+				if (!parse_value(value.m_object.back().second, depth + 1))
+					return false;
+				skip_spaces();
+				if (m_pCurrent == m_pEnd)
+					return fail("unterminated object");
+				if (*m_pCurrent++ == '}')
+					return true;
+				if (m_pCurrent[-1] != ',')
+					return fail("expected ',' or '}'");
+			}
+		}
+
+		const char* m_pCurrent;
+		const char* m_pBegin;
+		const char* m_pEnd;
+		std::string m_error;
+	};
+
+	bool JsonValue::parse(const char* begin, const char* end, JsonValue& value, std::string& error) {
+
+		value = JsonValue();
+		JsonParser parser(begin, end);
+		if (parser.parse_document(value))
+			return true;
+		error = parser.get_error();
+		return false;
+	}
+
+	const JsonValue* JsonValue::find(const char* key) const {
+
+		for (const std::pair<std::string, JsonValue>& member : m_object) {
+			if (member.first == key)
+				return &member.second;
+		}
+		return nullptr;
+	}
+
+	double JsonValue::get_number(const char* key, const double default_value) const {
+
+		const JsonValue* pValue = find(key);
+		return pValue ? pValue->get_number(default_value) : default_value;
+	}
+
+	bool JsonValue::get_unsigned(size_t& value) const {
+
+		//Дальше 2^53 double не различает соседние целые
+		constexpr double max_exact_integer = 9007199254740992.0;
+		if (m_type != EType::Number || !(m_number >= 0.0) || m_number > max_exact_integer || std::floor(m_number) != m_number)
+			return false;
+		const uint64_t number = static_cast<uint64_t>(m_number);
+		if (number > static_cast<uint64_t>(~static_cast<size_t>(0)))
+			return false;
+		value = static_cast<size_t>(number);
+		return true;
+	}
+
+	bool JsonValue::get_unsigned(const char* key, size_t& value, const size_t default_value) const {
+
+		const JsonValue* pValue = find(key);
+		if (!pValue) {
+			value = default_value;
+			return true;
+		}
+		return pValue->get_unsigned(value);
+	}
+
+	const std::string& JsonValue::get_string(const char* key) const {
+
+		static const std::string empty_string;
+		const JsonValue* pValue = find(key);
+		return pValue && pValue->m_type == EType::String ? pValue->m_string : empty_string;
+	}
+}
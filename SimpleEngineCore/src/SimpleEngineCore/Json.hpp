@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Минимальное дерево JSON для форматов ассетов (glTF): без потоковой записи и без \u вне BMP
+	class JsonValue {
+	public:
+		enum class EType {
+
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+		//error - причина и смещение в тексте, если разбор не удался
+		static bool parse(const char* begin, const char* end, JsonValue& value, std::string& error);
+
+		EType get_type() const { return m_type; }
+		bool is_object() const { return m_type == EType::Object; }
+		bool is_array() const { return m_type == EType::Array; }
+
+		//nullptr, если ключа нет или значение не объект
+		const JsonValue* find(const char* key) const;
+		size_t get_size() const { return m_array.size(); }
+		const JsonValue& operator[](const size_t index) const { return m_array[index]; }
+
+		double get_number(const double default_value = 0.0) const { return m_type == EType::Number ? m_number : default_value; }
+		bool get_bool(const bool default_value = false) const { return m_type == EType::Bool ? m_bool : default_value; }
+		const std::string& get_string() const { return m_string; }
+
+		//Неотрицательное целое (индекс, размер, смещение): дробное, отрицательное, NaN или больше 2^53 - false,
+		//чтобы не приводить такое число к size_t
+		bool get_unsigned(size_t& value) const;
+
+		//Сокращения для полей объекта
+		double get_number(const char* key, const double default_value) const;
+		//Ключа нет - default_value и true
+		bool get_unsigned(const char* key, size_t& value, const size_t default_value) const;
+		const std::string& get_string(const char* key) const;
+
+	private:
+		friend class JsonParser;
+
+		EType m_type = EType::Null;
+		bool m_bool = false;
+		double m_number = 0.0;
+		std::string m_string;
+		std::vector<JsonValue> m_array;
+		std::vector<std::pair<std::string, JsonValue>> m_object;
+	};
+}
@@ -0,0 +1,45 @@
+#include "SimpleEngineCore/Lod.hpp"
+#include "SimpleEngineCore/Camera.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace SimpleEngine {
+
+	float get_lod_pixel_scale(const Camera& camera, const float viewport_height) {
+
+		//[1][1] - масштаб по вертикали в NDC, а NDC [-1, 1] занимает viewport_height пикселей
+		return camera.get_projection_matrix()[1][1] * viewport_height * 0.5f;
+	}
+
+	float get_projected_radius(const Camera& camera, const float pixel_scale, const float radius, const float distance) {
+
+		//У перспективной проекции w = -z вида, у ортографической [2][3] == 0 и размер от расстояния не зависит
+		if (camera.get_projection_matrix()[2][3] == 0.f)
+			return pixel_scale * radius;
+		//Камера внутри сферы - объект во весь экран
+		if (distance <= radius)
+			return std::numeric_limits<float>::max();
+		return pixel_scale * radius / distance;
+	}
+
+	unsigned int select_lod(const MeshLod* pLods, const unsigned int lods_count, const unsigned int current_lod,
+							const float projected_radius, const LodSettings& settings) {
+
+		if (!settings.enabled || lods_count == 0)
+			return 0;
+
+		unsigned int lod = std::min(current_lod, lods_count - 1);
+		//Текущий уровень уже заметен - сразу на нужный подробный, без гистерезиса: качество важнее
+		if (pLods[lod].error * projected_radius > settings.max_pixel_error) {
+			while (lod > 0 && pLods[lod].error * projected_radius > settings.max_pixel_error)
+				--lod;
+			return lod;
+		}
+
+		const float coarser_threshold = settings.max_pixel_error * (1.f - settings.hysteresis);
+		while (lod + 1 < lods_count && pLods[lod + 1].error * projected_radius <= coarser_threshold)
+			++lod;
+		return lod;
+	}
+}
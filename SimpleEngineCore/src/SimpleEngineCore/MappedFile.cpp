@@ -0,0 +1,141 @@
+#include "MappedFile.hpp"
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SimpleEngine {
+
+	MappedFile::~MappedFile() {
+
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& mapped_file) noexcept {
+
+		*this = std::move(mapped_file);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& mapped_file) noexcept {
+
+		if (this != &mapped_file) {
+
+			close();
+			std::swap(m_pData, mapped_file.m_pData);
+			std::swap(m_size, mapped_file.m_size);
+#ifdef _WIN32
+			std::swap(m_file_handle, mapped_file.m_file_handle);
+			std::swap(m_mapping_handle, mapped_file.m_mapping_handle);
+#endif
+		}
+		return *this;
+	}
+
+#ifdef _WIN32
+
+	bool MappedFile::open(const std::string& path) {
+
+		close();
+		HANDLE file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_handle == INVALID_HANDLE_VALUE) {
+
+			std::cerr << "MappedFile: can't open " << path << "\n";
+			return false;
+		}
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+
+			std::cerr << "MappedFile: " << path << " is empty\n";
+			CloseHandle(file_handle);
+			return false;
+		}
+
+		HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* pData = mapping_handle ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (!pData) {
+
+			std::cerr << "MappedFile: can't map " << path << "\n";
+			if (mapping_handle)
+				CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+			return false;
+		}
+
+		m_pData = pData;
+		m_size = static_cast<size_t>(file_size.QuadPart);
+		m_file_handle = file_handle;
+		m_mapping_handle = mapping_handle;
+		return true;
+	}
+
+	void MappedFile::close() {
+
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+		if (m_mapping_handle)
+			CloseHandle(m_mapping_handle);
+		if (m_file_handle)
+			CloseHandle(m_file_handle);
+		m_pData = nullptr;
+		m_size = 0;
+		m_file_handle = nullptr;
+		m_mapping_handle = nullptr;
+	}
+
+#else
+
+	bool MappedFile::open(const std::string& path) {
+
+		close();
+		const int file_descriptor = ::open(path.c_str(), O_RDONLY);
+		if (file_descriptor < 0) {
+
+			std::cerr << "MappedFile: can't open " << path << "\n";
+			return false;
+		}
+
+		struct stat file_stat;
+		if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size == 0) {
+
+			std::cerr << "MappedFile: " << path << " is empty\n";
+			::close(file_descriptor);
+			return false;
+		}
+
+		const size_t size = static_cast<size_t>(file_stat.st_size);
+		void* pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+		//Отображение держит файл само, дескриптор больше не нужен
+		::close(file_descriptor);
+		if (pData == MAP_FAILED) {
+
+			std::cerr << "MappedFile: can't map " << path << "\n";
+			return false;
+		}
+
+		//Файл читается один раз от начала к концу - пусть ОС читает наперёд
+		madvise(pData, size, MADV_SEQUENTIAL);
+		m_pData = pData;
+		m_size = size;
+		return true;
+	}
+
+	void MappedFile::close() {
+
+		if (m_pData)
+			munmap(const_cast<void*>(m_pData), m_size);
+		m_pData = nullptr;
+		m_size = 0;
+	}
+
+#endif
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace SimpleEngine {
+
+	//Файл, отображённый в память только для чтения: страницы подгружаются ОС по первому обращению,
+	//поэтому данные можно отдавать прямо в glBufferData без промежуточного буфера
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& mapped_file) noexcept;
+		MappedFile& operator=(MappedFile&& mapped_file) noexcept;
+
+		//Пустой файл тоже ошибка - отображать нечего
+		bool open(const std::string& path);
+		void close();
+
+		bool is_open() const { return m_pData != nullptr; }
+		const void* get_data() const { return m_pData; }
+		size_t get_size() const { return m_size; }
+
+	private:
+		const void* m_pData = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file_handle = nullptr;
+		void* m_mapping_handle = nullptr;
+#endif
+	};
+}
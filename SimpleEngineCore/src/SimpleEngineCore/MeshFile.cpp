@@ -0,0 +1,253 @@
+#include "MeshFile.hpp"
+#include "MeshOptimizer.hpp"
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace SimpleEngine {
+
+	static_assert(sizeof(MeshFileHeader) == 336, "MeshFileHeader is a file format - its size must not change");
+	//Заголовок версии 1 заканчивался перед таблицей LOD'ов
+	constexpr size_t mesh_file_header_v1_size = offsetof(MeshFileHeader, lods);
+
+	static uint64_t align_offset(const uint64_t offset) {
+
+		return (offset + mesh_file_data_alignment - 1) / mesh_file_data_alignment * mesh_file_data_alignment;
+	}
+
+	//Индексы выровнены по mesh_file_data_alignment, их можно читать прямо из отображения
+	template<typename Index>
+	static bool indexes_fit(const void* indexes, const size_t indexes_count, const uint64_t vertices_count) {
+
+		const Index* pIndexes = static_cast<const Index*>(indexes);
+		Index max_index = 0;
+		for (size_t i = 0; i < indexes_count; ++i)
+			max_index = std::max(max_index, pIndexes[i]);
+		return indexes_count == 0 || max_index < vertices_count;
+	}
+
+	bool MeshFile::open(const std::string& path) {
+
+		close();
+		if (!m_mapped_file.open(path))
+			return false;
+
+		const size_t file_size = m_mapped_file.get_size();
+		const MeshFileHeader* pHeader = static_cast<const MeshFileHeader*>(m_mapped_file.get_data());
+		const auto fail = [&](const char* reason) {
+
+			std::cerr << "MeshFile: " << path << ": " << reason << "\n";
+			m_mapped_file.close();
+			return false;
+		};
+
+		if (file_size < mesh_file_header_v1_size || pHeader->magic != MeshFileHeader::magic_value)
+			return fail("not a mesh file");
+		if (pHeader->version != 1 && pHeader->version != MeshFileHeader::current_version)
+			return fail("unsupported version");
+		const size_t header_size = pHeader->version == 1 ? mesh_file_header_v1_size : sizeof(MeshFileHeader);
+		if (file_size < header_size)
+			return fail("not a mesh file");
+		if (pHeader->elements_count == 0 || pHeader->elements_count > MeshFileHeader::max_elements || (pHeader->index_size != sizeof(uint16_t) && pHeader->index_size != sizeof(uint32_t)))
+			return fail("unsupported layout");
+
+		size_t stride = 0;
+		for (uint32_t i = 0; i < pHeader->elements_count; ++i) {
+
+			if (pHeader->elements[i].type > static_cast<uint32_t>(ShaderDataType::UShort2N))
+				return fail("unknown attribute type");
+			stride += BufferElement(static_cast<ShaderDataType>(pHeader->elements[i].type)).size;
+		}
+		if (stride != pHeader->vertex_stride)
+			return fail("vertex stride doesn't match the layout");
+
+		if (pHeader->vertex_data_offset % mesh_file_data_alignment != 0 || pHeader->index_data_offset % mesh_file_data_alignment != 0
+			|| pHeader->vertex_data_offset < header_size || pHeader->vertex_data_offset > file_size || pHeader->index_data_offset > file_size)
+			return fail("data blocks don't fit into the file");
+		//Делением, а не умножением: огромные счётчики из битого файла не переполнят произведение
+		if (pHeader->vertices_count > (file_size - pHeader->vertex_data_offset) / pHeader->vertex_stride
+			|| pHeader->indexes_count > (file_size - pHeader->index_data_offset) / pHeader->index_size)
+			return fail("data blocks don't fit into the file");
+		if (pHeader->index_data_offset < pHeader->vertex_data_offset + pHeader->vertices_count * pHeader->vertex_stride
+			&& pHeader->vertex_data_offset < pHeader->index_data_offset + pHeader->indexes_count * pHeader->index_size)
+			return fail("vertex and index blocks overlap");
+
+		if (pHeader->version >= 2) {
+
+			if (pHeader->lods_count == 0 || pHeader->lods_count > MeshFileHeader::max_lods)
+				return fail("invalid LOD count");
+			for (uint32_t i = 0; i < pHeader->lods_count; ++i) {
+
+				const MeshFileHeader::Lod& lod = pHeader->lods[i];
+				if (lod.first_index > pHeader->indexes_count || lod.indexes_count > pHeader->indexes_count - lod.first_index || lod.indexes_count % 3 != 0)
+					return fail("LOD range doesn't fit into the indexes");
+			}
+		}
+
+		//Файлу не доверяем: индекс за пределами вершин - чтение чужой памяти на GPU и в коде, обходящем меш на CPU.
+		//Один проход по индексам без ветвлений, векторизуется
+		const void* pIndexes = static_cast<const uint8_t*>(m_mapped_file.get_data()) + pHeader->index_data_offset;
+		const size_t indexes_count = static_cast<size_t>(pHeader->indexes_count);
+		if (pHeader->index_size == sizeof(uint16_t) ? !indexes_fit<uint16_t>(pIndexes, indexes_count, pHeader->vertices_count)
+													: !indexes_fit<uint32_t>(pIndexes, indexes_count, pHeader->vertices_count))
+			return fail("index is out of the vertices");
+
+		m_pHeader = pHeader;
+		return true;
+	}
+
+	void MeshFile::close() {
+
+		m_pHeader = nullptr;
+		m_mapped_file.close();
+	}
+
+	BufferLayout MeshFile::get_layout() const {
+
+		std::vector<BufferElement> elements;
+		elements.reserve(m_pHeader->elements_count);
+		for (uint32_t i = 0; i < m_pHeader->elements_count; ++i) {
+			elements.emplace_back(static_cast<ShaderDataType>(m_pHeader->elements[i].type), m_pHeader->elements[i].divisor);
+		}
+		return BufferLayout(std::move(elements));
+	}
+
+	const void* MeshFile::get_vertex_data() const {
+
+		return static_cast<const uint8_t*>(m_mapped_file.get_data()) + m_pHeader->vertex_data_offset;
+	}
+
+	const void* MeshFile::get_indexes() const {
+
+		return static_cast<const uint8_t*>(m_mapped_file.get_data()) + m_pHeader->index_data_offset;
+	}
+
+	std::vector<MeshLod> MeshFile::get_lods() const {
+
+		if (m_pHeader->version == 1)
+			return { MeshLod{ 0, static_cast<uint32_t>(m_pHeader->indexes_count), 0.f } };
+
+		std::vector<MeshLod> lods(m_pHeader->lods_count);
+		for (uint32_t i = 0; i < m_pHeader->lods_count; ++i)
+			lods[i] = { m_pHeader->lods[i].first_index, m_pHeader->lods[i].indexes_count, m_pHeader->lods[i].error };
+		return lods;
+	}
+
+	glm::vec3 MeshFile::get_bounds_center() const {
+
+		return glm::vec3(m_pHeader->bounds_center[0], m_pHeader->bounds_center[1], m_pHeader->bounds_center[2]);
+	}
+
+	bool MeshFile::write(const std::string& path, const BufferLayout& buffer_layout, const void* vertices, const size_t vertices_count,
+						 const void* indexes, const size_t indexes_count, const size_t index_size, const std::vector<MeshLod>& lods) {
+
+		const std::vector<BufferElement>& elements = buffer_layout.get_elements();
+		if (elements.empty() || elements.size() > MeshFileHeader::max_elements) {
+
+			std::cerr << "MeshFile::write: " << elements.size() << " attributes, 1.." << MeshFileHeader::max_elements << " supported\n";
+			return false;
+		}
+		if (index_size != sizeof(uint16_t) && index_size != sizeof(uint32_t)) {
+
+			std::cerr << "MeshFile::write: " << index_size << "-byte indexes, 2 or 4 supported\n";
+			return false;
+		}
+		if (lods.size() > MeshFileHeader::max_lods) {
+
+			std::cerr << "MeshFile::write: " << lods.size() << " LODs, up to " << MeshFileHeader::max_lods << " supported\n";
+			return false;
+		}
+		for (const MeshLod& lod : lods) {
+
+			if (lod.first_index > indexes_count || lod.indexes_count > indexes_count - lod.first_index || lod.indexes_count % 3 != 0) {
+
+				std::cerr << "MeshFile::write: LOD [" << lod.first_index << ", +" << lod.indexes_count << ") doesn't fit into " << indexes_count << " indexes\n";
+				return false;
+			}
+		}
+
+		MeshFileHeader header;
+		std::memset(&header, 0, sizeof(header));
+		header.magic = MeshFileHeader::magic_value;
+		header.version = MeshFileHeader::current_version;
+		header.elements_count = static_cast<uint32_t>(elements.size());
+		header.vertex_stride = static_cast<uint32_t>(buffer_layout.get_stride());
+		header.vertices_count = vertices_count;
+		header.indexes_count = indexes_count;
+		header.index_size = static_cast<uint32_t>(index_size);
+		header.vertex_data_offset = align_offset(sizeof(MeshFileHeader));
+		header.index_data_offset = align_offset(header.vertex_data_offset + vertices_count * buffer_layout.get_stride());
+		for (size_t i = 0; i < elements.size(); ++i) {
+			header.elements[i] = { static_cast<uint32_t>(elements[i].type), elements[i].divisor };
+		}
+		header.lods_count = lods.empty() ? 1 : static_cast<uint32_t>(lods.size());
+		header.lods[0] = { 0, static_cast<uint32_t>(indexes_count), 0.f, 0 };
+		for (size_t i = 0; i < lods.size(); ++i) {
+			header.lods[i] = { lods[i].first_index, lods[i].indexes_count, lods[i].error, 0 };
+		}
+
+		//Ограничивающая сфера - по позициям, если они первым атрибутом: центр коробки и самая дальняя вершина
+		const bool half_positions = elements[0].type == ShaderDataType::Half4;
+		if ((elements[0].type == ShaderDataType::Float3 || half_positions) && vertices_count > 0) {
+
+			const uint8_t* pVertices = static_cast<const uint8_t*>(vertices);
+			const auto position = [&](const size_t vertex) {
+
+				const uint8_t* pPosition = pVertices + vertex * buffer_layout.get_stride() + elements[0].offset;
+				glm::vec3 result;
+				if (half_positions) {
+					uint16_t halfs[3];
+					std::memcpy(halfs, pPosition, sizeof(halfs));
+					return glm::vec3(half_to_float(halfs[0]), half_to_float(halfs[1]), half_to_float(halfs[2]));
+				}
+				std::memcpy(&result, pPosition, sizeof(result));
+				return result;
+			};
+
+			glm::vec3 min = position(0);
+			glm::vec3 max = min;
+			for (size_t i = 1; i < vertices_count; ++i) {
+
+				min = glm::min(min, position(i));
+				max = glm::max(max, position(i));
+			}
+			const glm::vec3 center = (min + max) * 0.5f;
+			float radius_squared = 0.f;
+			for (size_t i = 0; i < vertices_count; ++i) {
+
+				const glm::vec3 offset = position(i) - center;
+				radius_squared = std::max(radius_squared, glm::dot(offset, offset));
+			}
+			header.bounds_center[0] = center.x;
+			header.bounds_center[1] = center.y;
+			header.bounds_center[2] = center.z;
+			header.bounds_radius = std::sqrt(radius_squared);
+		}
+
+		std::ofstream stream(path, std::ios::binary);
+		if (!stream) {
+
+			std::cerr << "MeshFile::write: can't create " << path << "\n";
+			return false;
+		}
+
+		const char padding[mesh_file_data_alignment] = {};
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(padding, header.vertex_data_offset - sizeof(header));
+		stream.write(static_cast<const char*>(vertices), vertices_count * buffer_layout.get_stride());
+		stream.write(padding, header.index_data_offset - header.vertex_data_offset - vertices_count * buffer_layout.get_stride());
+		stream.write(static_cast<const char*>(indexes), indexes_count * index_size);
+		if (!stream) {
+
+			std::cerr << "MeshFile::write: failed to write " << path << "\n";
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "SimpleEngineCore/MappedFile.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Бинарный меш .semesh (little-endian): заголовок, вершины в раскладке из заголовка, индексы.
+	//Блоки выровнены по mesh_file_data_alignment от начала файла - отображённые данные идут в GL как есть
+	struct MeshFileHeader {
+
+		static constexpr uint32_t magic_value = 0x4853454D;//"MESH"
+		static constexpr uint32_t current_version = 2;//1 - без таблицы LOD'ов, читается как один уровень
+		static constexpr uint32_t max_elements = 16;
+		static constexpr uint32_t max_lods = 8;
+
+		struct Element {
+
+			uint32_t type;//ShaderDataType
+			uint32_t divisor;
+		};
+
+		struct Lod {
+
+			uint32_t first_index;
+			uint32_t indexes_count;
+			float error;
+			uint32_t reserved;
+		};
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t elements_count;
+		uint32_t vertex_stride;
+		uint64_t vertices_count;
+		uint64_t indexes_count;
+		uint64_t vertex_data_offset;
+		uint64_t index_data_offset;
+		uint32_t index_size;//Байт на индекс: 2 или 4
+		float bounds_center[3];//Сфера по первому атрибуту Float3 или Half4, иначе нулевая
+		float bounds_radius;
+		uint32_t lods_count;//С версии 2
+		uint32_t reserved[2];
+		Element elements[max_elements];
+		Lod lods[max_lods];//С версии 2, от подробного к грубому
+	};
+
+	constexpr size_t mesh_file_data_alignment = 64;
+
+	//Меш, прочитанный через отображение файла: указатели ведут прямо в файл и живут, пока жив MeshFile
+	class MeshFile {
+	public:
+		//Заголовок проверяется целиком: размеры блоков, раскладка и stride должны сходиться с размером файла,
+		//а все индексы - указывать на существующие вершины
+		bool open(const std::string& path);
+		void close();
+		bool is_open() const { return m_pHeader != nullptr; }
+
+		BufferLayout get_layout() const;
+		const void* get_vertex_data() const;
+		size_t get_vertex_data_size() const { return static_cast<size_t>(m_pHeader->vertices_count) * m_pHeader->vertex_stride; }
+		size_t get_vertices_count() const { return static_cast<size_t>(m_pHeader->vertices_count); }
+		const void* get_indexes() const;
+		size_t get_indexes_count() const { return static_cast<size_t>(m_pHeader->indexes_count); }
+		size_t get_index_size() const { return m_pHeader->index_size; }
+		glm::vec3 get_bounds_center() const;
+		float get_bounds_radius() const { return m_pHeader->bounds_radius; }
+		//Хотя бы один уровень: у файлов без LOD'ов - все индексы с нулевой ошибкой
+		std::vector<MeshLod> get_lods() const;
+
+		//lods - диапазоны indexes от подробного к грубому; пустой - один уровень из всех индексов
+		static bool write(const std::string& path, const BufferLayout& buffer_layout, const void* vertices, const size_t vertices_count,
+						  const void* indexes, const size_t indexes_count, const size_t index_size = sizeof(uint32_t),
+						  const std::vector<MeshLod>& lods = {});
+
+	private:
+		MappedFile m_mapped_file;
+		const MeshFileHeader* m_pHeader = nullptr;
+	};
+}
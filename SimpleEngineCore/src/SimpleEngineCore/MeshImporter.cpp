@@ -0,0 +1,931 @@
+#include "MeshImporter.hpp"
+#include "MappedFile.hpp"
+#include "Json.hpp"
+#include "Timing.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	template<typename Func>
+	void MeshImporter::parallel_for(const uint32_t count, const uint32_t grain, Func&& func) {
+
+		if (m_pJobSystem)
+			m_pJobSystem->parallel_for(count, grain, std::forward<Func>(func));
+		else if (count > 0)
+			func(0u, count);
+	}
+
+	void MeshImporter::track_memory(const size_t bytes) {
+
+		m_statistics.peak_memory_bytes = std::max(m_statistics.peak_memory_bytes, bytes);
+	}
+
+	template<typename T>
+	static size_t get_memory(const std::vector<T>& vector) {
+
+		return vector.capacity() * sizeof(T);
+	}
+
+	static void set_layout(ImportedMesh& mesh, const bool has_uvs) {
+
+		mesh.has_uvs = has_uvs;
+		mesh.buffer_layout = has_uvs
+			? BufferLayout{ ShaderDataType::Float3, ShaderDataType::Float3, ShaderDataType::Float2 }
+			: BufferLayout{ ShaderDataType::Float3, ShaderDataType::Float3 };
+	}
+
+	static void write_vertex(uint8_t* pVertex, const bool has_uvs, const float* position, glm::vec3 normal, const float* uv) {
+
+		if (glm::dot(normal, normal) > 0.f)
+			normal = glm::normalize(normal);
+		const float values[8] = { position[0], position[1], position[2], normal.x, normal.y, normal.z, uv ? uv[0] : 0.f, uv ? uv[1] : 0.f };
+		std::memcpy(pVertex, values, (has_uvs ? 8 : 6) * sizeof(float));
+	}
+
+	bool MeshImporter::import(const std::string& path, ImportedMesh& mesh) {
+
+		m_statistics = Statistics();
+		m_statistics.threads_count = m_pJobSystem ? m_pJobSystem->get_threads_count() : 1;
+		mesh = ImportedMesh();
+
+		const size_t extension_position = path.find_last_of('.');
+		std::string extension = extension_position == std::string::npos ? std::string() : path.substr(extension_position + 1);
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](const char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+		const auto start_time = std::chrono::steady_clock::now();
+		bool result = false;
+		if (extension == "obj") {
+			result = import_obj(path, mesh);
+		}
+		else if (extension == "gltf") {
+			result = import_gltf(path, mesh);
+		}
+		else {
+			std::cerr << "MeshImporter: " << path << ": unsupported format, expected .obj or .gltf\n";
+		}
+
+		m_statistics.import_ms = milliseconds_since(start_time);
+		if (m_statistics.import_ms > 0.0)
+			m_statistics.megabytes_per_second = m_statistics.bytes_parsed / (1024.0 * 1024.0) / (m_statistics.import_ms / 1000.0);
+		if (!result)
+			mesh = ImportedMesh();
+		return result;
+	}
+
+	//----------------------------------------------------------------------------------------------------//
+	// OBJ
+
+	struct ObjCorner {
+
+		int32_t position;
+		int32_t uv;
+		int32_t normal;
+	};
+
+	//Отрицательные индексы OBJ считаются от конца уже прочитанного - до prefix-суммы по кускам
+	//они известны только относительно начала куска
+	enum ObjRelativeFlags : uint8_t {
+
+		RelativePosition = 1,
+		RelativeUv = 2,
+		RelativeNormal = 4
+	};
+
+	struct ObjChunk {
+
+		const char* begin;
+		const char* end;
+		std::vector<float> positions;
+		std::vector<float> uvs;
+		std::vector<float> normals;
+		std::vector<ObjCorner> corners;//По три на треугольник
+		std::vector<uint8_t> relative_flags;
+		uint32_t positions_base = 0;
+		uint32_t uvs_base = 0;
+		uint32_t normals_base = 0;
+		unsigned int malformed_lines = 0;
+		bool has_uvs = false;
+		bool has_normals = false;
+
+		size_t get_memory() const {
+
+			return SimpleEngine::get_memory(positions) + SimpleEngine::get_memory(uvs) + SimpleEngine::get_memory(normals)
+				 + SimpleEngine::get_memory(corners) + SimpleEngine::get_memory(relative_flags);
+		}
+	};
+
+	static bool is_blank(const char c) {
+
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	static bool is_digit(const char c) {
+
+		return c >= '0' && c <= '9';
+	}
+
+	static const char* skip_blanks(const char* pCurrent, const char* pEnd) {
+
+		while (pCurrent < pEnd && is_blank(*pCurrent))
+			++pCurrent;
+		return pCurrent;
+	}
+
+	//Без локали и без нуля в конце строки - strtof здесь не подходит. Мантисса копится в 19 десятичных знаков,
+	//для float этого с запасом
+	static const char* parse_float(const char* pCurrent, const char* pEnd, float& value) {
+
+		static const double powers_of_10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+											   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+		pCurrent = skip_blanks(pCurrent, pEnd);
+		const bool negative = pCurrent < pEnd && *pCurrent == '-';
+		if (pCurrent < pEnd && (*pCurrent == '-' || *pCurrent == '+'))
+			++pCurrent;
+
+		uint64_t mantissa = 0;
+		int exponent = 0;
+		int digits = 0;
+		bool any_digits = false;
+		for (; pCurrent < pEnd && is_digit(*pCurrent); ++pCurrent, any_digits = true) {
+
+			if (digits < 19) {
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*pCurrent - '0');
+				digits += mantissa != 0;
+			}
+			else {
+				++exponent;
+			}
+		}
+		if (pCurrent < pEnd && *pCurrent == '.') {
+
+			for (++pCurrent; pCurrent < pEnd && is_digit(*pCurrent); ++pCurrent, any_digits = true) {
+
+				if (digits < 19) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*pCurrent - '0');
+					digits += mantissa != 0;
+					--exponent;
+				}
+			}
+		}
+		if (!any_digits) {
+			value = 0.f;
+			return nullptr;
+		}
+		if (pCurrent < pEnd && (*pCurrent == 'e' || *pCurrent == 'E')) {
+
+			const char* pExponent = pCurrent + 1;
+			const bool negative_exponent = pExponent < pEnd && *pExponent == '-';
+			if (pExponent < pEnd && (*pExponent == '-' || *pExponent == '+'))
+				++pExponent;
+			int exponent_value = 0;
+			if (pExponent < pEnd && is_digit(*pExponent)) {
+				for (; pExponent < pEnd && is_digit(*pExponent); ++pExponent)
+					exponent_value = std::min(exponent_value * 10 + (*pExponent - '0'), 1000);
+				exponent += negative_exponent ? -exponent_value : exponent_value;
+				pCurrent = pExponent;
+			}
+		}
+
+		double result = static_cast<double>(mantissa);
+		if (exponent != 0 && mantissa != 0) {
+			const int exponent_abs = std::abs(exponent);
+			const double scale = exponent_abs <= 22 ? powers_of_10[exponent_abs] : std::pow(10.0, exponent_abs);
+			result = exponent < 0 ? result / scale : result * scale;
+		}
+		value = static_cast<float>(negative ? -result : result);
+		return pCurrent;
+	}
+
+	static const char* parse_int(const char* pCurrent, const char* pEnd, int32_t& value) {
+
+		const bool negative = pCurrent < pEnd && *pCurrent == '-';
+		if (negative)
+			++pCurrent;
+		if (pCurrent == pEnd || !is_digit(*pCurrent))
+			return nullptr;
+		int64_t result = 0;
+		for (; pCurrent < pEnd && is_digit(*pCurrent); ++pCurrent)
+			result = std::min<int64_t>(result * 10 + (*pCurrent - '0'), INT32_MAX);
+		value = static_cast<int32_t>(negative ? -result : result);
+		return pCurrent;
+	}
+
+	//Индекс OBJ с 1 -> с 0; отрицательный - от текущего конца куска, помечается флагом; 0 - нет атрибута
+	static int32_t resolve_obj_index(const int32_t index, const size_t local_count, uint8_t& flags, const uint8_t relative_flag) {
+
+		if (index > 0)
+			return index - 1;
+		if (index < 0) {
+			flags |= relative_flag;
+			return static_cast<int32_t>(local_count) + index;
+		}
+		return -1;
+	}
+
+	static const char* parse_obj_corner(const char* pCurrent, const char* pEnd, const ObjChunk& chunk, ObjCorner& corner, uint8_t& flags) {
+
+		int32_t position = 0;
+		int32_t uv = 0;
+		int32_t normal = 0;
+		pCurrent = parse_int(pCurrent, pEnd, position);
+		if (!pCurrent)
+			return nullptr;
+		//v, v/vt, v//vn, v/vt/vn
+		if (pCurrent < pEnd && *pCurrent == '/') {
+
+			++pCurrent;
+			if (pCurrent < pEnd && *pCurrent != '/') {
+				pCurrent = parse_int(pCurrent, pEnd, uv);
+				if (!pCurrent)
+					return nullptr;
+			}
+			if (pCurrent < pEnd && *pCurrent == '/') {
+				pCurrent = parse_int(pCurrent + 1, pEnd, normal);
+				if (!pCurrent)
+					return nullptr;
+			}
+		}
+		if (pCurrent < pEnd && !is_blank(*pCurrent))
+			return nullptr;
+
+		flags = 0;
+		corner.position = resolve_obj_index(position, chunk.positions.size() / 3, flags, RelativePosition);
+		corner.uv = resolve_obj_index(uv, chunk.uvs.size() / 2, flags, RelativeUv);
+		corner.normal = resolve_obj_index(normal, chunk.normals.size() / 3, flags, RelativeNormal);
+		return pCurrent;
+	}
+
+	static void parse_obj_floats(const char* pCurrent, const char* pEnd, std::vector<float>& values, const size_t count) {
+
+		//Недостающие компоненты - нули, лишние (w, цвет вершины) пропускаются
+		for (size_t i = 0; i < count; ++i) {
+
+			float value = 0.f;
+			if (pCurrent)
+				pCurrent = parse_float(pCurrent, pEnd, value);
+			values.push_back(value);
+		}
+	}
+
+	static void parse_obj_chunk(ObjChunk& chunk) {
+
+		//Грубая оценка по размеру текста, чтобы векторы не перевыделялись на каждом шаге роста
+		const size_t chunk_size = static_cast<size_t>(chunk.end - chunk.begin);
+		chunk.positions.reserve(chunk_size / 32 * 3);
+		chunk.corners.reserve(chunk_size / 16);
+
+		const char* pLine = chunk.begin;
+		while (pLine < chunk.end) {
+
+			const char* pLineEnd = static_cast<const char*>(std::memchr(pLine, '\n', chunk.end - pLine));
+			if (!pLineEnd)
+				pLineEnd = chunk.end;
+			const char* pCurrent = skip_blanks(pLine, pLineEnd);
+			pLine = pLineEnd + 1;
+
+			const ptrdiff_t length = pLineEnd - pCurrent;
+			if (length < 2)
+				continue;
+
+			if (pCurrent[0] == 'v' && is_blank(pCurrent[1])) {
+				parse_obj_floats(pCurrent + 2, pLineEnd, chunk.positions, 3);
+			}
+			else if (pCurrent[0] == 'v' && pCurrent[1] == 't' && length > 2 && is_blank(pCurrent[2])) {
+				parse_obj_floats(pCurrent + 3, pLineEnd, chunk.uvs, 2);
+			}
+			else if (pCurrent[0] == 'v' && pCurrent[1] == 'n' && length > 2 && is_blank(pCurrent[2])) {
+				parse_obj_floats(pCurrent + 3, pLineEnd, chunk.normals, 3);
+			}
+			else if (pCurrent[0] == 'f' && is_blank(pCurrent[1])) {
+
+				//Многоугольник - веером из первой вершины, без временного массива углов
+				ObjCorner first_corner;
+				ObjCorner previous_corner;
+				uint8_t first_flags = 0;
+				uint8_t previous_flags = 0;
+				unsigned int corners_count = 0;
+				pCurrent += 2;
+				while (true) {
+
+					pCurrent = skip_blanks(pCurrent, pLineEnd);
+					if (pCurrent == pLineEnd)
+						break;
+
+					ObjCorner corner;
+					uint8_t flags = 0;
+					pCurrent = parse_obj_corner(pCurrent, pLineEnd, chunk, corner, flags);
+					if (!pCurrent) {
+						++chunk.malformed_lines;
+						break;
+					}
+
+					if (corners_count == 0) {
+						first_corner = corner;
+						first_flags = flags;
+					}
+					else if (corners_count >= 2) {
+						chunk.corners.insert(chunk.corners.end(), { first_corner, previous_corner, corner });
+						chunk.relative_flags.insert(chunk.relative_flags.end(), { first_flags, previous_flags, flags });
+					}
+					previous_corner = corner;
+					previous_flags = flags;
+					++corners_count;
+				}
+			}
+		}
+	}
+
+	//Открытая адресация с линейным пробированием: ключ и индекс вершины рядом, без узлов в куче
+	class ObjVertexMap {
+	public:
+		explicit ObjVertexMap(const size_t expected_count) {
+
+			size_t capacity = 16;
+			while (capacity < expected_count * 2)
+				capacity *= 2;
+			m_entries.assign(capacity, Entry{ {}, empty_value });
+		}
+
+		//Индекс существующей вершины или new_index, если ключ новый
+		uint32_t find_or_insert(const ObjCorner& key, const uint32_t new_index) {
+
+			if ((m_count + 1) * 2 > m_entries.size())
+				grow();
+
+			size_t slot = hash(key) & (m_entries.size() - 1);
+			while (true) {
+
+				Entry& entry = m_entries[slot];
+				if (entry.value == empty_value) {
+					entry = { key, new_index };
+					++m_count;
+					return new_index;
+				}
+				if (entry.key.position == key.position && entry.key.uv == key.uv && entry.key.normal == key.normal)
+					return entry.value;
+				slot = (slot + 1) & (m_entries.size() - 1);
+			}
+		}
+
+		size_t get_memory() const { return SimpleEngine::get_memory(m_entries); }
+
+	private:
+		static constexpr uint32_t empty_value = ~0u;
+
+		struct Entry {
+
+			ObjCorner key;
+			uint32_t value;
+		};
+
+		static size_t hash(const ObjCorner& key) {
+
+			uint64_t value = static_cast<uint32_t>(key.position) * 0x9E3779B97F4A7C15ull;
+			value ^= (static_cast<uint64_t>(static_cast<uint32_t>(key.uv)) << 32 | static_cast<uint32_t>(key.normal)) * 0xC2B2AE3D27D4EB4Full;
+			return static_cast<size_t>(value ^ (value >> 29));
+		}
+
+		void grow() {
+
+			std::vector<Entry> old_entries(m_entries.size() * 2, Entry{ {}, empty_value });
+			old_entries.swap(m_entries);
+			for (const Entry& entry : old_entries) {
+
+				if (entry.value == empty_value)
+					continue;
+				size_t slot = hash(entry.key) & (m_entries.size() - 1);
+				while (m_entries[slot].value != empty_value)
+					slot = (slot + 1) & (m_entries.size() - 1);
+				m_entries[slot] = entry;
+			}
+		}
+
+		std::vector<Entry> m_entries;
+		size_t m_count = 0;
+	};
+
+	bool MeshImporter::import_obj(const std::string& path, ImportedMesh& mesh) {
+
+		MappedFile file;
+		if (!file.open(path))
+			return false;
+		const char* pData = static_cast<const char*>(file.get_data());
+		const char* pDataEnd = pData + file.get_size();
+		m_statistics.bytes_parsed = file.get_size();
+
+		//Кусков в несколько раз больше потоков - строки разной длины, нагрузка выравнивается кражей задач
+		const size_t target_chunk_size = std::max<size_t>(256 * 1024, file.get_size() / (m_statistics.threads_count * 8));
+		std::vector<ObjChunk> chunks;
+		for (const char* pBegin = pData; pBegin < pDataEnd;) {
+
+			const char* pEnd = pBegin + std::min<size_t>(target_chunk_size, pDataEnd - pBegin);
+			const char* pLineEnd = pEnd < pDataEnd ? static_cast<const char*>(std::memchr(pEnd, '\n', pDataEnd - pEnd)) : nullptr;
+			pEnd = pLineEnd ? pLineEnd + 1 : pDataEnd;
+			chunks.emplace_back();
+			chunks.back().begin = pBegin;
+			chunks.back().end = pEnd;
+			pBegin = pEnd;
+		}
+
+		parallel_for(static_cast<uint32_t>(chunks.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i)
+				parse_obj_chunk(chunks[i]);
+		});
+
+		size_t positions_count = 0;
+		size_t uvs_count = 0;
+		size_t normals_count = 0;
+		size_t corners_count = 0;
+		size_t chunks_memory = 0;
+		unsigned int malformed_lines = 0;
+		for (ObjChunk& chunk : chunks) {
+
+			chunk.positions_base = static_cast<uint32_t>(positions_count);
+			chunk.uvs_base = static_cast<uint32_t>(uvs_count);
+			chunk.normals_base = static_cast<uint32_t>(normals_count);
+			positions_count += chunk.positions.size() / 3;
+			uvs_count += chunk.uvs.size() / 2;
+			normals_count += chunk.normals.size() / 3;
+			corners_count += chunk.corners.size();
+			chunks_memory += chunk.get_memory();
+			malformed_lines += chunk.malformed_lines;
+		}
+		track_memory(chunks_memory);
+		if (malformed_lines > 0)
+			std::cerr << "MeshImporter: " << path << ": skipped " << malformed_lines << " malformed face lines\n";
+		if (corners_count == 0) {
+			std::cerr << "MeshImporter: " << path << ": no faces\n";
+			return false;
+		}
+
+		//Атрибуты в общие массивы, индексы углов - в абсолютные
+		std::vector<float> positions(positions_count * 3);
+		std::vector<float> uvs(uvs_count * 2);
+		std::vector<float> normals(normals_count * 3);
+		track_memory(chunks_memory + get_memory(positions) + get_memory(uvs) + get_memory(normals));
+		parallel_for(static_cast<uint32_t>(chunks.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+
+				ObjChunk& chunk = chunks[i];
+				std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positions_base * 3);
+				std::copy(chunk.uvs.begin(), chunk.uvs.end(), uvs.begin() + chunk.uvs_base * 2);
+				std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normals_base * 3);
+				std::vector<float>().swap(chunk.positions);
+				std::vector<float>().swap(chunk.uvs);
+				std::vector<float>().swap(chunk.normals);
+
+				for (size_t corner_index = 0; corner_index < chunk.corners.size(); ++corner_index) {
+
+					ObjCorner& corner = chunk.corners[corner_index];
+					const uint8_t flags = chunk.relative_flags[corner_index];
+					if (flags & RelativePosition)
+						corner.position += chunk.positions_base;
+					if (flags & RelativeUv)
+						corner.uv += chunk.uvs_base;
+					if (flags & RelativeNormal)
+						corner.normal += chunk.normals_base;
+
+					if (corner.position < 0 || static_cast<size_t>(corner.position) >= positions_count)
+						corner.position = -1;
+					if (corner.uv < 0 || static_cast<size_t>(corner.uv) >= uvs_count)
+						corner.uv = -1;
+					if (corner.normal < 0 || static_cast<size_t>(corner.normal) >= normals_count)
+						corner.normal = -1;
+					chunk.has_uvs = chunk.has_uvs || corner.uv >= 0;
+					chunk.has_normals = chunk.has_normals || corner.normal >= 0;
+				}
+				std::vector<uint8_t>().swap(chunk.relative_flags);
+			}
+		});
+
+		bool has_uvs = false;
+		bool has_normals = false;
+		for (const ObjChunk& chunk : chunks) {
+
+			has_uvs = has_uvs || chunk.has_uvs;
+			has_normals = has_normals || chunk.has_normals;
+		}
+		set_layout(mesh, has_uvs);
+		mesh.generated_normals = !has_normals;
+		m_statistics.corners_count = corners_count;
+
+		//Склейка последовательная: номера вершин должны идти в порядке первого появления,
+		//чтобы результат не зависел от числа потоков
+		ObjVertexMap vertex_map(std::max(positions_count, corners_count / 6));
+		std::vector<ObjCorner> unique_corners;
+		unique_corners.reserve(std::max(positions_count, corners_count / 6));
+		mesh.indexes.reserve(corners_count);
+		std::vector<glm::vec3> smooth_normals(has_normals ? 0 : positions_count, glm::vec3(0.f));
+		unsigned int skipped_triangles = 0;
+		for (const ObjChunk& chunk : chunks) {
+			for (size_t i = 0; i + 2 < chunk.corners.size(); i += 3) {
+
+				const ObjCorner* pTriangle = &chunk.corners[i];
+				if (pTriangle[0].position < 0 || pTriangle[1].position < 0 || pTriangle[2].position < 0) {
+					++skipped_triangles;
+					continue;
+				}
+
+				if (!has_normals) {
+					const glm::vec3 a = glm::make_vec3(&positions[pTriangle[0].position * 3]);
+					const glm::vec3 b = glm::make_vec3(&positions[pTriangle[1].position * 3]);
+					const glm::vec3 c = glm::make_vec3(&positions[pTriangle[2].position * 3]);
+					//Без нормировки: вклад грани пропорционален её площади
+					const glm::vec3 face_normal = glm::cross(b - a, c - a);
+					for (unsigned int corner = 0; corner < 3; ++corner)
+						smooth_normals[pTriangle[corner].position] += face_normal;
+				}
+
+				for (unsigned int corner = 0; corner < 3; ++corner) {
+
+					//Без нормалей в файле вершины склеиваются только по позиции и uv
+					ObjCorner key = pTriangle[corner];
+					key.uv = has_uvs ? key.uv : -1;
+					key.normal = has_normals ? key.normal : -1;
+					const uint32_t index = vertex_map.find_or_insert(key, static_cast<uint32_t>(unique_corners.size()));
+					if (index == unique_corners.size())
+						unique_corners.push_back(key);
+					mesh.indexes.push_back(index);
+				}
+			}
+		}
+		if (skipped_triangles > 0)
+			std::cerr << "MeshImporter: " << path << ": skipped " << skipped_triangles << " triangles with missing vertices\n";
+
+		size_t corners_memory = 0;
+		for (const ObjChunk& chunk : chunks)
+			corners_memory += get_memory(chunk.corners);
+		const size_t attributes_memory = get_memory(positions) + get_memory(uvs) + get_memory(normals) + get_memory(smooth_normals);
+		track_memory(corners_memory + attributes_memory + vertex_map.get_memory() + get_memory(unique_corners) + get_memory(mesh.indexes));
+		chunks.clear();
+		vertex_map = ObjVertexMap(0);
+
+		mesh.vertices_count = unique_corners.size();
+		const size_t stride = mesh.buffer_layout.get_stride();
+		mesh.vertex_data.resize(mesh.vertices_count * stride);
+		track_memory(attributes_memory + get_memory(unique_corners) + get_memory(mesh.indexes) + get_memory(mesh.vertex_data));
+		parallel_for(static_cast<uint32_t>(mesh.vertices_count), 4096, [&](const uint32_t begin, const uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+
+				const ObjCorner& corner = unique_corners[i];
+				const glm::vec3 normal = has_normals ? (corner.normal >= 0 ? glm::make_vec3(&normals[corner.normal * 3]) : glm::vec3(0.f)) : smooth_normals[corner.position];
+				write_vertex(&mesh.vertex_data[i * stride], has_uvs, &positions[corner.position * 3], normal, corner.uv >= 0 ? &uvs[corner.uv * 2] : nullptr);
+			}
+		});
+
+		if (mesh.indexes.empty()) {
+			std::cerr << "MeshImporter: " << path << ": no valid triangles\n";
+			return false;
+		}
+		return true;
+	}
+
+	//----------------------------------------------------------------------------------------------------//
+	// glTF
+
+	namespace GltfComponentType {
+
+		constexpr int UnsignedByte = 5121;
+		constexpr int UnsignedShort = 5123;
+		constexpr int UnsignedInt = 5125;
+		constexpr int Float = 5126;
+	}
+
+	//Accessor, уже проверенный на выход за границы буфера
+	struct GltfAccessor {
+
+		const uint8_t* pData = nullptr;
+		size_t count = 0;
+		size_t stride = 0;
+		int component_type = 0;
+		size_t components_count = 0;
+		bool normalized = false;
+
+		float read_float(const size_t element, const size_t component) const {
+
+			const uint8_t* pComponent = pData + element * stride;
+			switch (component_type) {
+				case GltfComponentType::Float: {
+					float value;
+					std::memcpy(&value, pComponent + component * sizeof(float), sizeof(value));
+					return value;
+				}
+				case GltfComponentType::UnsignedShort: {
+					uint16_t value;
+					std::memcpy(&value, pComponent + component * sizeof(uint16_t), sizeof(value));
+					return normalized ? value / 65535.f : value;
+				}
+				case GltfComponentType::UnsignedByte:
+					return normalized ? pComponent[component] / 255.f : pComponent[component];
+			}
+			return 0.f;
+		}
+
+		uint32_t read_index(const size_t element) const {
+
+			const uint8_t* pElement = pData + element * stride;
+			switch (component_type) {
+				case GltfComponentType::UnsignedInt: {
+					uint32_t value;
+					std::memcpy(&value, pElement, sizeof(value));
+					return value;
+				}
+				case GltfComponentType::UnsignedShort: {
+					uint16_t value;
+					std::memcpy(&value, pElement, sizeof(value));
+					return value;
+				}
+			}
+			return *pElement;
+		}
+	};
+
+	struct GltfPrimitive {
+
+		GltfAccessor positions;
+		GltfAccessor normals;
+		GltfAccessor uvs;
+		GltfAccessor indexes;
+		bool has_normals = false;
+		bool has_uvs = false;
+		bool has_indexes = false;
+		size_t first_vertex = 0;
+		size_t first_index = 0;
+		size_t indexes_count = 0;
+	};
+
+	class GltfDocument {
+	public:
+		GltfDocument(const std::string& path, const JsonValue& root) : m_path(path), m_root(root) {}
+
+		bool load_buffers() {
+
+			const size_t separator = m_path.find_last_of("/\\");
+			const std::string directory = separator == std::string::npos ? std::string() : m_path.substr(0, separator + 1);
+
+			const JsonValue* pBuffers = m_root.find("buffers");
+			for (size_t i = 0; pBuffers && i < pBuffers->get_size(); ++i) {
+
+				const JsonValue& buffer = (*pBuffers)[i];
+				const std::string& uri = buffer.get_string("uri");
+				if (uri.empty() || uri.compare(0, 5, "data:") == 0)
+					return fail("only external .bin buffers are supported");
+
+				m_buffers.emplace_back();
+				if (!m_buffers.back().open(directory + uri))
+					return false;
+				size_t byte_length = 0;
+				if (!buffer.get_unsigned("byteLength", byte_length, 0))
+					return fail("invalid buffer byteLength");
+				if (byte_length > m_buffers.back().get_size())
+					return fail("buffer is shorter than its byteLength");
+			}
+			return true;
+		}
+
+		//components_count == 0 - любой тип; отсутствующий индекс - ошибка
+		bool get_accessor(const JsonValue* pIndex, GltfAccessor& accessor) {
+
+			const JsonValue* pAccessors = m_root.find("accessors");
+			size_t accessor_index = 0;
+			if (!pIndex || !pIndex->get_unsigned(accessor_index) || !pAccessors || accessor_index >= pAccessors->get_size())
+				return fail("invalid accessor index");
+
+			const JsonValue& json_accessor = (*pAccessors)[accessor_index];
+			if (json_accessor.find("sparse"))
+				return fail("sparse accessors are not supported");
+
+			static const char* types[] = { "SCALAR", "VEC2", "VEC3", "VEC4" };
+			const std::string& type = json_accessor.get_string("type");
+			accessor.components_count = 0;
+			for (size_t i = 0; i < 4; ++i) {
+				if (type == types[i])
+					accessor.components_count = i + 1;
+			}
+			size_t component_type = 0;
+			if (!json_accessor.get_unsigned("componentType", component_type, 0))
+				return fail("invalid accessor componentType");
+			size_t component_size = 0;
+			switch (component_type) {
+				case GltfComponentType::UnsignedByte: component_size = 1; break;
+				case GltfComponentType::UnsignedShort: component_size = 2; break;
+				case GltfComponentType::UnsignedInt:
+				case GltfComponentType::Float: component_size = 4; break;
+			}
+			if (accessor.components_count == 0 || component_size == 0)
+				return fail("unsupported accessor type");
+			accessor.component_type = static_cast<int>(component_type);
+
+			const size_t element_size = component_size * accessor.components_count;
+			if (!json_accessor.get_unsigned("count", accessor.count, 0))
+				return fail("invalid accessor count");
+			accessor.normalized = json_accessor.find("normalized") && json_accessor.find("normalized")->get_bool();
+
+			//Accessor без bufferView по спецификации заполнен нулями: все элементы читаются из одного нулевого
+			if (!json_accessor.find("bufferView")) {
+				static const uint8_t zero_element[16] = {};
+				accessor.pData = zero_element;
+				accessor.stride = 0;
+				return true;
+			}
+
+			const JsonValue* pViews = m_root.find("bufferViews");
+			size_t view_index = 0;
+			if (!json_accessor.get_unsigned("bufferView", view_index, 0) || !pViews || view_index >= pViews->get_size())
+				return fail("invalid bufferView index");
+			const JsonValue& view = (*pViews)[view_index];
+			size_t buffer_index = 0;
+			if (!view.get_unsigned("buffer", buffer_index, 0) || buffer_index >= m_buffers.size())
+				return fail("invalid buffer index");
+
+			size_t view_offset = 0;
+			size_t view_length = 0;
+			size_t accessor_offset = 0;
+			if (!view.get_unsigned("byteStride", accessor.stride, 0) || !view.get_unsigned("byteOffset", view_offset, 0)
+				|| !view.find("byteLength") || !view.get_unsigned("byteLength", view_length, 0)
+				|| !json_accessor.get_unsigned("byteOffset", accessor_offset, 0))
+				return fail("invalid bufferView layout");
+			if (accessor.stride == 0)
+				accessor.stride = element_size;
+
+			const MappedFile& buffer = m_buffers[buffer_index];
+			if (view_offset > buffer.get_size() || view_length > buffer.get_size() - view_offset || accessor_offset > view_length
+				|| (accessor.count > 0 && ((accessor.count - 1) > (view_length - accessor_offset) / accessor.stride
+				|| (accessor.count - 1) * accessor.stride + element_size > view_length - accessor_offset)))
+				return fail("accessor is out of its bufferView");
+
+			accessor.pData = static_cast<const uint8_t*>(buffer.get_data()) + view_offset + accessor_offset;
+			m_bytes_read += accessor.count * element_size;
+			return true;
+		}
+
+		bool fail(const char* reason) const {
+
+			std::cerr << "MeshImporter: " << m_path << ": " << reason << "\n";
+			return false;
+		}
+
+		size_t get_bytes_read() const { return m_bytes_read; }
+
+	private:
+		const std::string& m_path;
+		const JsonValue& m_root;
+		std::vector<MappedFile> m_buffers;
+		size_t m_bytes_read = 0;
+	};
+
+	bool MeshImporter::import_gltf(const std::string& path, ImportedMesh& mesh) {
+
+		MappedFile json_file;
+		if (!json_file.open(path))
+			return false;
+
+		JsonValue root;
+		std::string error;
+		const char* pJson = static_cast<const char*>(json_file.get_data());
+		if (!JsonValue::parse(pJson, pJson + json_file.get_size(), root, error)) {
+			std::cerr << "MeshImporter: " << path << ": " << error << "\n";
+			return false;
+		}
+
+		GltfDocument document(path, root);
+		if (!document.load_buffers())
+			return false;
+
+		//Все треугольные примитивы всех мешей подряд в один буфер
+		std::vector<GltfPrimitive> primitives;
+		size_t vertices_count = 0;
+		size_t indexes_count = 0;
+		const JsonValue* pMeshes = root.find("meshes");
+		for (size_t mesh_index = 0; pMeshes && mesh_index < pMeshes->get_size(); ++mesh_index) {
+
+			const JsonValue* pPrimitives = (*pMeshes)[mesh_index].find("primitives");
+			for (size_t primitive_index = 0; pPrimitives && primitive_index < pPrimitives->get_size(); ++primitive_index) {
+
+				const JsonValue& json_primitive = (*pPrimitives)[primitive_index];
+				const JsonValue* pAttributes = json_primitive.find("attributes");
+				//4 - TRIANGLES; линии и точки в меш не попадают
+				if (json_primitive.get_number("mode", 4.0) != 4.0 || !pAttributes)
+					continue;
+
+				GltfPrimitive primitive;
+				if (!document.get_accessor(pAttributes->find("POSITION"), primitive.positions))
+					return false;
+				if (primitive.positions.components_count != 3 || primitive.positions.component_type != GltfComponentType::Float)
+					return document.fail("POSITION must be float VEC3");
+
+				primitive.has_normals = pAttributes->find("NORMAL") != nullptr;
+				if (primitive.has_normals && !document.get_accessor(pAttributes->find("NORMAL"), primitive.normals))
+					return false;
+				if (primitive.has_normals && (primitive.normals.components_count != 3 || primitive.normals.count != primitive.positions.count))
+					return document.fail("NORMAL doesn't match POSITION");
+
+				primitive.has_uvs = pAttributes->find("TEXCOORD_0") != nullptr;
+				if (primitive.has_uvs && !document.get_accessor(pAttributes->find("TEXCOORD_0"), primitive.uvs))
+					return false;
+				if (primitive.has_uvs && (primitive.uvs.components_count != 2 || primitive.uvs.count != primitive.positions.count))
+					return document.fail("TEXCOORD_0 doesn't match POSITION");
+
+				primitive.has_indexes = json_primitive.find("indices") != nullptr;
+				if (primitive.has_indexes && !document.get_accessor(json_primitive.find("indices"), primitive.indexes))
+					return false;
+				if (primitive.has_indexes && (primitive.indexes.components_count != 1 || primitive.indexes.component_type == GltfComponentType::Float))
+					return document.fail("indices must be unsigned integer SCALAR");
+
+				primitive.indexes_count = (primitive.has_indexes ? primitive.indexes.count : primitive.positions.count) / 3 * 3;
+				primitive.first_vertex = vertices_count;
+				primitive.first_index = indexes_count;
+				vertices_count += primitive.positions.count;
+				indexes_count += primitive.indexes_count;
+				primitives.push_back(primitive);
+			}
+		}
+		m_statistics.bytes_parsed = json_file.get_size() + document.get_bytes_read();
+		if (indexes_count == 0)
+			return document.fail("no triangle primitives");
+		if (vertices_count > UINT32_MAX)
+			return document.fail("too many vertices for 32-bit indexes");
+		if (indexes_count > UINT32_MAX)
+			return document.fail("too many indexes");
+
+		bool has_uvs = false;
+		bool all_have_normals = true;
+		for (const GltfPrimitive& primitive : primitives) {
+
+			has_uvs = has_uvs || primitive.has_uvs;
+			all_have_normals = all_have_normals && primitive.has_normals;
+		}
+		set_layout(mesh, has_uvs);
+		mesh.generated_normals = !all_have_normals;
+		mesh.vertices_count = vertices_count;
+		m_statistics.corners_count = indexes_count;
+
+		const size_t stride = mesh.buffer_layout.get_stride();
+		mesh.vertex_data.resize(vertices_count * stride);
+		mesh.indexes.resize(indexes_count);
+
+		//Индексы первыми: по ним считаются нормали примитивов, у которых их нет
+		std::atomic<bool> indexes_valid{ true };
+		for (const GltfPrimitive& primitive : primitives) {
+
+			parallel_for(static_cast<uint32_t>(primitive.indexes_count), 16384, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i) {
+
+					const uint32_t index = primitive.has_indexes ? primitive.indexes.read_index(i) : i;
+					if (index >= primitive.positions.count) {
+						indexes_valid.store(false, std::memory_order_relaxed);
+						continue;
+					}
+					mesh.indexes[primitive.first_index + i] = static_cast<uint32_t>(primitive.first_vertex + index);
+				}
+			});
+		}
+		if (!indexes_valid.load())
+			return document.fail("index out of range");
+
+		std::vector<glm::vec3> smooth_normals;
+		for (const GltfPrimitive& primitive : primitives) {
+
+			if (!primitive.has_normals) {
+				smooth_normals.assign(primitive.positions.count, glm::vec3(0.f));
+				for (size_t i = 0; i < primitive.indexes_count; i += 3) {
+
+					const uint32_t* pTriangle = &mesh.indexes[primitive.first_index + i];
+					glm::vec3 corners[3];
+					for (unsigned int corner = 0; corner < 3; ++corner) {
+						const size_t vertex = pTriangle[corner] - primitive.first_vertex;
+						corners[corner] = glm::vec3(primitive.positions.read_float(vertex, 0), primitive.positions.read_float(vertex, 1), primitive.positions.read_float(vertex, 2));
+					}
+					const glm::vec3 face_normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+					for (unsigned int corner = 0; corner < 3; ++corner)
+						smooth_normals[pTriangle[corner] - primitive.first_vertex] += face_normal;
+				}
+			}
+			track_memory(get_memory(mesh.vertex_data) + get_memory(mesh.indexes) + get_memory(smooth_normals));
+
+			parallel_for(static_cast<uint32_t>(primitive.positions.count), 4096, [&](const uint32_t begin, const uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i) {
+
+					const float position[3] = { primitive.positions.read_float(i, 0), primitive.positions.read_float(i, 1), primitive.positions.read_float(i, 2) };
+					const glm::vec3 normal = primitive.has_normals
+						? glm::vec3(primitive.normals.read_float(i, 0), primitive.normals.read_float(i, 1), primitive.normals.read_float(i, 2))
+						: smooth_normals[i];
+					const float uv[2] = { primitive.has_uvs ? primitive.uvs.read_float(i, 0) : 0.f, primitive.has_uvs ? primitive.uvs.read_float(i, 1) : 0.f };
+					write_vertex(&mesh.vertex_data[(primitive.first_vertex + i) * stride], has_uvs, position, normal, uv);
+				}
+			});
+		}
+		return true;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "SimpleEngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SimpleEngine {
+
+	class JobSystem;
+
+	//Результат импорта: вершины уже в раскладке buffer_layout, можно сразу в VertexBuffer или MeshFile::write
+	struct ImportedMesh {
+
+		//Float3 position, Float3 normal[, Float2 uv]
+		BufferLayout buffer_layout{ ShaderDataType::Float3, ShaderDataType::Float3 };
+		std::vector<uint8_t> vertex_data;
+		size_t vertices_count = 0;
+		std::vector<uint32_t> indexes;
+		bool has_uvs = false;
+		bool generated_normals = false;
+	};
+
+	//Wavefront OBJ и glTF 2.0 (.gltf + внешние .bin). Файлы отображаются в память,
+	//OBJ режется на куски по строкам и разбирается параллельно на JobSystem, одинаковые вершины склеиваются
+	//через хеш-таблицу с открытой адресацией. У glTF все примитивы всех мешей сливаются в один меш
+	//в собственных координатах меша - трансформации узлов не применяются
+	class MeshImporter {
+	public:
+		struct Statistics {
+
+			size_t bytes_parsed = 0;//Текст OBJ или JSON + прочитанные блоки .bin
+			double import_ms = 0.0;
+			double megabytes_per_second = 0.0;
+			size_t peak_memory_bytes = 0;//Рабочие буферы импортёра в пике, без отображённых файлов
+			size_t corners_count = 0;//Вершин треугольников до склейки
+			unsigned int threads_count = 1;
+		};
+
+		//nullptr - всё в вызывающем потоке
+		explicit MeshImporter(JobSystem* pJobSystem = nullptr) : m_pJobSystem(pJobSystem) {}
+
+		//Формат - по расширению
+		bool import(const std::string& path, ImportedMesh& mesh);
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		bool import_obj(const std::string& path, ImportedMesh& mesh);
+		bool import_gltf(const std::string& path, ImportedMesh& mesh);
+
+		template<typename Func>
+		void parallel_for(const uint32_t count, const uint32_t grain, Func&& func);
+		void track_memory(const size_t bytes);
+
+		JobSystem* m_pJobSystem;
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,659 @@
+#include "MeshOptimizer.hpp"
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+#include <glm/common.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	//Все функции ниже индексируют по номеру вершины свои массивы - индекс за концом вершин пишет мимо них
+	static bool indexes_in_range(const char* function, const uint32_t* indexes, const size_t indexes_count, const size_t vertices_count) {
+
+		const uint32_t* pMax = std::max_element(indexes, indexes + indexes_count);
+		if (pMax == indexes + indexes_count || *pMax < vertices_count)
+			return true;
+		std::cerr << function << ": index " << *pMax << " is out of " << vertices_count << " vertices\n";
+		return false;
+	}
+
+	VertexCacheStatistics analyze_vertex_cache(const uint32_t* indexes, const size_t indexes_count, const size_t vertices_count, const unsigned int cache_size) {
+
+		if (!indexes_in_range("analyze_vertex_cache", indexes, indexes_count, vertices_count))
+			return {};
+
+		//Вместо очереди - время попадания в кэш: вершина вытеснена, если после неё было cache_size промахов
+		std::vector<uint32_t> timestamps(vertices_count, 0);
+		uint32_t timestamp = cache_size + 1;
+		size_t misses_count = 0;
+		size_t used_vertices_count = 0;
+		for (size_t i = 0; i < indexes_count; ++i) {
+
+			const uint32_t vertex = indexes[i];
+			if (timestamp - timestamps[vertex] > cache_size) {
+				used_vertices_count += timestamps[vertex] == 0;
+				timestamps[vertex] = timestamp++;
+				++misses_count;
+			}
+		}
+
+		VertexCacheStatistics statistics;
+		if (indexes_count >= 3)
+			statistics.acmr = static_cast<float>(misses_count) / static_cast<float>(indexes_count / 3);
+		if (used_vertices_count > 0)
+			statistics.atvr = static_cast<float>(misses_count) / static_cast<float>(used_vertices_count);
+		return statistics;
+	}
+
+	//Константы из статьи Форсайта: кэш моделируется на 32 вершины, хотя реальный бывает меньше -
+	//порядок от этого почти не зависит
+	constexpr int forsyth_cache_size = 32;
+	constexpr uint32_t forsyth_max_valence = 64;
+
+	class ForsythScores {
+	public:
+		ForsythScores() {
+
+			//Три вершины последнего треугольника - фиксированная оценка, иначе он выиграл бы всегда
+			m_cache_scores[0] = 0.f;
+			for (int position = 0; position < forsyth_cache_size; ++position) {
+				m_cache_scores[position + 1] = position < 3 ? 0.75f
+					: std::pow(1.f - static_cast<float>(position - 3) / (forsyth_cache_size - 3), 1.5f);
+			}
+			//Вершины с немногими оставшимися треугольниками стоит закрыть поскорее
+			m_valence_scores[0] = 0.f;
+			for (uint32_t valence = 1; valence < forsyth_max_valence; ++valence)
+				m_valence_scores[valence] = 2.f / std::sqrt(static_cast<float>(valence));
+		}
+
+		float get(const int cache_position, const uint32_t live_triangles) const {
+
+			if (live_triangles == 0)
+				return -1.f;
+			return m_cache_scores[cache_position + 1] + m_valence_scores[std::min(live_triangles, forsyth_max_valence - 1)];
+		}
+
+	private:
+		float m_cache_scores[forsyth_cache_size + 1];
+		float m_valence_scores[forsyth_max_valence];
+	};
+
+	bool optimize_vertex_cache(uint32_t* indexes, const size_t indexes_count, const size_t vertices_count) {
+
+		static const ForsythScores scores;
+		constexpr size_t no_triangle = ~static_cast<size_t>(0);
+		const size_t triangles_count = indexes_count / 3;
+		if (!indexes_in_range("optimize_vertex_cache", indexes, indexes_count, vertices_count))
+			return false;
+		if (triangles_count == 0)
+			return true;
+
+		//Треугольники каждой вершины одним массивом: [offsets[v], offsets[v] + live_triangles[v]) - ещё не выданные
+		std::vector<uint32_t> offsets(vertices_count + 1, 0);
+		std::vector<uint32_t> live_triangles(vertices_count, 0);
+		for (size_t i = 0; i < triangles_count * 3; ++i)
+			++live_triangles[indexes[i]];
+		for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+			offsets[vertex + 1] = offsets[vertex] + live_triangles[vertex];
+		std::vector<uint32_t> vertex_triangles(triangles_count * 3);
+		std::vector<uint32_t> fill_counts(vertices_count, 0);
+		for (size_t i = 0; i < triangles_count * 3; ++i)
+			vertex_triangles[offsets[indexes[i]] + fill_counts[indexes[i]]++] = static_cast<uint32_t>(i / 3);
+
+		std::vector<int> cache_positions(vertices_count, -1);
+		std::vector<float> vertex_scores(vertices_count);
+		for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+			vertex_scores[vertex] = scores.get(-1, live_triangles[vertex]);
+
+		std::vector<float> triangle_scores(triangles_count);
+		size_t best_triangle = 0;
+		for (size_t triangle = 0; triangle < triangles_count; ++triangle) {
+
+			const uint32_t* pTriangle = &indexes[triangle * 3];
+			triangle_scores[triangle] = vertex_scores[pTriangle[0]] + vertex_scores[pTriangle[1]] + vertex_scores[pTriangle[2]];
+			if (triangle_scores[triangle] > triangle_scores[best_triangle])
+				best_triangle = triangle;
+		}
+
+		std::vector<uint8_t> emitted(triangles_count, 0);
+		std::vector<uint32_t> result(triangles_count * 3);
+		uint32_t cache[forsyth_cache_size + 3];
+		uint32_t new_cache[forsyth_cache_size + 3];
+		size_t cache_count = 0;
+		size_t input_cursor = 0;
+		for (size_t emitted_count = 0; emitted_count < triangles_count; ++emitted_count) {
+
+			//В кэше не осталось вершин с невыданными треугольниками - следующий по исходному порядку
+			if (best_triangle == no_triangle) {
+				while (emitted[input_cursor])
+					++input_cursor;
+				best_triangle = input_cursor;
+			}
+
+			const uint32_t* pTriangle = &indexes[best_triangle * 3];
+			std::copy(pTriangle, pTriangle + 3, &result[emitted_count * 3]);
+			emitted[best_triangle] = 1;
+
+			size_t new_cache_count = 0;
+			for (unsigned int corner = 0; corner < 3; ++corner) {
+
+				const uint32_t vertex = pTriangle[corner];
+				uint32_t* pVertexTriangles = &vertex_triangles[offsets[vertex]];
+				uint32_t* pLast = pVertexTriangles + live_triangles[vertex] - 1;
+				std::iter_swap(std::find(pVertexTriangles, pLast, static_cast<uint32_t>(best_triangle)), pLast);
+				--live_triangles[vertex];
+
+				if (std::find(new_cache, new_cache + new_cache_count, vertex) == new_cache + new_cache_count)
+					new_cache[new_cache_count++] = vertex;
+			}
+			for (size_t i = 0; i < cache_count; ++i) {
+				if (std::find(pTriangle, pTriangle + 3, cache[i]) == pTriangle + 3)
+					new_cache[new_cache_count++] = cache[i];
+			}
+
+			//Вытесненные за размер кэша тоже пересчитываются - их оценка падает
+			for (size_t i = 0; i < new_cache_count; ++i) {
+
+				const uint32_t vertex = new_cache[i];
+				cache_positions[vertex] = i < forsyth_cache_size ? static_cast<int>(i) : -1;
+				vertex_scores[vertex] = scores.get(cache_positions[vertex], live_triangles[vertex]);
+			}
+
+			best_triangle = no_triangle;
+			float best_score = -1.f;
+			for (size_t i = 0; i < new_cache_count; ++i) {
+
+				const uint32_t vertex = new_cache[i];
+				const uint32_t* pVertexTriangles = &vertex_triangles[offsets[vertex]];
+				for (uint32_t j = 0; j < live_triangles[vertex]; ++j) {
+
+					const uint32_t triangle = pVertexTriangles[j];
+					const uint32_t* pCandidate = &indexes[triangle * 3];
+					triangle_scores[triangle] = vertex_scores[pCandidate[0]] + vertex_scores[pCandidate[1]] + vertex_scores[pCandidate[2]];
+					if (triangle_scores[triangle] > best_score) {
+						best_score = triangle_scores[triangle];
+						best_triangle = triangle;
+					}
+				}
+			}
+
+			cache_count = std::min<size_t>(new_cache_count, forsyth_cache_size);
+			std::copy(new_cache, new_cache + cache_count, cache);
+		}
+		std::copy(result.begin(), result.end(), indexes);
+		return true;
+	}
+
+	bool optimize_vertex_fetch(void* vertices, size_t& vertices_count, const size_t stride, uint32_t* indexes, const size_t indexes_count) {
+
+		constexpr uint32_t unused = ~0u;
+		if (!indexes_in_range("optimize_vertex_fetch", indexes, indexes_count, vertices_count))
+			return false;
+		std::vector<uint32_t> remap(vertices_count, unused);
+		uint32_t new_vertices_count = 0;
+		for (size_t i = 0; i < indexes_count; ++i) {
+
+			uint32_t& new_index = remap[indexes[i]];
+			if (new_index == unused)
+				new_index = new_vertices_count++;
+			indexes[i] = new_index;
+		}
+
+		uint8_t* pVertices = static_cast<uint8_t*>(vertices);
+		const std::vector<uint8_t> source(pVertices, pVertices + vertices_count * stride);
+		for (size_t vertex = 0; vertex < vertices_count; ++vertex) {
+			if (remap[vertex] != unused)
+				std::memcpy(pVertices + remap[vertex] * stride, source.data() + vertex * stride, stride);
+		}
+		vertices_count = new_vertices_count;
+		return true;
+	}
+
+	//Сумма квадратов расстояний до плоскостей граней с весом по площади; вес хранится отдельно,
+	//чтобы ошибка была средним квадратом расстояния, а не зависела от размера треугольников
+	struct Quadric {
+
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double weight = 0.0;
+
+		void add_plane(const glm::dvec3& normal, const double distance, const double plane_weight) {
+
+			a00 += plane_weight * normal.x * normal.x;
+			a01 += plane_weight * normal.x * normal.y;
+			a02 += plane_weight * normal.x * normal.z;
+			a11 += plane_weight * normal.y * normal.y;
+			a12 += plane_weight * normal.y * normal.z;
+			a22 += plane_weight * normal.z * normal.z;
+			b0 += plane_weight * normal.x * distance;
+			b1 += plane_weight * normal.y * distance;
+			b2 += plane_weight * normal.z * distance;
+			c += plane_weight * distance * distance;
+			weight += plane_weight;
+		}
+
+		void add(const Quadric& other) {
+
+			a00 += other.a00; a01 += other.a01; a02 += other.a02;
+			a11 += other.a11; a12 += other.a12; a22 += other.a22;
+			b0 += other.b0; b1 += other.b1; b2 += other.b2;
+			c += other.c;
+			weight += other.weight;
+		}
+
+		double get_error(const glm::vec3& point) const {
+
+			if (weight <= 0.0)
+				return 0.0;
+			const double x = point.x, y = point.y, z = point.z;
+			const double error = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+							   + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+			return std::max(error, 0.0) / weight;
+		}
+	};
+
+	//Вершина схлопывается, только если вокруг неё замкнутый веер: каждое ребро a->x встречается и как x->a, ровно по разу
+	static bool is_interior_vertex(const uint32_t vertex, const uint32_t* pTriangles, const uint32_t triangles_count,
+								   const std::vector<uint32_t>& indexes, std::vector<uint32_t>& next, std::vector<uint32_t>& previous) {
+
+		next.clear();
+		previous.clear();
+		for (uint32_t i = 0; i < triangles_count; ++i) {
+
+			const uint32_t* pTriangle = &indexes[pTriangles[i] * 3];
+			for (unsigned int corner = 0; corner < 3; ++corner) {
+				if (pTriangle[corner] == vertex) {
+					next.push_back(pTriangle[(corner + 1) % 3]);
+					previous.push_back(pTriangle[(corner + 2) % 3]);
+				}
+			}
+		}
+		std::sort(next.begin(), next.end());
+		std::sort(previous.begin(), previous.end());
+		return !next.empty() && next == previous && std::adjacent_find(next.begin(), next.end()) == next.end();
+	}
+
+	//Соседи вершины по её треугольникам, отсортированные, без повторов
+	static void gather_ring(const uint32_t vertex, const uint32_t* pTriangles, const uint32_t triangles_count,
+							const std::vector<uint32_t>& indexes, std::vector<uint32_t>& ring) {
+
+		ring.clear();
+		for (uint32_t i = 0; i < triangles_count; ++i) {
+
+			const uint32_t* pTriangle = &indexes[pTriangles[i] * 3];
+			for (unsigned int corner = 0; corner < 3; ++corner) {
+				if (pTriangle[corner] != vertex)
+					ring.push_back(pTriangle[corner]);
+			}
+		}
+		std::sort(ring.begin(), ring.end());
+		ring.erase(std::unique(ring.begin(), ring.end()), ring.end());
+	}
+
+	//Условие связности: у концов ребра общие соседи - только две вершины напротив него. Иначе после схлопывания
+	//сливаются два ребра, и сетка становится неманифолдной (например, "перешеек" толщиной в одно ребро)
+	static bool is_link_condition_met(const uint32_t from, const uint32_t to, const std::vector<uint32_t>& offsets,
+									  const std::vector<uint32_t>& vertex_triangles, const std::vector<uint32_t>& indexes,
+									  std::vector<uint32_t>& from_ring, std::vector<uint32_t>& to_ring) {
+
+		gather_ring(from, &vertex_triangles[offsets[from]], offsets[from + 1] - offsets[from], indexes, from_ring);
+		gather_ring(to, &vertex_triangles[offsets[to]], offsets[to + 1] - offsets[to], indexes, to_ring);
+		size_t common_count = 0;
+		for (size_t i = 0, j = 0; i < from_ring.size() && j < to_ring.size();) {
+			if (from_ring[i] < to_ring[j])
+				++i;
+			else if (to_ring[j] < from_ring[i])
+				++j;
+			else {
+				++common_count;
+				++i;
+				++j;
+			}
+		}
+		return common_count == 2;
+	}
+
+	float simplify_mesh(const uint32_t* indexes, const size_t indexes_count, const float* positions, const size_t vertices_count,
+						const size_t positions_stride, const size_t target_indexes_count, const float target_error, std::vector<uint32_t>& result) {
+
+		result.assign(indexes, indexes + indexes_count / 3 * 3);
+		if (vertices_count == 0 || result.size() <= target_indexes_count)
+			return 0.f;
+		if (!indexes_in_range("simplify_mesh", result.data(), result.size(), vertices_count))
+			return 0.f;
+
+		//Позиции в единицах радиуса меша - ошибка получается относительной и не зависит от масштаба
+		std::vector<glm::vec3> points(vertices_count);
+		const uint8_t* pPositions = reinterpret_cast<const uint8_t*>(positions);
+		for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+			std::memcpy(&points[vertex], pPositions + vertex * positions_stride, sizeof(glm::vec3));
+		glm::vec3 min = points[0];
+		glm::vec3 max = points[0];
+		for (const glm::vec3& point : points) {
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+		const glm::vec3 center = (min + max) * 0.5f;
+		float radius = 0.f;
+		for (const glm::vec3& point : points)
+			radius = std::max(radius, glm::length(point - center));
+		const float scale = radius > 0.f ? 1.f / radius : 1.f;
+		for (glm::vec3& point : points)
+			point = (point - center) * scale;
+
+		//Шов атрибутов - несколько вершин в одной точке; такие вершины держат форму шва и не трогаются
+		std::vector<uint32_t> sorted_vertices(vertices_count);
+		for (uint32_t vertex = 0; vertex < vertices_count; ++vertex)
+			sorted_vertices[vertex] = vertex;
+		const auto less_position = [&points](const uint32_t lhs, const uint32_t rhs) {
+			const glm::vec3& a = points[lhs];
+			const glm::vec3& b = points[rhs];
+			return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+		};
+		std::sort(sorted_vertices.begin(), sorted_vertices.end(), less_position);
+		std::vector<uint8_t> shared_position(vertices_count, 0);
+		for (size_t i = 1; i < vertices_count; ++i) {
+			if (points[sorted_vertices[i - 1]] == points[sorted_vertices[i]])
+				shared_position[sorted_vertices[i - 1]] = shared_position[sorted_vertices[i]] = 1;
+		}
+
+		std::vector<Quadric> quadrics(vertices_count);
+		for (size_t i = 0; i < result.size(); i += 3) {
+
+			const glm::dvec3 p0(points[result[i]]);
+			const glm::dvec3 p1(points[result[i + 1]]);
+			const glm::dvec3 p2(points[result[i + 2]]);
+			glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+			const double length = glm::length(normal);
+			if (length <= 0.0)
+				continue;
+			normal /= length;
+			for (unsigned int corner = 0; corner < 3; ++corner)
+				quadrics[result[i + corner]].add_plane(normal, -glm::dot(normal, p0), length * 0.5);
+		}
+
+		struct Collapse {
+
+			uint32_t from;
+			uint32_t to;
+			double error;
+		};
+
+		const double error_limit = static_cast<double>(target_error) * target_error;
+		double max_error = 0.0;
+		std::vector<uint32_t> remap(vertices_count);
+		std::vector<uint32_t> offsets(vertices_count + 1);
+		std::vector<uint32_t> vertex_triangles;
+		std::vector<uint8_t> collapsible(vertices_count);
+		std::vector<uint8_t> locked(vertices_count);
+		std::vector<Collapse> collapses;
+		std::vector<uint32_t> next;
+		std::vector<uint32_t> previous;
+
+		//Проход: все кандидаты по возрастанию ошибки, схлопывания не задевают общих треугольников.
+		//Проходов немного - каждый убирает до половины недостающих треугольников
+		for (unsigned int pass = 0; pass < 100 && result.size() > target_indexes_count; ++pass) {
+
+			const uint32_t triangles_count = static_cast<uint32_t>(result.size() / 3);
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (const uint32_t index : result)
+				++offsets[index + 1];
+			for (size_t vertex = 0; vertex < vertices_count; ++vertex)
+				offsets[vertex + 1] += offsets[vertex];
+			vertex_triangles.resize(result.size());
+			std::vector<uint32_t> fill_positions(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i)
+				vertex_triangles[fill_positions[result[i]]++] = static_cast<uint32_t>(i / 3);
+
+			for (uint32_t vertex = 0; vertex < vertices_count; ++vertex) {
+				collapsible[vertex] = !shared_position[vertex] && is_interior_vertex(vertex, &vertex_triangles[offsets[vertex]],
+																					  offsets[vertex + 1] - offsets[vertex], result, next, previous);
+			}
+
+			//Каждое внутреннее ребро встречается в двух треугольниках - берём его один раз, при a < b
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3) {
+				for (unsigned int corner = 0; corner < 3; ++corner) {
+
+					const uint32_t a = result[i + corner];
+					const uint32_t b = result[i + (corner + 1) % 3];
+					if (a >= b)
+						continue;
+					if (collapsible[a])
+						collapses.push_back({ a, b, quadrics[a].get_error(points[b]) });
+					if (collapsible[b])
+						collapses.push_back({ b, a, quadrics[b].get_error(points[a]) });
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+			const size_t target_triangles_count = target_indexes_count / 3;
+			const size_t max_collapses = (triangles_count - target_triangles_count) / 2 + 1;
+			size_t collapses_done = 0;
+			std::fill(locked.begin(), locked.end(), 0);
+			for (uint32_t vertex = 0; vertex < vertices_count; ++vertex)
+				remap[vertex] = vertex;
+
+			for (const Collapse& collapse : collapses) {
+
+				if (collapse.error > error_limit || collapses_done >= max_collapses)
+					break;
+				if (locked[collapse.from] || locked[collapse.to])
+					continue;
+
+				//Треугольники веера не должны вывернуться, когда from окажется в точке to
+				bool flipped = false;
+				for (uint32_t i = offsets[collapse.from]; i < offsets[collapse.from + 1] && !flipped; ++i) {
+
+					const uint32_t* pTriangle = &result[vertex_triangles[i] * 3];
+					if (pTriangle[0] == collapse.to || pTriangle[1] == collapse.to || pTriangle[2] == collapse.to)
+						continue;
+					glm::vec3 corners[3] = { points[pTriangle[0]], points[pTriangle[1]], points[pTriangle[2]] };
+					const glm::vec3 old_normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+					for (glm::vec3& corner : corners) {
+						if (corner == points[collapse.from])
+							corner = points[collapse.to];
+					}
+					const glm::vec3 new_normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+					flipped = glm::dot(old_normal, new_normal) <= 0.f;
+				}
+				if (flipped)
+					continue;
+				if (!is_link_condition_met(collapse.from, collapse.to, offsets, vertex_triangles, result, next, previous))
+					continue;
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to].add(quadrics[collapse.from]);
+				max_error = std::max(max_error, collapse.error);
+				//Весь веер from меняется - соседние схлопывания в этом проходе посчитаны бы по устаревшей топологии
+				for (uint32_t i = offsets[collapse.from]; i < offsets[collapse.from + 1]; ++i) {
+					const uint32_t* pTriangle = &result[vertex_triangles[i] * 3];
+					locked[pTriangle[0]] = locked[pTriangle[1]] = locked[pTriangle[2]] = 1;
+				}
+				++collapses_done;
+			}
+			if (collapses_done == 0)
+				break;
+
+			size_t write_position = 0;
+			for (size_t i = 0; i < result.size(); i += 3) {
+
+				const uint32_t a = remap[result[i]];
+				const uint32_t b = remap[result[i + 1]];
+				const uint32_t c = remap[result[i + 2]];
+				if (a == b || b == c || a == c)
+					continue;
+				result[write_position++] = a;
+				result[write_position++] = b;
+				result[write_position++] = c;
+			}
+			result.resize(write_position);
+		}
+		return static_cast<float>(std::sqrt(max_error));
+	}
+
+	std::vector<MeshLod> build_lod_chain(std::vector<uint32_t>& indexes, const float* positions, const size_t vertices_count, const size_t positions_stride,
+										 const unsigned int max_lods_count, const float max_error, const bool optimize_cache) {
+
+		std::vector<std::vector<uint32_t>> lod_indexes(1);
+		std::vector<float> lod_errors(1, 0.f);
+		lod_indexes[0].swap(indexes);
+		//С плохими индексами - один исходный уровень как есть
+		const bool valid = indexes_in_range("build_lod_chain", lod_indexes[0].data(), lod_indexes[0].size(), vertices_count);
+		while (valid && lod_indexes.size() < max_lods_count) {
+
+			const std::vector<uint32_t>& source = lod_indexes.back();
+			std::vector<uint32_t> simplified;
+			//Ошибка считается от предыдущего уровня - до исходной модели не больше суммы ошибок по цепочке
+			const float error = simplify_mesh(source.data(), source.size(), positions, vertices_count, positions_stride, source.size() / 6 * 3,
+											  max_error - lod_errors.back(), simplified);
+			if (simplified.empty() || simplified.size() > source.size() / 10 * 9)
+				break;
+			lod_indexes.push_back(std::move(simplified));
+			lod_errors.push_back(lod_errors.back() + error);
+		}
+
+		std::vector<MeshLod> lods;
+		for (size_t lod = 0; lod < lod_indexes.size(); ++lod) {
+
+			if (valid && optimize_cache)
+				optimize_vertex_cache(lod_indexes[lod].data(), lod_indexes[lod].size(), vertices_count);
+			lods.push_back({ static_cast<uint32_t>(indexes.size()), static_cast<uint32_t>(lod_indexes[lod].size()), lod_errors[lod] });
+			indexes.insert(indexes.end(), lod_indexes[lod].begin(), lod_indexes[lod].end());
+		}
+		return lods;
+	}
+
+	bool narrow_indexes(const uint32_t* indexes, const size_t indexes_count, const size_t vertices_count, std::vector<uint16_t>& result) {
+
+		if (vertices_count > 65536)
+			return false;
+		result.resize(indexes_count);
+		for (size_t i = 0; i < indexes_count; ++i)
+			result[i] = static_cast<uint16_t>(indexes[i]);
+		return true;
+	}
+
+	uint16_t float_to_half(const float value) {
+
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+		const uint32_t abs_bits = bits & 0x7FFFFFFF;
+
+		//inf и NaN
+		if (abs_bits >= 0x7F800000)
+			return sign | 0x7C00 | (abs_bits > 0x7F800000 ? 0x200 : 0);
+		//От 65520 округление уже уходит в бесконечность
+		if (abs_bits >= 0x477FF000)
+			return sign | 0x7C00;
+		//Меньше 2^-14 - денормализованные half: шаг 2^-24, округление к ближайшему чётному
+		if (abs_bits < 0x38800000) {
+			float abs_value;
+			std::memcpy(&abs_value, &abs_bits, sizeof(abs_value));
+			return sign | static_cast<uint16_t>(std::nearbyint(abs_value * 16777216.f));
+		}
+
+		//Перенос мантиссы при округлении корректно увеличивает порядок
+		uint32_t half = (abs_bits - 0x38000000) >> 13;
+		const uint32_t remainder = abs_bits & 0x1FFF;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+			++half;
+		return sign | static_cast<uint16_t>(half);
+	}
+
+	float half_to_float(const uint16_t value) {
+
+		const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+		const uint32_t exponent = (value >> 10) & 0x1F;
+		const uint32_t mantissa = value & 0x3FF;
+		if (exponent == 0) {
+			const float result = static_cast<float>(mantissa) / 16777216.f;
+			return sign ? -result : result;
+		}
+
+		const uint32_t bits = exponent == 0x1F
+			? sign | 0x7F800000 | (mantissa << 13)
+			: sign | ((exponent + 112) << 23) | (mantissa << 13);
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	static bool is_float_type(const ShaderDataType type) {
+
+		return type == ShaderDataType::Float || type == ShaderDataType::Float2 || type == ShaderDataType::Float3 || type == ShaderDataType::Float4;
+	}
+
+	static int quantize_normalized(const float value, const float min, const float scale) {
+
+		return static_cast<int>(std::lround(std::clamp(value, min, 1.f) * scale));
+	}
+
+	bool quantize_vertices(const BufferLayout& source_layout, const void* source, const size_t vertices_count,
+						   const BufferLayout& target_layout, std::vector<uint8_t>& target) {
+
+		const std::vector<BufferElement>& source_elements = source_layout.get_elements();
+		const std::vector<BufferElement>& target_elements = target_layout.get_elements();
+		if (source_elements.size() != target_elements.size()) {
+			std::cerr << "quantize_vertices: layouts have different attribute counts\n";
+			return false;
+		}
+		for (size_t i = 0; i < source_elements.size(); ++i) {
+
+			const ShaderDataType type = target_elements[i].type;
+			const bool supported_target = is_float_type(type) || type == ShaderDataType::Half2 || type == ShaderDataType::Half4
+				|| type == ShaderDataType::Byte4N || type == ShaderDataType::UByte4N || type == ShaderDataType::UShort2N;
+			if (!is_float_type(source_elements[i].type) || !supported_target) {
+				std::cerr << "quantize_vertices: attribute " << i << " can't be converted\n";
+				return false;
+			}
+		}
+
+		const uint8_t* pSource = static_cast<const uint8_t*>(source);
+		target.resize(vertices_count * target_layout.get_stride());
+		for (size_t vertex = 0; vertex < vertices_count; ++vertex) {
+
+			const uint8_t* pSourceVertex = pSource + vertex * source_layout.get_stride();
+			uint8_t* pTargetVertex = target.data() + vertex * target_layout.get_stride();
+			for (size_t i = 0; i < source_elements.size(); ++i) {
+
+				float values[4] = { 0.f, 0.f, 0.f, 1.f };
+				std::memcpy(values, pSourceVertex + source_elements[i].offset, source_elements[i].components_count * sizeof(float));
+
+				const BufferElement& element = target_elements[i];
+				uint8_t* pTarget = pTargetVertex + element.offset;
+				for (size_t component = 0; component < element.components_count; ++component) {
+
+					const float value = values[component];
+					switch (element.type) {
+						case ShaderDataType::Half2:
+						case ShaderDataType::Half4: {
+							const uint16_t half = float_to_half(value);
+							std::memcpy(pTarget + component * sizeof(half), &half, sizeof(half));
+							break;
+						}
+						case ShaderDataType::Byte4N:
+							pTarget[component] = static_cast<uint8_t>(static_cast<int8_t>(quantize_normalized(value, -1.f, 127.f)));
+							break;
+						case ShaderDataType::UByte4N:
+							pTarget[component] = static_cast<uint8_t>(quantize_normalized(value, 0.f, 255.f));
+							break;
+						case ShaderDataType::UShort2N: {
+							const uint16_t normalized = static_cast<uint16_t>(quantize_normalized(value, 0.f, 65535.f));
+							std::memcpy(pTarget + component * sizeof(normalized), &normalized, sizeof(normalized));
+							break;
+						}
+						default:
+							std::memcpy(pTarget + component * sizeof(value), &value, sizeof(value));
+							break;
+					}
+				}
+			}
+		}
+		return true;
+	}
+}
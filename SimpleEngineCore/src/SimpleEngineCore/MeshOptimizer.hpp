@@ -0,0 +1,56 @@
+#pragma once
+#include "SimpleEngineCore/Rendering/OpenGL/VertexBuffer.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Обработка меша при импорте, до записи в .semesh. Все функции работают со списком треугольников
+
+	struct VertexCacheStatistics {
+
+		float acmr = 0.f;//Промахов кэша на треугольник: 3 - кэша нет, ~0.5 - предел для регулярной сетки
+		float atvr = 0.f;//Промахов на уникальную вершину: 1 - каждая вершина обрабатывается ровно раз
+	};
+
+	//Функции с vertices_count проверяют, что индексы в него попадают: иначе пишут в лог, и меш остаётся нетронутым
+
+	//Моделирует FIFO кэш вершин после трансформации - так его ведёт большинство GPU
+	VertexCacheStatistics analyze_vertex_cache(const uint32_t* indexes, const size_t indexes_count, const size_t vertices_count, const unsigned int cache_size = 16);
+
+	//Переставляет треугольники по алгоритму Форсайта (Linear-Speed Vertex Cache Optimisation):
+	//жадно берёт треугольник с лучшей оценкой по позициям вершин в кэше и числу оставшихся у них треугольников
+	bool optimize_vertex_cache(uint32_t* indexes, const size_t indexes_count, const size_t vertices_count);
+
+	//Перенумеровывает вершины в порядке первого обращения из индексов, чтобы выборка шла по буферу подряд.
+	//Неиспользуемые вершины выбрасываются, vertices_count становится новым числом вершин
+	bool optimize_vertex_fetch(void* vertices, size_t& vertices_count, const size_t stride, uint32_t* indexes, const size_t indexes_count);
+
+	//Упрощение по квадрикам ошибки (Гарланд-Хекберт): рёбра схлопываются в одну из своих вершин, пока индексов
+	//больше target_indexes_count и ошибка не превышает target_error. Вершины не двигаются и не добавляются -
+	//результат ссылается на тот же вершинный буфер, поэтому все LOD'ы меша делят один VertexBuffer.
+	//Вершины на границах и швах атрибутов (одна позиция у нескольких вершин) остаются на месте; рёбра, схлопывание
+	//которых склеило бы сетку в неманифолдную (общих соседей у концов больше двух), не трогаются.
+	//positions - первая позиция (Float3), шаг positions_stride байт. Ошибка - в долях радиуса меша, возвращается достигнутая
+	float simplify_mesh(const uint32_t* indexes, const size_t indexes_count, const float* positions, const size_t vertices_count,
+						const size_t positions_stride, const size_t target_indexes_count, const float target_error, std::vector<uint32_t>& result);
+
+	//Цепочка LOD'ов: каждый уровень - simplify_mesh предыдущего до половины треугольников, пока упрощение даёт больше 10%
+	//и накопленная ошибка не выше max_error. indexes заменяются всеми уровнями подряд, от подробного к грубому; optimize_cache -
+	//optimize_vertex_cache для каждого уровня отдельно (диапазоны рисуются по одному)
+	std::vector<MeshLod> build_lod_chain(std::vector<uint32_t>& indexes, const float* positions, const size_t vertices_count, const size_t positions_stride,
+										 const unsigned int max_lods_count, const float max_error, const bool optimize_cache);
+
+	//false, если вершин больше, чем адресует uint16_t
+	bool narrow_indexes(const uint32_t* indexes, const size_t indexes_count, const size_t vertices_count, std::vector<uint16_t>& result);
+
+	//Перекладывает вершины из Float-раскладки в сжатую поэлементно: число атрибутов должно совпадать,
+	//недостающие компоненты - как у GL по умолчанию (0, 0, 0, 1). Нормализованные типы зажимаются в свой диапазон
+	bool quantize_vertices(const BufferLayout& source_layout, const void* source, const size_t vertices_count,
+						   const BufferLayout& target_layout, std::vector<uint8_t>& target);
+
+	uint16_t float_to_half(const float value);
+	float half_to_float(const uint16_t value);
+}
@@ -0,0 +1,55 @@
+#include "SimpleEngineCore/Registry.hpp"
+#include <iostream>
+
+namespace SimpleEngine {
+
+	Entity Registry::create() {
+
+		if (!m_free_indexes.empty()) {
+
+			const uint32_t index = m_free_indexes.back();
+			m_free_indexes.pop_back();
+			return m_entities[index];
+		}
+
+		//Дальше индекс залез бы в биты поколения
+		if (m_entities.size() >= max_entities) {
+			std::cerr << "Registry::create: all " << max_entities << " entity indexes are in use\n";
+			return null_entity;
+		}
+		const Entity entity = static_cast<Entity>(m_entities.size());
+		m_entities.push_back(entity);
+		return entity;
+	}
+
+	void Registry::destroy(const Entity entity) {
+
+		if (!is_alive(entity))
+			return;
+
+		for (const std::unique_ptr<BaseComponentPool>& pPool : m_pools) {
+			if (pPool)
+				pPool->remove(entity);
+		}
+
+		//Поколение растёт сразу, чтобы старый Entity больше не считался живым
+		const uint32_t index = entity_index(entity);
+		const uint32_t generation = (entity_generation(entity) + 1) & 0xFF;
+		m_entities[index] = (generation << 24) | index;
+		m_free_indexes.push_back(index);
+	}
+
+	bool Registry::is_alive(const Entity entity) const {
+
+		//Свободный слот хранит Entity следующего поколения, а его ещё никто не получал
+		const uint32_t index = entity_index(entity);
+		return index < m_entities.size() && m_entities[index] == entity;
+	}
+
+	void Registry::clear() {
+
+		m_pools.clear();
+		m_entities.clear();
+		m_free_indexes.clear();
+	}
+}
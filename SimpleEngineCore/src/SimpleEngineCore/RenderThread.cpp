@@ -0,0 +1,75 @@
+#include "RenderThread.hpp"
+#include "SimpleEngineCore/Window.hpp"
+#include "Timing.hpp"
+#include <chrono>
+
+namespace SimpleEngine {
+
+	RenderThread::RenderThread(Window& window, ExecuteFn execute_fn)
+		: m_window(window)
+		, m_execute_fn(std::move(execute_fn)) {
+
+		//Контекст может быть текущим только в одном потоке
+		m_window.make_context_current(false);
+		m_thread = std::thread(&RenderThread::thread_loop, this);
+	}
+
+	RenderThread::~RenderThread() {
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bStop = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+		m_window.make_context_current(true);
+	}
+
+	void RenderThread::submit() {
+
+		const auto wait_start_time = std::chrono::steady_clock::now();
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return m_pPendingList == nullptr; });
+			m_pPendingList = &m_command_lists[m_recording_index];
+		}
+		m_condition.notify_all();
+		m_statistics.main_wait_ms += milliseconds_since(wait_start_time);
+
+		//Второй список уже выполнен - следующий кадр пишется в него
+		m_recording_index ^= 1;
+	}
+
+	void RenderThread::wait_idle() {
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_condition.wait(lock, [this] { return m_pPendingList == nullptr; });
+	}
+
+	void RenderThread::thread_loop() {
+
+		m_window.make_context_current(true);
+		while (true) {
+
+			RenderCommandList* pCommandList = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this] { return m_bStop || m_pPendingList != nullptr; });
+				//Отправленный кадр дорисовываем и при остановке
+				if (!m_pPendingList)
+					break;
+				pCommandList = m_pPendingList;
+			}
+
+			m_execute_fn(*pCommandList);
+			m_window.swap_buffers();
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_pPendingList = nullptr;
+			}
+			m_condition.notify_all();
+		}
+		m_window.make_context_current(false);
+	}
+}
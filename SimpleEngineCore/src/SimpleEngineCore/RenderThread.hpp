@@ -0,0 +1,52 @@
+#pragma once
+#include "SimpleEngineCore/Rendering/OpenGL/RenderCommandList.hpp"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace SimpleEngine {
+
+	class Window;
+
+	//Поток, которому на время своей жизни отдаётся GL контекст окна.
+	//Два списка команд: пока основной поток записывает кадр N, этот выполняет кадр N-1 и делает swap
+	class RenderThread {
+	public:
+		using ExecuteFn = std::function<void(RenderCommandList&)>;
+
+		struct Statistics {
+
+			double main_wait_ms = 0.0;//Основной поток ждал, пока отрисуется прошлый кадр
+		};
+
+		//Контекст должен быть текущим в вызывающем потоке, до деструктора GL оттуда трогать нельзя
+		RenderThread(Window& window, ExecuteFn execute_fn);
+		//Дорисовывает отправленный кадр и возвращает контекст вызывающему потоку
+		~RenderThread();
+		RenderThread(const RenderThread&) = delete;
+		RenderThread& operator=(const RenderThread&) = delete;
+
+		RenderCommandList& get_recording_list() { return m_command_lists[m_recording_index]; }
+		//Отдаёт записанный кадр и сразу возвращается; ждёт, только если прошлый кадр ещё рисуется
+		void submit();
+		void wait_idle();
+
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		void thread_loop();
+
+		Window& m_window;
+		ExecuteFn m_execute_fn;
+		RenderCommandList m_command_lists[2];
+		unsigned int m_recording_index = 0;
+
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		RenderCommandList* m_pPendingList = nullptr;//Отправлен или выполняется
+		bool m_bStop = false;
+		Statistics m_statistics;
+		std::thread m_thread;
+	};
+}
@@ -0,0 +1,165 @@
+#include "BatchRenderer.hpp"
+#include "ShaderProgram.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include "RingBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
+#include <iterator>
+
+namespace SimpleEngine {
+
+	const char* batch_vertex_shader =
+		R"(#version 460
+		layout(location = 0) in vec3 vertex_position;
+		layout(location = 1) in vec4 vertex_color;
+		uniform mat4 view_projection_matrix;
+		out vec4 color;
+		void main() {
+			color = vertex_color;
+			gl_Position = view_projection_matrix * vec4(vertex_position, 1.0);
+		})";
+
+	const char* batch_fragment_shader =
+		R"(#version 460
+		in vec4 color;
+		out vec4 frag_color;
+		void main() {
+			frag_color = color;
+		})";
+
+	//Квадрат в плоскости YZ, как и встроенная геометрия Application
+	const glm::vec3 quad_positions[] = {
+		{ 0.0f, -0.5f, -0.5f },
+		{ 0.0f,  0.5f, -0.5f },
+		{ 0.0f, -0.5f,  0.5f },
+		{ 0.0f,  0.5f,  0.5f }
+	};
+
+	const unsigned int quad_indexes[] = {
+		0, 1, 2, 3, 2, 1
+	};
+
+	const glm::vec3 cube_positions[] = {
+		{ -0.5f, -0.5f, -0.5f },
+		{  0.5f, -0.5f, -0.5f },
+		{  0.5f,  0.5f, -0.5f },
+		{ -0.5f,  0.5f, -0.5f },
+		{ -0.5f, -0.5f,  0.5f },
+		{  0.5f, -0.5f,  0.5f },
+		{  0.5f,  0.5f,  0.5f },
+		{ -0.5f,  0.5f,  0.5f }
+	};
+
+	const unsigned int cube_indexes[] = {
+		0, 2, 1, 0, 3, 2,
+		4, 5, 6, 4, 6, 7,
+		0, 1, 5, 0, 5, 4,
+		3, 6, 2, 3, 7, 6,
+		0, 4, 7, 0, 7, 3,
+		1, 2, 6, 1, 6, 5
+	};
+
+	constexpr unsigned int batch_frames_in_flight = 3;
+	//Сколько полных батчей помещается в область кольца одного кадра. Больше - кадр займёт и следующую область
+	constexpr size_t batch_max_flushes_per_frame = 4;
+
+	BatchRenderer::BatchRenderer(const size_t max_vertices, const size_t max_indexes)
+		: m_max_vertices(max_vertices)
+		, m_max_indexes(max_indexes) {
+
+		m_pShaderProgram = std::make_unique<ShaderProgram>(batch_vertex_shader, batch_fragment_shader);
+
+		BufferLayout buffer_layout_vec3_vec4{
+
+			ShaderDataType::Float3,
+			ShaderDataType::Float4
+		};
+
+		m_pVertexArray = std::make_unique<VertexArray>();
+		//Каждая область кольца - на весь кадр, а не на один батч: иначе второй flush() за кадр уже переходил бы в следующую область
+		m_pVertexBuffer = std::make_unique<VertexBuffer>(nullptr, max_vertices * sizeof(Vertex) * batch_max_flushes_per_frame * batch_frames_in_flight, buffer_layout_vec3_vec4, VertexBuffer::EUsage::Persistent);
+		m_pIndexBuffer = std::make_unique<IndexBuffer>(nullptr, max_indexes * batch_max_flushes_per_frame * batch_frames_in_flight, VertexBuffer::EUsage::Persistent);
+		m_pVertexArray->add_vertex_buffer(*m_pVertexBuffer);
+		m_pVertexArray->set_index_buffer(*m_pIndexBuffer);
+		m_pVertexRing = std::make_unique<RingBuffer>(*m_pVertexBuffer, batch_frames_in_flight);
+		m_pIndexRing = std::make_unique<RingBuffer>(*m_pIndexBuffer, batch_frames_in_flight);
+
+		m_vertices.reserve(max_vertices);
+		m_indexes.reserve(max_indexes);
+	}
+
+	BatchRenderer::~BatchRenderer() = default;
+
+	bool BatchRenderer::is_valid() const {
+
+		return m_pShaderProgram->isCompiled();
+	}
+
+	void BatchRenderer::begin(const glm::mat4& view_projection_matrix) {
+
+		m_view_projection_matrix = view_projection_matrix;
+		m_statistics = Statistics();
+		m_pVertexRing->reset_statistics();
+		m_pIndexRing->reset_statistics();
+		m_vertices.clear();
+		m_indexes.clear();
+	}
+
+	void BatchRenderer::submit_quad(const glm::mat4& model_matrix, const glm::vec4& color) {
+
+		submit(model_matrix, color, quad_positions, std::size(quad_positions), quad_indexes, std::size(quad_indexes));
+		++m_statistics.quads;
+	}
+
+	void BatchRenderer::submit_cube(const glm::mat4& model_matrix, const glm::vec4& color) {
+
+		submit(model_matrix, color, cube_positions, std::size(cube_positions), cube_indexes, std::size(cube_indexes));
+		++m_statistics.cubes;
+	}
+
+	void BatchRenderer::end() {
+
+		flush();
+		m_pVertexRing->end_frame();
+		m_pIndexRing->end_frame();
+		m_statistics.fence_waits = m_pVertexRing->get_statistics().fence_waits + m_pIndexRing->get_statistics().fence_waits;
+		m_statistics.ring_overflows = m_pVertexRing->get_statistics().overflows + m_pIndexRing->get_statistics().overflows;
+	}
+
+	void BatchRenderer::submit(const glm::mat4& model_matrix, const glm::vec4& color,
+							   const glm::vec3* positions, const size_t positions_count,
+							   const unsigned int* indexes, const size_t indexes_count) {
+
+		if (m_vertices.size() + positions_count > m_max_vertices || m_indexes.size() + indexes_count > m_max_indexes)
+			flush();
+
+		const unsigned int base_vertex = static_cast<unsigned int>(m_vertices.size());
+		for (size_t i = 0; i < positions_count; ++i) {
+			m_vertices.push_back({ glm::vec3(model_matrix * glm::vec4(positions[i], 1.f)), color });
+		}
+		for (size_t i = 0; i < indexes_count; ++i) {
+			m_indexes.push_back(base_vertex + indexes[i]);
+		}
+	}
+
+	void BatchRenderer::flush() {
+
+		if (m_indexes.empty())
+			return;
+
+		m_pShaderProgram->bind();
+		m_pShaderProgram->setMatrix4("view_projection_matrix", m_view_projection_matrix);
+
+		const size_t vertices_offset = m_pVertexRing->write(m_vertices.data(), m_vertices.size() * sizeof(Vertex), sizeof(Vertex));
+		const size_t indexes_offset = m_pIndexRing->write(m_indexes.data(), m_indexes.size() * sizeof(unsigned int), sizeof(unsigned int));
+		if (vertices_offset != RingBuffer::invalid_offset && indexes_offset != RingBuffer::invalid_offset) {
+			Renderer_OpenGL::draw(*m_pVertexArray, m_indexes.size(), indexes_offset / sizeof(unsigned int), static_cast<int>(vertices_offset / sizeof(Vertex)));
+		}
+
+		++m_statistics.batches_flushed;
+		m_statistics.vertices += m_vertices.size();
+		m_vertices.clear();
+		m_indexes.clear();
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <memory>
+#include <vector>
+
+namespace SimpleEngine {
+
+	class ShaderProgram;
+	class VertexBuffer;
+	class IndexBuffer;
+	class VertexArray;
+	class RingBuffer;
+
+	//Собирает примитивы в общий Stream буфер уже в мировых координатах и рисует их парой draw call'ов
+	class BatchRenderer {
+	public:
+		struct Statistics {
+
+			unsigned int batches_flushed = 0;
+			unsigned int quads = 0;
+			unsigned int cubes = 0;
+			size_t vertices = 0;
+			unsigned int fence_waits = 0;
+			unsigned int ring_overflows = 0;//Кадр не уместился в свою область кольца
+		};
+
+		BatchRenderer(const size_t max_vertices = 65536, const size_t max_indexes = 98304);
+		~BatchRenderer();
+
+		BatchRenderer(const BatchRenderer&) = delete;
+		BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+		bool is_valid() const;
+
+		void begin(const glm::mat4& view_projection_matrix);
+		void submit_quad(const glm::mat4& model_matrix, const glm::vec4& color);
+		void submit_cube(const glm::mat4& model_matrix, const glm::vec4& color);
+		void end();
+
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		struct Vertex {
+
+			glm::vec3 position;
+			glm::vec4 color;
+		};
+
+		void submit(const glm::mat4& model_matrix, const glm::vec4& color,
+					const glm::vec3* positions, const size_t positions_count,
+					const unsigned int* indexes, const size_t indexes_count);
+		void flush();
+
+		std::unique_ptr<ShaderProgram> m_pShaderProgram;
+		std::unique_ptr<VertexBuffer> m_pVertexBuffer;
+		std::unique_ptr<IndexBuffer> m_pIndexBuffer;
+		std::unique_ptr<VertexArray> m_pVertexArray;
+		std::unique_ptr<RingBuffer> m_pVertexRing;
+		std::unique_ptr<RingBuffer> m_pIndexRing;
+
+		std::vector<Vertex> m_vertices;
+		std::vector<unsigned int> m_indexes;
+		size_t m_max_vertices;
+		size_t m_max_indexes;
+
+		glm::mat4 m_view_projection_matrix{ 1.f };
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+namespace SimpleEngine {
+
+	//Файлы SimpleEngineCore/shaders, вшитые при сборке: EmbeddedShaders.cpp генерирует CMake
+	struct EmbeddedShader {
+
+		const char* name;
+		const char* source;
+	};
+
+	extern const EmbeddedShader embedded_shaders[];
+	extern const size_t embedded_shaders_count;
+}
@@ -0,0 +1,76 @@
+#include "FrameBuffer.hpp"
+#include <glad/glad.h>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	FrameBuffer::FrameBuffer(const unsigned int width, const unsigned int height)
+		: m_width(width)
+		, m_height(height) {
+
+		glGenFramebuffers(1, &m_id);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+
+		glGenRenderbuffers(1, &m_color_id);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_color_id);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color_id);
+
+		glGenRenderbuffers(1, &m_depth_id);
+		glBindRenderbuffer(GL_RENDERBUFFER, m_depth_id);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth_id);
+
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+			std::cerr << "FRAMEBUFFER: incomplete framebuffer " << width << "x" << height << "\n";
+		}
+		else {
+			m_isComplete = true;
+		}
+	}
+
+	FrameBuffer& FrameBuffer::operator=(FrameBuffer&& frame_buffer) noexcept {
+
+		m_id = frame_buffer.m_id;
+		m_color_id = frame_buffer.m_color_id;
+		m_depth_id = frame_buffer.m_depth_id;
+		m_width = frame_buffer.m_width;
+		m_height = frame_buffer.m_height;
+		m_isComplete = frame_buffer.m_isComplete;
+		frame_buffer.m_id = 0;
+		frame_buffer.m_color_id = 0;
+		frame_buffer.m_depth_id = 0;
+		frame_buffer.m_isComplete = false;
+		return *this;
+	}
+
+	FrameBuffer::FrameBuffer(FrameBuffer&& frame_buffer) noexcept
+		: m_id(frame_buffer.m_id)
+		, m_color_id(frame_buffer.m_color_id)
+		, m_depth_id(frame_buffer.m_depth_id)
+		, m_width(frame_buffer.m_width)
+		, m_height(frame_buffer.m_height)
+		, m_isComplete(frame_buffer.m_isComplete) {
+
+		frame_buffer.m_id = 0;
+		frame_buffer.m_color_id = 0;
+		frame_buffer.m_depth_id = 0;
+		frame_buffer.m_isComplete = false;
+	}
+
+	void FrameBuffer::bind() const {
+		glBindFramebuffer(GL_FRAMEBUFFER, m_id);
+	}
+
+	void FrameBuffer::unbind() {
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	FrameBuffer::~FrameBuffer() {
+		glDeleteRenderbuffers(1, &m_color_id);
+		glDeleteRenderbuffers(1, &m_depth_id);
+		glDeleteFramebuffers(1, &m_id);
+	}
+}
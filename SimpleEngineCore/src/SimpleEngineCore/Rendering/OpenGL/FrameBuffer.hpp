@@ -0,0 +1,29 @@
+#pragma once
+
+namespace SimpleEngine {
+
+	class FrameBuffer {
+	public:
+		FrameBuffer(const unsigned int width, const unsigned int height);
+		~FrameBuffer();
+
+		FrameBuffer(const FrameBuffer&) = delete;
+		FrameBuffer& operator=(const FrameBuffer&) = delete;
+		FrameBuffer& operator=(FrameBuffer&& frame_buffer) noexcept;
+		FrameBuffer(FrameBuffer&& frame_buffer) noexcept;
+
+		void bind() const;
+		static void unbind();
+		bool is_complete() const { return m_isComplete; }
+		unsigned int get_width() const { return m_width; }
+		unsigned int get_height() const { return m_height; }
+
+	private:
+		unsigned int m_id = 0;
+		unsigned int m_color_id = 0;
+		unsigned int m_depth_id = 0;
+		unsigned int m_width = 0;
+		unsigned int m_height = 0;
+		bool m_isComplete = false;
+	};
+}
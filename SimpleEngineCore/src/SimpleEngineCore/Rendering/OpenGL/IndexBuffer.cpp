@@ -1,6 +1,8 @@
 #include "IndexBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
 #include <glad/glad.h>
 #include <iostream>
+#include <cstring>
 
 namespace SimpleEngine {
 
@@ -10,46 +12,106 @@ namespace SimpleEngine {
             case VertexBuffer::EUsage::Static:  return GL_STATIC_DRAW;
             case VertexBuffer::EUsage::Dynamic: return GL_DYNAMIC_DRAW;
             case VertexBuffer::EUsage::Stream:  return GL_STREAM_DRAW;
+            case VertexBuffer::EUsage::Persistent: return GL_STREAM_DRAW;
         }
 
         std::cout << "Unknown VertexBuffer usage";
         return GL_STREAM_DRAW;
     }
 
-    IndexBuffer::IndexBuffer(const void* data, const size_t count, const VertexBuffer::EUsage usage)
-        : m_count(count) {
+    IndexBuffer::IndexBuffer(const void* data, const size_t count, const VertexBuffer::EUsage usage, const EType type)
+        : m_count(count)
+        , m_usage(usage)
+        , m_type(type) {
 
+        //Через GL_COPY_WRITE_BUFFER, чтобы не подменить индексы у VAO, привязанного в этот момент
         glGenBuffers(1, &m_id);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(GLuint), data, usage_to_GLenum(usage));
+        if (usage == VertexBuffer::EUsage::Persistent && GLAD_GL_VERSION_4_4) {
+            m_pMappedData = Renderer_OpenGL::create_persistent_storage(EBufferTarget::CopyWrite, m_id, data, count * get_index_size());
+            return;
+        }
+        Renderer_OpenGL::bind_buffer(EBufferTarget::CopyWrite, m_id);
+        glBufferData(GL_COPY_WRITE_BUFFER, count * get_index_size(), data, usage_to_GLenum(usage));
     }
 
     IndexBuffer& IndexBuffer::operator=(IndexBuffer&& index_buffer) noexcept {
 
         m_id = index_buffer.m_id;
         m_count = index_buffer.m_count;
+        m_usage = index_buffer.m_usage;
+        m_type = index_buffer.m_type;
+        m_pMappedData = index_buffer.m_pMappedData;
         index_buffer.m_id = 0;
         index_buffer.m_count = 0;
+        index_buffer.m_pMappedData = nullptr;
         return *this;
     }
 
     IndexBuffer::IndexBuffer(IndexBuffer&& index_buffer) noexcept
         : m_id(index_buffer.m_id)
-        , m_count(index_buffer.m_count) {
+        , m_count(index_buffer.m_count)
+        , m_usage(index_buffer.m_usage)
+        , m_type(index_buffer.m_type)
+        , m_pMappedData(index_buffer.m_pMappedData) {
 
         index_buffer.m_id = 0;
         index_buffer.m_count = 0;
+        index_buffer.m_pMappedData = nullptr;
     }
 
     void IndexBuffer::bind() const {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+        Renderer_OpenGL::bind_buffer(EBufferTarget::ElementArray, m_id);
     }
 
     void IndexBuffer::unbind() {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        Renderer_OpenGL::bind_buffer(EBufferTarget::ElementArray, 0);
+    }
+
+    void IndexBuffer::update_buffer(const void* data, const size_t count) const {
+
+        if (count > m_count) {
+            std::cout << "IndexBuffer::update_buffer: " << count << " indexes don't fit into " << m_count << "\n";
+            return;
+        }
+
+        if (m_pMappedData) {
+            std::memcpy(m_pMappedData, data, count * get_index_size());
+            return;
+        }
+
+        Renderer_OpenGL::bind_buffer(EBufferTarget::CopyWrite, m_id);
+        if (m_usage != VertexBuffer::EUsage::Static)
+            glBufferData(GL_COPY_WRITE_BUFFER, m_count * get_index_size(), nullptr, usage_to_GLenum(m_usage));
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, count * get_index_size(), data);
+    }
+
+    void IndexBuffer::update_buffer_range(const void* data, const size_t count, const size_t first_index) const {
+
+        if (first_index + count > m_count) {
+            std::cout << "IndexBuffer::update_buffer_range: [" << first_index << ", " << first_index + count << ") doesn't fit into " << m_count << "\n";
+            return;
+        }
+
+        if (m_pMappedData) {
+            std::memcpy(static_cast<uint8_t*>(m_pMappedData) + first_index * get_index_size(), data, count * get_index_size());
+            return;
+        }
+
+        Renderer_OpenGL::bind_buffer(EBufferTarget::CopyWrite, m_id);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, first_index * get_index_size(), count * get_index_size(), data);
+    }
+
+    void IndexBuffer::orphan() const {
+
+        if (m_pMappedData || m_usage == VertexBuffer::EUsage::Static)
+            return;
+
+        Renderer_OpenGL::bind_buffer(EBufferTarget::CopyWrite, m_id);
+        glBufferData(GL_COPY_WRITE_BUFFER, m_count * get_index_size(), nullptr, usage_to_GLenum(m_usage));
     }
 
     IndexBuffer::~IndexBuffer() {
+        Renderer_OpenGL::on_buffer_deleted(m_id);
         glDeleteBuffers(1, &m_id);
     }
 }
\ No newline at end of file
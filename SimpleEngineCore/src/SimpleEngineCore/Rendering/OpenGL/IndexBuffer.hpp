@@ -6,7 +6,14 @@ namespace SimpleEngine {
     class IndexBuffer {
     public:
 
-        IndexBuffer(const void* data, const size_t count, const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static);
+        //UnsignedShort - вдвое меньше памяти и чтения для мешей до 65536 вершин
+        enum class EType {
+
+            UnsignedShort,
+            UnsignedInt
+        };
+
+        IndexBuffer(const void* data, const size_t count, const VertexBuffer::EUsage usage = VertexBuffer::EUsage::Static, const EType type = EType::UnsignedInt);
         ~IndexBuffer();
 
         IndexBuffer(const IndexBuffer&) = delete;
@@ -16,11 +23,20 @@ namespace SimpleEngine {
 
         void bind() const;
         static void unbind();
+        void update_buffer(const void* data, const size_t count) const;
+        void update_buffer_range(const void* data, const size_t count, const size_t first_index) const;
+        void orphan() const;
+        void* get_mapped_data() const { return m_pMappedData; }
         size_t get_count() const { return m_count; }
+        EType get_type() const { return m_type; }
+        size_t get_index_size() const { return m_type == EType::UnsignedShort ? sizeof(uint16_t) : sizeof(uint32_t); }
 
     private:
         unsigned int m_id = 0;
         size_t m_count;
+        VertexBuffer::EUsage m_usage;
+        EType m_type;
+        void* m_pMappedData = nullptr;
     };
 
 }
\ No newline at end of file
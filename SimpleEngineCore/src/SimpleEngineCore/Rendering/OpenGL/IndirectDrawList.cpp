@@ -0,0 +1,70 @@
+#include "IndirectDrawList.hpp"
+#include "Renderer_OpenGL.hpp"
+#include <glad/glad.h>
+
+namespace SimpleEngine {
+
+	IndirectDrawList::~IndirectDrawList() {
+
+		Renderer_OpenGL::on_buffer_deleted(m_commands_buffer_id);
+		Renderer_OpenGL::on_buffer_deleted(m_draw_data_buffer_id);
+		glDeleteBuffers(1, &m_commands_buffer_id);
+		glDeleteBuffers(1, &m_draw_data_buffer_id);
+	}
+
+	void IndirectDrawList::add(const MeshHandle& mesh_handle, const glm::mat4& model_matrix, const glm::vec4& color) {
+
+		if (!mesh_handle.is_valid())
+			return;
+
+		m_commands.push_back({ mesh_handle.indexes_count, 1, mesh_handle.first_index, mesh_handle.base_vertex, 0 });
+		m_draw_data.push_back({ model_matrix, color });
+		m_triangles_count += mesh_handle.indexes_count / 3;
+	}
+
+	void IndirectDrawList::clear() {
+
+		m_commands.clear();
+		m_draw_data.clear();
+		m_triangles_count = 0;
+	}
+
+	void IndirectDrawList::upload() {
+
+		if (m_commands_buffer_id == 0) {
+			glGenBuffers(1, &m_commands_buffer_id);
+			glGenBuffers(1, &m_draw_data_buffer_id);
+		}
+
+		//Пересоздаём хранилище, только если список вырос
+		const bool reallocate = m_commands.size() > m_capacity;
+		if (reallocate)
+			m_capacity = m_commands.size();
+
+		Renderer_OpenGL::bind_buffer(EBufferTarget::DrawIndirect, m_commands_buffer_id);
+		if (reallocate)
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, m_capacity * sizeof(DrawElementsIndirectCommand), nullptr, GL_STATIC_DRAW);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_commands.size() * sizeof(DrawElementsIndirectCommand), m_commands.data());
+
+		Renderer_OpenGL::bind_buffer(EBufferTarget::ShaderStorage, m_draw_data_buffer_id);
+		if (reallocate)
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity * sizeof(DrawData), nullptr, GL_STATIC_DRAW);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_draw_data.size() * sizeof(DrawData), m_draw_data.data());
+
+		m_uploaded_draws_count = m_commands.size();
+		m_uploaded_triangles_count = m_triangles_count;
+	}
+
+	void IndirectDrawList::draw(const MeshArena& mesh_arena) const {
+
+		if (m_uploaded_draws_count == 0)
+			return;
+
+		Renderer_OpenGL::bind_buffer(EBufferTarget::DrawIndirect, m_commands_buffer_id);
+		//glBindBufferBase меняет и общую точку GL_SHADER_STORAGE_BUFFER - держим кэш в курсе
+		Renderer_OpenGL::bind_buffer(EBufferTarget::ShaderStorage, m_draw_data_buffer_id);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, static_cast<GLuint>(ShaderStorageBinding::DrawData), m_draw_data_buffer_id);
+
+		Renderer_OpenGL::multi_draw_indirect(mesh_arena.get_vertex_array(), m_uploaded_draws_count, m_uploaded_triangles_count);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "MeshArena.hpp"
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Точки привязки shader storage блоков движка, шейдер объявляет их через layout(binding = N)
+	enum class ShaderStorageBinding : unsigned int {
+
+		DrawData = 0
+	};
+
+	//Раскладка std430 совпадает с блоком в шейдерах:
+	//struct DrawData { mat4 model_matrix; vec4 color; };
+	//layout(std430, binding = 0) readonly buffer DrawDataBuffer { DrawData draws[]; };
+	struct DrawData {
+
+		glm::mat4 model_matrix;
+		glm::vec4 color;
+	};
+
+	//Список отрисовок мешей одной MeshArena: команды glMultiDrawElementsIndirect + данные объектов в SSBO.
+	//Шейдер достаёт данные своего объекта как draws[gl_DrawID]. Для статических сцен upload() делается один раз.
+	class IndirectDrawList {
+	public:
+		IndirectDrawList() = default;
+		~IndirectDrawList();
+
+		IndirectDrawList(const IndirectDrawList&) = delete;
+		IndirectDrawList& operator=(const IndirectDrawList&) = delete;
+
+		void add(const MeshHandle& mesh_handle, const glm::mat4& model_matrix, const glm::vec4& color = glm::vec4(1.f));
+		void clear();
+		//Заливает команды и данные объектов в GPU буферы
+		void upload();
+		//Шейдер уже должен быть привязан
+		void draw(const MeshArena& mesh_arena) const;
+
+		size_t get_draws_count() const { return m_commands.size(); }
+		size_t get_triangles_count() const { return m_triangles_count; }
+
+	private:
+		//Раскладка задана OpenGL (DrawElementsIndirectCommand)
+		struct DrawElementsIndirectCommand {
+
+			unsigned int count;
+			unsigned int instance_count;
+			unsigned int first_index;
+			int base_vertex;
+			unsigned int base_instance;
+		};
+
+		std::vector<DrawElementsIndirectCommand> m_commands;
+		std::vector<DrawData> m_draw_data;
+		size_t m_triangles_count = 0;
+
+		unsigned int m_commands_buffer_id = 0;
+		unsigned int m_draw_data_buffer_id = 0;
+		size_t m_uploaded_draws_count = 0;
+		size_t m_uploaded_triangles_count = 0;
+		size_t m_capacity = 0;
+	};
+}
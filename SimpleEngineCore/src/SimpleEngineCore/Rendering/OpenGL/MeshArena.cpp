@@ -0,0 +1,41 @@
+#include "MeshArena.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include <iostream>
+
+namespace SimpleEngine {
+
+	MeshArena::MeshArena(BufferLayout buffer_layout, const size_t max_vertices, const size_t max_indexes)
+		: m_stride(buffer_layout.get_stride())
+		, m_max_vertices(max_vertices)
+		, m_max_indexes(max_indexes) {
+
+		m_pVertexArray = std::make_unique<VertexArray>();
+		m_pVertexBuffer = std::make_unique<VertexBuffer>(nullptr, max_vertices * m_stride, std::move(buffer_layout));
+		m_pIndexBuffer = std::make_unique<IndexBuffer>(nullptr, max_indexes);
+		m_pVertexArray->add_vertex_buffer(*m_pVertexBuffer);
+		m_pVertexArray->set_index_buffer(*m_pIndexBuffer);
+	}
+
+	MeshArena::~MeshArena() = default;
+
+	MeshHandle MeshArena::add_mesh(const void* vertices, const size_t vertices_count, const unsigned int* indexes, const size_t indexes_count) {
+
+		if (m_vertices_count + vertices_count > m_max_vertices || m_indexes_count + indexes_count > m_max_indexes) {
+			std::cout << "MeshArena::add_mesh: mesh of " << vertices_count << " vertices and " << indexes_count << " indexes doesn't fit\n";
+			return MeshHandle();
+		}
+
+		m_pVertexBuffer->update_buffer_range(vertices, vertices_count * m_stride, m_vertices_count * m_stride);
+		m_pIndexBuffer->update_buffer_range(indexes, indexes_count, m_indexes_count);
+
+		MeshHandle mesh_handle;
+		mesh_handle.first_index = static_cast<unsigned int>(m_indexes_count);
+		mesh_handle.indexes_count = static_cast<unsigned int>(indexes_count);
+		mesh_handle.base_vertex = static_cast<int>(m_vertices_count);
+
+		m_vertices_count += vertices_count;
+		m_indexes_count += indexes_count;
+		return mesh_handle;
+	}
+}
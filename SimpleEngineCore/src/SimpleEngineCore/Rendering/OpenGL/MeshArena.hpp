@@ -0,0 +1,47 @@
+#pragma once
+#include "VertexBuffer.hpp"
+#include <memory>
+
+namespace SimpleEngine {
+
+	class IndexBuffer;
+	class VertexArray;
+
+	//Положение меша внутри общих буферов арены - ровно то, что нужно команде glMultiDrawElementsIndirect
+	struct MeshHandle {
+
+		unsigned int first_index = 0;
+		unsigned int indexes_count = 0;//0 - меш не поместился
+		int base_vertex = 0;
+
+		bool is_valid() const { return indexes_count != 0; }
+	};
+
+	//Статические меши с одинаковой раскладкой вершин, сложенные в один VertexBuffer/IndexBuffer под одним VAO
+	class MeshArena {
+	public:
+		MeshArena(BufferLayout buffer_layout, const size_t max_vertices, const size_t max_indexes);
+		~MeshArena();
+
+		MeshArena(const MeshArena&) = delete;
+		MeshArena& operator=(const MeshArena&) = delete;
+
+		//vertices - vertices_count вершин в раскладке арены, индексы локальные для меша
+		MeshHandle add_mesh(const void* vertices, const size_t vertices_count, const unsigned int* indexes, const size_t indexes_count);
+
+		const VertexArray& get_vertex_array() const { return *m_pVertexArray; }
+		size_t get_vertices_count() const { return m_vertices_count; }
+		size_t get_indexes_count() const { return m_indexes_count; }
+
+	private:
+		std::unique_ptr<VertexBuffer> m_pVertexBuffer;
+		std::unique_ptr<IndexBuffer> m_pIndexBuffer;
+		std::unique_ptr<VertexArray> m_pVertexArray;
+
+		size_t m_stride;
+		size_t m_max_vertices;
+		size_t m_max_indexes;
+		size_t m_vertices_count = 0;
+		size_t m_indexes_count = 0;
+	};
+}
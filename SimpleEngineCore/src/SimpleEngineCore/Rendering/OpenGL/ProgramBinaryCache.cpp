@@ -0,0 +1,200 @@
+#include "ProgramBinaryCache.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "SimpleEngineCore/Timing.hpp"
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace SimpleEngine {
+
+	std::string ProgramBinaryCache::s_directory;
+	uint64_t ProgramBinaryCache::s_driver_hash = 0;
+	ProgramBinaryCache::Statistics ProgramBinaryCache::s_statistics;
+
+	struct ProgramBinaryHeader {
+
+		static constexpr uint32_t magic_value = 0x42504553;//"SEPB"
+		static constexpr uint32_t current_version = 1;
+
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		uint32_t binary_format;
+		uint32_t binary_size;
+	};
+
+	static uint64_t hash_fnv1a(const char* data, uint64_t hash = 14695981039346656037ull) {
+
+		//Терминирующий ноль тоже хешируется - иначе "ab" + "c" и "a" + "bc" совпали бы
+		do {
+			hash ^= static_cast<uint8_t>(*data);
+			hash *= 1099511628211ull;
+		} while (*data++);
+		return hash;
+	}
+
+	static const char* get_gl_string(const char* value) {
+
+		return value ? value : "";
+	}
+
+	bool ProgramBinaryCache::open(const std::string& directory) {
+
+		close();
+		if (directory.empty())
+			return false;
+
+		GLint formats_count = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats_count);
+		if (formats_count <= 0) {
+			std::cout << "Program binary cache: driver has no program binary formats, shaders are compiled from source\n";
+			return false;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error) {
+			std::cerr << "Program binary cache: can't create " << directory << ": " << error.message() << "\n";
+			return false;
+		}
+
+		const std::string driver = std::string(get_gl_string(Renderer_OpenGL::get_vendor_str())) + "\n"
+			+ get_gl_string(Renderer_OpenGL::get_renderer_str()) + "\n" + get_gl_string(Renderer_OpenGL::get_version_str()) + "\n";
+
+		//Бинарники чужого драйвера он не примет - и в имени файла их ключ уже никогда не совпадёт, так что просто удаляем
+		const std::filesystem::path driver_path = std::filesystem::path(directory) / "driver.txt";
+		std::ifstream driver_stream(driver_path, std::ios::binary);
+		std::stringstream cached_driver;
+		cached_driver << driver_stream.rdbuf();
+		driver_stream.close();
+		if (cached_driver.str() != driver) {
+
+			for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error)) {
+				if (entry.path().extension() == ".glbin" && std::filesystem::remove(entry.path(), error))
+					++s_statistics.invalidated_files;
+			}
+			std::ofstream(driver_path, std::ios::binary | std::ios::trunc) << driver;
+		}
+
+		s_directory = directory;
+		s_driver_hash = hash_fnv1a(driver.c_str());
+		return true;
+	}
+
+	void ProgramBinaryCache::close() {
+
+		s_directory.clear();
+		s_driver_hash = 0;
+	}
+
+	uint64_t ProgramBinaryCache::make_key(const char* vertex_shader_src, const char* fragment_shader_src) {
+
+		return hash_fnv1a(fragment_shader_src, hash_fnv1a(vertex_shader_src, s_driver_hash));
+	}
+
+	std::string ProgramBinaryCache::get_path(const uint64_t key) {
+
+		char name[32];
+		std::snprintf(name, sizeof(name), "%016llx.glbin", static_cast<unsigned long long>(key));
+		return (std::filesystem::path(s_directory) / name).string();
+	}
+
+	bool ProgramBinaryCache::load(const uint64_t key, const unsigned int program_id) {
+
+		if (!is_enabled())
+			return false;
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const std::string path = get_path(key);
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) {
+			++s_statistics.misses;
+			s_statistics.load_ms += milliseconds_since(start_time);
+			return false;
+		}
+
+		//Размер из заголовка сверяем с файлом до выделения: обрезанный или дописанный файл - не наш бинарник
+		std::error_code size_error;
+		const uintmax_t file_size = std::filesystem::file_size(path, size_error);
+		ProgramBinaryHeader header;
+		std::vector<char> binary;
+		bool valid = !size_error && stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+			&& header.magic == ProgramBinaryHeader::magic_value && header.version == ProgramBinaryHeader::current_version
+			&& header.key == key && header.binary_size > 0 && sizeof(header) + static_cast<uintmax_t>(header.binary_size) == file_size;
+		if (valid) {
+			binary.resize(header.binary_size);
+			valid = static_cast<bool>(stream.read(binary.data(), binary.size()));
+		}
+		stream.close();
+
+		GLint success = GL_FALSE;
+		if (valid) {
+			glProgramBinary(program_id, header.binary_format, binary.data(), static_cast<GLsizei>(binary.size()));
+			glGetProgramiv(program_id, GL_LINK_STATUS, &success);
+		}
+		if (success == GL_FALSE) {
+
+			//Битый файл или драйвер обновился без смены строк - собираем из исходников и перезаписываем
+			std::error_code error;
+			std::filesystem::remove(path, error);
+			++s_statistics.rejected;
+			++s_statistics.misses;
+			s_statistics.load_ms += milliseconds_since(start_time);
+			return false;
+		}
+
+		++s_statistics.hits;
+		s_statistics.bytes_loaded += binary.size();
+		s_statistics.load_ms += milliseconds_since(start_time);
+		return true;
+	}
+
+	void ProgramBinaryCache::store(const uint64_t key, const unsigned int program_id) {
+
+		if (!is_enabled())
+			return;
+
+		const auto start_time = std::chrono::steady_clock::now();
+		GLint binary_size = 0;
+		glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+		if (binary_size <= 0)
+			return;
+
+		std::vector<char> binary(static_cast<size_t>(binary_size));
+		GLsizei written_size = 0;
+		GLenum binary_format = 0;
+		glGetProgramBinary(program_id, binary_size, &written_size, &binary_format, binary.data());
+		if (written_size <= 0)
+			return;
+
+		const ProgramBinaryHeader header{ ProgramBinaryHeader::magic_value, ProgramBinaryHeader::current_version, key,
+										  binary_format, static_cast<uint32_t>(written_size) };
+		//Пишем во временный файл и переименовываем - параллельный запуск не прочитает файл наполовину
+		const std::string path = get_path(key);
+		const std::string temp_path = path + ".tmp";
+		{
+			std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+			stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			stream.write(binary.data(), written_size);
+			if (!stream) {
+				std::cerr << "Program binary cache: can't write " << temp_path << "\n";
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(temp_path, path, error);
+		if (error) {
+			std::filesystem::remove(temp_path, error);
+			return;
+		}
+
+		++s_statistics.stored;
+		s_statistics.bytes_stored += static_cast<size_t>(written_size);
+		s_statistics.store_ms += milliseconds_since(start_time);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace SimpleEngine {
+
+	//Кэш слинкованных программ на диске (glGetProgramBinary / glProgramBinary): файл на программу, имя - хеш
+	//исходников и строк драйвера. Бинарник, который драйвер не принял, удаляется, и программа собирается из исходников.
+	//Все вызовы - из потока с GL контекстом
+	class ProgramBinaryCache {
+	public:
+		struct Statistics {
+
+			size_t hits = 0;
+			size_t misses = 0;
+			size_t rejected = 0;//Файл был, но драйвер его не принял
+			size_t stored = 0;
+			size_t invalidated_files = 0;//Удалено при смене драйвера
+			size_t bytes_loaded = 0;
+			size_t bytes_stored = 0;
+			double load_ms = 0.0;//Чтение и glProgramBinary, включая неудачные попытки
+			double compile_ms = 0.0;//Компиляция и линковка из исходников; у ShaderCompiler - от submit до того, как poll забрал программу
+			double store_ms = 0.0;
+		};
+
+		//Пустой directory - кэш выключен. Если драйвер сменился с прошлого запуска, старые бинарники удаляются.
+		//false, если кэш не включился (нет форматов бинарников у драйвера, каталог не создаётся)
+		static bool open(const std::string& directory);
+		static void close();
+		static bool is_enabled() { return !s_directory.empty(); }
+
+		//FNV-1a 64 от исходников и строк драйвера
+		static uint64_t make_key(const char* vertex_shader_src, const char* fragment_shader_src);
+		//true - program_id слинкован из бинарника
+		static bool load(const uint64_t key, const unsigned int program_id);
+		//Программа должна быть слинкована с GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+		static void store(const uint64_t key, const unsigned int program_id);
+
+		static void on_program_compiled(const double compile_ms) { s_statistics.compile_ms += compile_ms; }
+		static const Statistics& get_statistics() { return s_statistics; }
+		static void reset_statistics() { s_statistics = Statistics(); }
+
+	private:
+		static std::string get_path(const uint64_t key);
+
+		static std::string s_directory;
+		static uint64_t s_driver_hash;
+		static Statistics s_statistics;
+	};
+}
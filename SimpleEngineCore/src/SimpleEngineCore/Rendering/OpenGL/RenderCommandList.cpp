@@ -0,0 +1,85 @@
+#include "RenderCommandList.hpp"
+
+#include <imgui/imgui.h>
+#include <imgui/backends/imgui_impl_opengl3.h>
+
+namespace SimpleEngine {
+
+	RenderCommandList::~RenderCommandList() {
+
+		release_ui_draw_data();
+	}
+
+	void RenderCommandList::begin(const glm::mat4& view_matrix) {
+
+		m_bViewportChanged = false;
+		m_bCameraChanged = false;
+		m_commands.clear();
+		m_render_queue.begin(view_matrix);
+		release_ui_draw_data();
+	}
+
+	void RenderCommandList::set_viewport(const unsigned int width, const unsigned int height) {
+
+		m_viewport_width = width;
+		m_viewport_height = height;
+		m_bViewportChanged = true;
+	}
+
+	void RenderCommandList::set_camera_data(const CameraData& camera_data) {
+
+		m_camera_data = camera_data;
+		m_bCameraChanged = true;
+	}
+
+	bool RenderCommandList::get_viewport(unsigned int& width, unsigned int& height) const {
+
+		width = m_viewport_width;
+		height = m_viewport_height;
+		return m_bViewportChanged;
+	}
+
+	void RenderCommandList::set_ui_draw_data(ImDrawData* pDrawData, const bool copy) {
+
+		release_ui_draw_data();
+		if (!pDrawData || !copy) {
+
+			m_pUiDrawData = pDrawData;
+			return;
+		}
+
+		//Следующий ImGui::NewFrame() перезапишет списки контекста - забираем себе их вершины и команды
+		m_pUiDrawData = IM_NEW(ImDrawData)();
+		*m_pUiDrawData = *pDrawData;
+		for (ImDrawList*& pDrawList : m_pUiDrawData->CmdLists) {
+			pDrawList = pDrawList->CloneOutput();
+		}
+		m_bUiDrawDataOwned = true;
+	}
+
+	void RenderCommandList::execute_commands() {
+
+		for (const std::function<void()>& command : m_commands) {
+			command();
+		}
+	}
+
+	void RenderCommandList::execute_ui() {
+
+		if (m_pUiDrawData)
+			ImGui_ImplOpenGL3_RenderDrawData(m_pUiDrawData);
+	}
+
+	void RenderCommandList::release_ui_draw_data() {
+
+		if (m_bUiDrawDataOwned) {
+
+			for (ImDrawList* pDrawList : m_pUiDrawData->CmdLists) {
+				IM_DELETE(pDrawList);
+			}
+			IM_DELETE(m_pUiDrawData);
+		}
+		m_pUiDrawData = nullptr;
+		m_bUiDrawDataOwned = false;
+	}
+}
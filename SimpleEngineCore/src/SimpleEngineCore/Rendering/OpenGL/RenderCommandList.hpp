@@ -0,0 +1,56 @@
+#pragma once
+#include "RenderQueue.hpp"
+#include "UniformBuffer.hpp"
+#include <glm/vec4.hpp>
+#include <functional>
+#include <vector>
+
+struct ImDrawData;
+
+namespace SimpleEngine {
+
+	//Всё, что нужно GL для одного кадра, записанное заранее: очистка, вьюпорт, данные камеры,
+	//очередь отрисовки, произвольные команды и копия UI. Записывается в одном потоке, выполняется в другом
+	class RenderCommandList {
+	public:
+		RenderCommandList() = default;
+		~RenderCommandList();
+		RenderCommandList(const RenderCommandList&) = delete;
+		RenderCommandList& operator=(const RenderCommandList&) = delete;
+
+		//Сбрасывает прошлый кадр, включая копию UI
+		void begin(const glm::mat4& view_matrix);
+
+		void set_clear_color(const glm::vec4& clear_color) { m_clear_color = clear_color; }
+		void set_viewport(const unsigned int width, const unsigned int height);
+		//Без вызова камера в кадре остаётся прежней
+		void set_camera_data(const CameraData& camera_data);
+		//Выполняется после очистки и заливки камеры, до очереди - в порядке добавления
+		void add_command(std::function<void()> command) { m_commands.push_back(std::move(command)); }
+		RenderQueue& get_render_queue() { return m_render_queue; }
+		//copy == false - хранится только указатель, данные ImGui должны дожить до execute_ui()
+		void set_ui_draw_data(ImDrawData* pDrawData, const bool copy);
+
+		const glm::vec4& get_clear_color() const { return m_clear_color; }
+		bool get_viewport(unsigned int& width, unsigned int& height) const;
+		//nullptr - камера не менялась
+		const CameraData* get_camera_data() const { return m_bCameraChanged ? &m_camera_data : nullptr; }
+		void execute_commands();
+		void execute_ui();
+
+	private:
+		void release_ui_draw_data();
+
+		glm::vec4 m_clear_color{ 0.f };
+		bool m_bViewportChanged = false;
+		unsigned int m_viewport_width = 0;
+		unsigned int m_viewport_height = 0;
+		bool m_bCameraChanged = false;
+		CameraData m_camera_data;
+		std::vector<std::function<void()>> m_commands;
+		RenderQueue m_render_queue;
+
+		ImDrawData* m_pUiDrawData = nullptr;
+		bool m_bUiDrawDataOwned = false;
+	};
+}
@@ -0,0 +1,120 @@
+#include "RenderQueue.hpp"
+#include "ShaderProgram.hpp"
+#include "VertexArray.hpp"
+#include "Renderer_OpenGL.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace SimpleEngine {
+
+	constexpr UniformName model_matrix_uniform("model_matrix");
+	constexpr UniformName material_color_uniform("material_color");
+
+	//Положительные float'ы как uint32 сравниваются так же, как числа.
+	//Старшие 24 бита - этого достаточно для порядка по глубине.
+	static uint32_t depth_to_bits(const float depth) {
+
+		const float clamped_depth = std::max(depth, 0.f);
+		uint32_t bits;
+		std::memcpy(&bits, &clamped_depth, sizeof(bits));
+		return bits >> 7;
+	}
+
+	uint64_t RenderQueue::make_sort_key(const unsigned int pass, const bool translucent, const unsigned int shader_program_id,
+										const unsigned int vertex_array_id, const unsigned int material_id, const float depth) {
+
+		//pass:3 | translucent:1 | 60 бит на состояние и глубину
+		//id обрезаются до 12 бит: совпадение даёт лишь неидеальный порядок, рисуется всё равно правильно
+		const uint64_t pass_bits = static_cast<uint64_t>(pass & 0x7) << 61;
+		const uint64_t shader_bits = shader_program_id & 0xFFF;
+		const uint64_t vertex_array_bits = vertex_array_id & 0xFFF;
+		const uint64_t material_bits = material_id & 0xFFF;
+		const uint64_t depth_bits = depth_to_bits(depth) & 0xFFFFFF;
+
+		if (!translucent) {
+			//shader:12 | vao:12 | material:12 | depth:24 - минимум переключений, внутри - спереди назад для early-z
+			return pass_bits | (shader_bits << 48) | (vertex_array_bits << 36) | (material_bits << 24) | depth_bits;
+		}
+
+		//depth:24 (инвертирована - сзади вперёд) | shader:12 | vao:12 | material:12
+		return pass_bits | (1ull << 60) | ((0xFFFFFF - depth_bits) << 36) | (shader_bits << 24) | (vertex_array_bits << 12) | material_bits;
+	}
+
+	void RenderQueue::begin(const glm::mat4& view_matrix) {
+
+		m_view_matrix = view_matrix;
+		m_items.clear();
+		m_sort_entries.clear();
+		m_statistics = Statistics();
+	}
+
+	void RenderQueue::submit(const ShaderProgram& shader_program, const VertexArray& vertex_array, const Material& material,
+							 const glm::mat4& model_matrix, const unsigned int pass, const uint32_t first_index, const uint32_t indexes_count) {
+
+		//Глубина - расстояние до начала координат объекта вдоль взгляда камеры
+		const float view_z = m_view_matrix[0][2] * model_matrix[3][0]
+						   + m_view_matrix[1][2] * model_matrix[3][1]
+						   + m_view_matrix[2][2] * model_matrix[3][2]
+						   + m_view_matrix[3][2];
+
+		m_sort_entries.push_back({ make_sort_key(pass, material.translucent, shader_program.get_id(), vertex_array.get_id(), material.id, -view_z),
+								   static_cast<uint32_t>(m_items.size()) });
+		m_items.push_back({ &shader_program, &vertex_array, &material, model_matrix, first_index, indexes_count });
+	}
+
+	void RenderQueue::execute() {
+
+		std::sort(m_sort_entries.begin(), m_sort_entries.end(),
+			[](const SortEntry& lhs, const SortEntry& rhs) { return lhs.key < rhs.key; });
+
+		const ShaderProgram* current_shader_program = nullptr;
+		const VertexArray* current_vertex_array = nullptr;
+		const Material* current_material = nullptr;
+		int model_matrix_location = -1;
+		int material_color_location = -1;
+
+		Renderer_OpenGL::set_depth_test(true);
+		for (const SortEntry& entry : m_sort_entries) {
+
+			const RenderItem& item = m_items[entry.item_index];
+
+			if (item.shader_program != current_shader_program) {
+
+				current_shader_program = item.shader_program;
+				current_shader_program->bind();
+				model_matrix_location = current_shader_program->get_uniform_location(model_matrix_uniform);
+				material_color_location = current_shader_program->get_uniform_location(material_color_uniform);
+				//У новой программы свои юниформы - материал надо выставить заново
+				current_material = nullptr;
+				++m_statistics.shader_program_switches;
+			}
+
+			if (item.material != current_material) {
+
+				//Полупрозрачные не пишут глубину, чтобы не закрывать друг друга
+				Renderer_OpenGL::set_blend(item.material->translucent);
+				Renderer_OpenGL::set_depth_write(!item.material->translucent);
+				if (material_color_location >= 0)
+					current_shader_program->setVec4(material_color_location, item.material->color);
+				current_material = item.material;
+				++m_statistics.material_switches;
+			}
+
+			if (item.vertex_array != current_vertex_array) {
+
+				current_vertex_array = item.vertex_array;
+				++m_statistics.vertex_array_switches;
+			}
+
+			current_shader_program->setMatrix4(model_matrix_location, item.model_matrix);
+			if (item.indexes_count == 0)
+				Renderer_OpenGL::draw(*item.vertex_array);
+			else
+				Renderer_OpenGL::draw(*item.vertex_array, item.indexes_count, item.first_index, 0);
+		}
+
+		Renderer_OpenGL::set_blend(false);
+		Renderer_OpenGL::set_depth_write(true);
+		m_statistics.items = static_cast<unsigned int>(m_items.size());
+	}
+}
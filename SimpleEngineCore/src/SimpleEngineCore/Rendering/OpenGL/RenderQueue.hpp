@@ -0,0 +1,68 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace SimpleEngine {
+
+	class ShaderProgram;
+	class VertexArray;
+
+	//Параметры, общие для группы объектов. id участвует в ключе сортировки, color уходит в юниформ material_color
+	struct Material {
+
+		unsigned int id = 0;
+		glm::vec4 color{ 1.f };
+		bool translucent = false;
+	};
+
+	//Объекты копятся за кадр, сортируются по 64-битному ключу и только потом рисуются
+	class RenderQueue {
+	public:
+		struct Statistics {
+
+			unsigned int items = 0;
+			unsigned int shader_program_switches = 0;
+			unsigned int vertex_array_switches = 0;
+			unsigned int material_switches = 0;
+		};
+
+		//view_matrix нужна для глубины объекта: непрозрачные рисуются спереди назад, полупрозрачные - сзади вперёд
+		void begin(const glm::mat4& view_matrix);
+		//Хранятся указатели: программа, VAO и материал должны жить до execute().
+		//indexes_count == 0 - все индексы VAO, иначе диапазон с first_index (например, один LOD)
+		void submit(const ShaderProgram& shader_program, const VertexArray& vertex_array, const Material& material,
+					const glm::mat4& model_matrix, const unsigned int pass = 0, const uint32_t first_index = 0, const uint32_t indexes_count = 0);
+		void execute();
+
+		const Statistics& get_statistics() const { return m_statistics; }
+		size_t get_items_count() const { return m_items.size(); }
+
+		//Старшие биты - проход и прозрачность, дальше для непрозрачных состояние, потом глубина
+		static uint64_t make_sort_key(const unsigned int pass, const bool translucent, const unsigned int shader_program_id,
+									  const unsigned int vertex_array_id, const unsigned int material_id, const float depth);
+
+	private:
+		struct RenderItem {
+
+			const ShaderProgram* shader_program;
+			const VertexArray* vertex_array;
+			const Material* material;
+			glm::mat4 model_matrix;
+			uint32_t first_index;
+			uint32_t indexes_count;
+		};
+
+		struct SortEntry {
+
+			uint64_t key;
+			uint32_t item_index;
+		};
+
+		glm::mat4 m_view_matrix{ 1.f };
+		std::vector<RenderItem> m_items;
+		std::vector<SortEntry> m_sort_entries;
+		Statistics m_statistics;
+	};
+}
@@ -2,15 +2,70 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "VertexArray.hpp"
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 namespace SimpleEngine {
 
+	Renderer_OpenGL::FrameStatistics Renderer_OpenGL::s_frame_statistics;
+	Renderer_OpenGL::StateCache Renderer_OpenGL::s_state_cache;
+	bool Renderer_OpenGL::s_parallel_shader_compile = false;
+
+	//glad сгенерирован без расширений - функцию KHR_parallel_shader_compile берём у GLFW сами
+	typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSPROC)(GLuint count);
+
+	static bool has_extension(const char* name) {
+
+		GLint extensions_count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &extensions_count);
+		for (GLint i = 0; i < extensions_count; ++i) {
+			const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+			if (extension && std::strcmp(extension, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	constexpr GLenum buffer_target_to_GLenum(const EBufferTarget target) {
+
+		switch (target) {
+			case EBufferTarget::Array:         return GL_ARRAY_BUFFER;
+			case EBufferTarget::ElementArray:  return GL_ELEMENT_ARRAY_BUFFER;
+			case EBufferTarget::Uniform:       return GL_UNIFORM_BUFFER;
+			case EBufferTarget::CopyWrite:     return GL_COPY_WRITE_BUFFER;
+			case EBufferTarget::DrawIndirect:  return GL_DRAW_INDIRECT_BUFFER;
+			case EBufferTarget::ShaderStorage: return GL_SHADER_STORAGE_BUFFER;
+			case EBufferTarget::PixelUnpack:   return GL_PIXEL_UNPACK_BUFFER;
+			case EBufferTarget::TargetsCount: break;
+		}
+
+		std::cout << "Unknown buffer target";
+		return GL_ARRAY_BUFFER;
+	}
+
+	constexpr GLenum index_type_to_GLenum(const IndexBuffer::EType type) {
+
+		return type == IndexBuffer::EType::UnsignedShort ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
+	Renderer_OpenGL::StateCache::StateCache() {
+
+		for (unsigned int& buffer : buffers)
+			buffer = unknown;
+		for (unsigned int& texture : textures)
+			texture = unknown;
+		for (float& component : clear_color)
+			component = std::numeric_limits<float>::quiet_NaN();
+		for (unsigned int& value : viewport)
+			value = unknown;
+	}
+
 	bool Renderer_OpenGL::init(GLFWwindow* pWindow) {
 
-		glfwMakeContextCurrent(pWindow);//   OpenGL
+		glfwMakeContextCurrent(pWindow);//Задаём текущим контекст OpenGL
 
-		// 
+		//Инициализируем ГЛАД
 		if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress))) {
 			std::cerr << "Failed to initialize GLAD" << "\n";
 			return false;
@@ -21,28 +76,221 @@ namespace SimpleEngine {
 		std::cout << "  Renderer: " << get_renderer_str() << "\n";
 		std::cout << "  Version: " << get_version_str() << "\n";
 
+		//Сколько потоков компилировать - решает драйвер (0xFFFFFFFF - без ограничения)
+		const bool khr_parallel_shader_compile = has_extension("GL_KHR_parallel_shader_compile");
+		s_parallel_shader_compile = khr_parallel_shader_compile || has_extension("GL_ARB_parallel_shader_compile");
+		if (s_parallel_shader_compile) {
+			const auto pMaxShaderCompilerThreads = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSPROC>(
+				glfwGetProcAddress(khr_parallel_shader_compile ? "glMaxShaderCompilerThreadsKHR" : "glMaxShaderCompilerThreadsARB"));
+			if (pMaxShaderCompilerThreads)
+				pMaxShaderCompilerThreads(0xFFFFFFFFu);
+		}
+		std::cout << "  Parallel shader compile: " << (s_parallel_shader_compile ? "yes" : "no") << "\n";
+
+		//Полупрозрачное смешивается обычным "over", включается через set_blend
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		//Новый контекст - ничего из закэшированного ещё не выставлено
+		invalidate_state_cache();
 		return true;
 	}
 
 	void Renderer_OpenGL::draw(const VertexArray& vertex_array) {
 
 		vertex_array.bind();
-		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.get_indexes_count()), GL_UNSIGNED_INT, nullptr);
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.get_indexes_count()), index_type_to_GLenum(vertex_array.get_index_type()), nullptr);
+		++s_frame_statistics.draw_calls;
+		s_frame_statistics.triangles += vertex_array.get_indexes_count() / 3;
+	}
+
+	void Renderer_OpenGL::draw(const VertexArray& vertex_array, const size_t indexes_count) {
+
+		vertex_array.bind();
+		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indexes_count), index_type_to_GLenum(vertex_array.get_index_type()), nullptr);
+		++s_frame_statistics.draw_calls;
+		s_frame_statistics.triangles += indexes_count / 3;
+	}
+
+	void Renderer_OpenGL::draw(const VertexArray& vertex_array, const size_t indexes_count, const size_t first_index, const int base_vertex) {
+
+		vertex_array.bind();
+		const size_t index_size = vertex_array.get_index_type() == IndexBuffer::EType::UnsignedShort ? sizeof(GLushort) : sizeof(GLuint);
+		glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(indexes_count), index_type_to_GLenum(vertex_array.get_index_type()),
+								 reinterpret_cast<const void*>(first_index * index_size), base_vertex);
+		++s_frame_statistics.draw_calls;
+		s_frame_statistics.triangles += indexes_count / 3;
+	}
+
+	void Renderer_OpenGL::draw_instanced(const VertexArray& vertex_array, const size_t instances_count) {
+
+		vertex_array.bind();
+		glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(vertex_array.get_indexes_count()), index_type_to_GLenum(vertex_array.get_index_type()), nullptr, static_cast<GLsizei>(instances_count));
+		++s_frame_statistics.draw_calls;
+		s_frame_statistics.triangles += vertex_array.get_indexes_count() / 3 * instances_count;
+	}
+
+	void Renderer_OpenGL::multi_draw_indirect(const VertexArray& vertex_array, const size_t draws_count, const size_t triangles_count) {
+
+		vertex_array.bind();
+		glMultiDrawElementsIndirect(GL_TRIANGLES, index_type_to_GLenum(vertex_array.get_index_type()), nullptr, static_cast<GLsizei>(draws_count), 0);
+		++s_frame_statistics.draw_calls;
+		s_frame_statistics.triangles += triangles_count;
 	}
 
 	void Renderer_OpenGL::set_clear_color(const float r, const float g, const float b, const float a) {
 
+		float* clear_color = s_state_cache.clear_color;
+		if (clear_color[0] == r && clear_color[1] == g && clear_color[2] == b && clear_color[3] == a) {
+			++s_frame_statistics.state_changes_elided;
+			return;
+		}
+
 		glClearColor(r, g, b, a);
+		clear_color[0] = r;
+		clear_color[1] = g;
+		clear_color[2] = b;
+		clear_color[3] = a;
+		++s_frame_statistics.state_changes;
 	}
 
 	void Renderer_OpenGL::clear() {
 
-		glClear(GL_COLOR_BUFFER_BIT);
+		//Маска глубины участвует в glClear - перед очисткой запись в буфер глубины должна быть включена
+		set_depth_write(true);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
 	void Renderer_OpenGL::set_viewport(const unsigned int width, const unsigned int height, const unsigned int left_offset, const unsigned int bottom_offset) {
 
+		unsigned int* viewport = s_state_cache.viewport;
+		if (viewport[0] == left_offset && viewport[1] == bottom_offset && viewport[2] == width && viewport[3] == height) {
+			++s_frame_statistics.state_changes_elided;
+			return;
+		}
+
 		glViewport(left_offset, bottom_offset, width, height);
+		viewport[0] = left_offset;
+		viewport[1] = bottom_offset;
+		viewport[2] = width;
+		viewport[3] = height;
+		++s_frame_statistics.state_changes;
+	}
+
+	bool Renderer_OpenGL::set_cached(unsigned int& cached_value, const unsigned int value) {
+
+		if (cached_value == value) {
+			++s_frame_statistics.state_changes_elided;
+			return false;
+		}
+
+		cached_value = value;
+		++s_frame_statistics.state_changes;
+		return true;
+	}
+
+	void Renderer_OpenGL::bind_shader_program(const unsigned int id) {
+
+		if (set_cached(s_state_cache.shader_program, id))
+			glUseProgram(id);
+	}
+
+	void Renderer_OpenGL::bind_vertex_array(const unsigned int id) {
+
+		if (set_cached(s_state_cache.vertex_array, id)) {
+			glBindVertexArray(id);
+			//GL_ELEMENT_ARRAY_BUFFER - часть состояния VAO, у нового VAO она своя
+			s_state_cache.buffers[static_cast<size_t>(EBufferTarget::ElementArray)] = StateCache::unknown;
+		}
+	}
+
+	void Renderer_OpenGL::bind_buffer(const EBufferTarget target, const unsigned int id) {
+
+		if (set_cached(s_state_cache.buffers[static_cast<size_t>(target)], id))
+			glBindBuffer(buffer_target_to_GLenum(target), id);
+	}
+
+	void Renderer_OpenGL::bind_texture(const unsigned int unit, const unsigned int id) {
+
+		if (!set_cached(s_state_cache.textures[unit], id))
+			return;
+		if (set_cached(s_state_cache.active_texture_unit, unit))
+			glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, id);
+	}
+
+	void* Renderer_OpenGL::create_persistent_storage(const EBufferTarget target, const unsigned int id, const void* data, const size_t size) {
+
+		constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLenum gl_target = buffer_target_to_GLenum(target);
+
+		bind_buffer(target, id);
+		glBufferStorage(gl_target, size, data, flags);
+		void* pMappedData = glMapBufferRange(gl_target, 0, size, flags);
+		if (!pMappedData) {
+			std::cerr << "Can't map persistent buffer storage of " << size << " bytes\n";
+		}
+		return pMappedData;
+	}
+
+	void Renderer_OpenGL::set_depth_test(const bool enabled) {
+
+		if (set_cached(s_state_cache.depth_test, enabled ? 1 : 0)) {
+			if (enabled)
+				glEnable(GL_DEPTH_TEST);
+			else
+				glDisable(GL_DEPTH_TEST);
+		}
+	}
+
+	void Renderer_OpenGL::set_blend(const bool enabled) {
+
+		if (set_cached(s_state_cache.blend, enabled ? 1 : 0)) {
+			if (enabled)
+				glEnable(GL_BLEND);
+			else
+				glDisable(GL_BLEND);
+		}
+	}
+
+	void Renderer_OpenGL::set_depth_write(const bool enabled) {
+
+		if (set_cached(s_state_cache.depth_write, enabled ? 1 : 0))
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+	}
+
+	void Renderer_OpenGL::invalidate_state_cache() {
+
+		s_state_cache = StateCache();
+	}
+
+	void Renderer_OpenGL::on_shader_program_deleted(const unsigned int id) {
+
+		if (s_state_cache.shader_program == id)
+			s_state_cache.shader_program = StateCache::unknown;
+	}
+
+	void Renderer_OpenGL::on_vertex_array_deleted(const unsigned int id) {
+
+		if (s_state_cache.vertex_array == id) {
+			s_state_cache.vertex_array = StateCache::unknown;
+			s_state_cache.buffers[static_cast<size_t>(EBufferTarget::ElementArray)] = StateCache::unknown;
+		}
+	}
+
+	void Renderer_OpenGL::on_buffer_deleted(const unsigned int id) {
+
+		for (unsigned int& buffer : s_state_cache.buffers) {
+			if (buffer == id)
+				buffer = StateCache::unknown;
+		}
+	}
+
+	void Renderer_OpenGL::on_texture_deleted(const unsigned int id) {
+
+		for (unsigned int& texture : s_state_cache.textures) {
+			if (texture == id)
+				texture = StateCache::unknown;
+		}
 	}
 
 	const char* Renderer_OpenGL::get_vendor_str() {
@@ -59,4 +307,9 @@ namespace SimpleEngine {
 
 		return reinterpret_cast<const char*>(glGetString(GL_VERSION));
 	}
-}
\ No newline at end of file
+
+	bool Renderer_OpenGL::has_current_context() {
+
+		return glfwGetCurrentContext() != nullptr;
+	}
+}
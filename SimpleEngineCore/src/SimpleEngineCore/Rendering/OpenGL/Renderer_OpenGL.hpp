@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 struct GLFWwindow;
 
@@ -6,11 +7,38 @@ namespace SimpleEngine {
 
 	class VertexArray;
 
+	enum class EBufferTarget {
+
+		Array = 0,
+		ElementArray,
+		Uniform,
+		CopyWrite,
+		DrawIndirect,
+		ShaderStorage,
+		PixelUnpack,//Источник для glTex(Sub)Image*: пока привязан, указатель на данные - смещение в буфере
+
+		TargetsCount
+	};
+
 	class Renderer_OpenGL {
 	public:
+		struct FrameStatistics {
+
+			unsigned int draw_calls = 0;
+			unsigned int state_changes = 0;//Реально выполненные glBind*/glUse*/glEnable* и т.п.
+			unsigned int state_changes_elided = 0;//Пропущенные кэшем, т.к. состояние уже такое
+			size_t triangles = 0;
+		};
+
 		static bool init(GLFWwindow* pWindow);
 
 		static void draw(const VertexArray& vertex_array);
+		static void draw(const VertexArray& vertex_array, const size_t indexes_count);
+		//Индексы читаются с first_index, к каждому прибавляется base_vertex (данные в кольцевых буферах)
+		static void draw(const VertexArray& vertex_array, const size_t indexes_count, const size_t first_index, const int base_vertex);
+		static void draw_instanced(const VertexArray& vertex_array, const size_t instances_count);
+		//Команды берутся из привязанного EBufferTarget::DrawIndirect буфера, начиная с нулевого смещения
+		static void multi_draw_indirect(const VertexArray& vertex_array, const size_t draws_count, const size_t triangles_count);
 		static void set_clear_color(const float r, const float g, const float b, const float a);
 		static void clear();
 		static void set_viewport(const unsigned int width, const unsigned int height, const unsigned int left_offset = 0, const unsigned int bottom_offset = 0);
@@ -18,5 +46,59 @@ namespace SimpleEngine {
 		static const char* get_vendor_str();
 		static const char* get_renderer_str();
 		static const char* get_version_str();
+		//Есть ли у вызывающего потока текущий GL контекст. С use_render_thread он только у потока отрисовки
+		static bool has_current_context();
+		//KHR_parallel_shader_compile (или ARB_): компиляция в потоках драйвера и опрос готовности без ожидания
+		static bool supports_parallel_shader_compile() { return s_parallel_shader_compile; }
+
+		//Кэш состояния: GL вызывается, только если значение действительно меняется
+		static void bind_shader_program(const unsigned int id);
+		static void bind_vertex_array(const unsigned int id);
+		static void bind_buffer(const EBufferTarget target, const unsigned int id);
+		//GL_TEXTURE_2D на текстурном блоке unit (< texture_units_count)
+		static void bind_texture(const unsigned int unit, const unsigned int id);
+		//glBufferStorage + glMapBufferRange с PERSISTENT | COHERENT для буфера id; nullptr при ошибке
+		static void* create_persistent_storage(const EBufferTarget target, const unsigned int id, const void* data, const size_t size);
+		static void set_depth_test(const bool enabled);
+		static void set_blend(const bool enabled);
+		static void set_depth_write(const bool enabled);
+		//Вызывать, если GL состояние менял кто-то в обход кэша (например ImGui)
+		static void invalidate_state_cache();
+
+		//Удалённый id может быть тут же выдан новому объекту - забываем его
+		static void on_shader_program_deleted(const unsigned int id);
+		static void on_vertex_array_deleted(const unsigned int id);
+		static void on_buffer_deleted(const unsigned int id);
+		static void on_texture_deleted(const unsigned int id);
+
+		static constexpr unsigned int texture_units_count = 16;
+
+		static const FrameStatistics& get_frame_statistics() { return s_frame_statistics; }
+		static void reset_frame_statistics() { s_frame_statistics = FrameStatistics(); }
+
+	private:
+		struct StateCache {
+
+			static constexpr unsigned int unknown = ~0u;
+
+			unsigned int shader_program = unknown;
+			unsigned int vertex_array = unknown;
+			unsigned int buffers[static_cast<size_t>(EBufferTarget::TargetsCount)];
+			unsigned int textures[texture_units_count];
+			unsigned int active_texture_unit = unknown;
+			float clear_color[4];
+			unsigned int viewport[4];
+			unsigned int depth_test = unknown;
+			unsigned int blend = unknown;
+			unsigned int depth_write = unknown;
+
+			StateCache();
+		};
+
+		static bool set_cached(unsigned int& cached_value, const unsigned int value);
+
+		static FrameStatistics s_frame_statistics;
+		static StateCache s_state_cache;
+		static bool s_parallel_shader_compile;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "RingBuffer.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "UniformBuffer.hpp"
+#include <glad/glad.h>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	constexpr GLuint64 fence_wait_timeout_ns = 1000000;
+
+	RingBuffer::RingBuffer(const size_t size, const bool persistent, const unsigned int frames_in_flight)
+		: m_bPersistent(persistent)
+		, m_region_size(persistent && frames_in_flight > 0 ? size / frames_in_flight : size)
+		, m_fences(persistent && frames_in_flight > 0 ? frames_in_flight : 1, nullptr) {}
+
+	RingBuffer::RingBuffer(VertexBuffer& vertex_buffer, const unsigned int frames_in_flight)
+		: RingBuffer(vertex_buffer.get_size(), vertex_buffer.get_mapped_data() != nullptr, frames_in_flight) {
+
+		m_update_range = [&vertex_buffer](const void* data, const size_t size, const size_t offset) {
+			vertex_buffer.update_buffer_range(data, size, offset);
+		};
+		m_orphan = [&vertex_buffer]() { vertex_buffer.orphan(); };
+	}
+
+	RingBuffer::RingBuffer(IndexBuffer& index_buffer, const unsigned int frames_in_flight)
+		: RingBuffer(index_buffer.get_count() * index_buffer.get_index_size(), index_buffer.get_mapped_data() != nullptr, frames_in_flight) {
+
+		m_update_range = [&index_buffer](const void* data, const size_t size, const size_t offset) {
+			index_buffer.update_buffer_range(data, size / index_buffer.get_index_size(), offset / index_buffer.get_index_size());
+		};
+		m_orphan = [&index_buffer]() { index_buffer.orphan(); };
+	}
+
+	RingBuffer::RingBuffer(UniformBuffer& uniform_buffer, const unsigned int frames_in_flight)
+		: RingBuffer(uniform_buffer.get_size(), uniform_buffer.get_mapped_data() != nullptr, frames_in_flight) {
+
+		m_update_range = [&uniform_buffer](const void* data, const size_t size, const size_t offset) {
+			uniform_buffer.update_buffer(data, size, offset);
+		};
+		m_orphan = [&uniform_buffer]() { uniform_buffer.orphan(); };
+	}
+
+	RingBuffer::~RingBuffer() {
+
+		for (void* fence : m_fences) {
+			if (fence)
+				glDeleteSync(static_cast<GLsync>(fence));
+		}
+	}
+
+	size_t RingBuffer::write(const void* data, const size_t size, const size_t alignment) {
+
+		if (size > m_region_size) {
+			std::cout << "RingBuffer::write: " << size << " bytes don't fit into region of " << m_region_size << "\n";
+			return invalid_offset;
+		}
+
+		if (!m_bRegionOpen)
+			begin_region();
+
+		const size_t region_end = (m_region + 1) * m_region_size;
+		size_t offset = (m_offset + alignment - 1) / alignment * alignment;
+		if (offset + size > region_end) {
+			//Область кончилась посреди кадра. Fence на неё ставить рано - кадр ещё не отправлен целиком;
+			//берём следующую, если её не занял этот же кадр. Без постоянного отображения буфер просто "осиротевает"
+			if (m_bPersistent && m_frame_regions_count >= m_fences.size()) {
+				std::cout << "RingBuffer::write: frame data doesn't fit into " << m_fences.size() << " regions of " << m_region_size << "\n";
+				return invalid_offset;
+			}
+			++m_statistics.overflows;
+			m_region = (m_region + 1) % static_cast<unsigned int>(m_fences.size());
+			begin_region();
+			offset = (m_offset + alignment - 1) / alignment * alignment;
+			if (offset + size > (m_region + 1) * m_region_size)
+				return invalid_offset;
+		}
+
+		m_update_range(data, size, offset);
+		m_offset = offset + size;
+		m_statistics.bytes_written += size;
+		return offset;
+	}
+
+	void RingBuffer::end_frame() {
+
+		if (!m_bRegionOpen)
+			return;
+
+		if (m_bPersistent) {
+			const unsigned int regions_count = static_cast<unsigned int>(m_fences.size());
+			for (unsigned int i = 0; i < m_frame_regions_count; ++i)
+				m_fences[(m_region + regions_count - i) % regions_count] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		m_region = (m_region + 1) % static_cast<unsigned int>(m_fences.size());
+		m_bRegionOpen = false;
+		m_frame_regions_count = 0;
+	}
+
+	void RingBuffer::begin_region() {
+
+		if (m_bPersistent)
+			wait_fence(m_fences[m_region]);
+		else
+			m_orphan();
+
+		m_offset = m_region * m_region_size;
+		m_bRegionOpen = true;
+		++m_frame_regions_count;
+		++m_statistics.regions_used;
+	}
+
+	void RingBuffer::wait_fence(void*& fence) {
+
+		if (!fence)
+			return;
+
+		GLsync sync = static_cast<GLsync>(fence);
+		GLenum result = glClientWaitSync(sync, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED) {
+			++m_statistics.fence_waits;
+			do {
+				result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, fence_wait_timeout_ns);
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+		if (result == GL_WAIT_FAILED) {
+			std::cerr << "RingBuffer: glClientWaitSync failed\n";
+		}
+
+		glDeleteSync(sync);
+		fence = nullptr;
+	}
+}
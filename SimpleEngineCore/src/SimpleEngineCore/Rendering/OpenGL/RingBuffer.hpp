@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace SimpleEngine {
+
+	class VertexBuffer;
+	class IndexBuffer;
+	class UniformBuffer;
+
+	//Кольцевой аллокатор поверх Persistent буфера: буфер делится на frames_in_flight областей, каждая рассчитана на
+	//весь кадр. Области кадра закрываются fence'ами только в end_frame() и переиспользуются после того, как GPU их дочитал.
+	//Если кадру не хватило своей области, он занимает следующую (ждёт fence одного из прошлых кадров), но не свою же.
+	//Без постоянного отображения (нет GL 4.4) - одна область на весь буфер, "осиротение" + glBufferSubData.
+	class RingBuffer {
+	public:
+		struct Statistics {
+
+			size_t bytes_written = 0;
+			unsigned int regions_used = 0;
+			unsigned int fence_waits = 0;//Сколько раз CPU догнал GPU и ждал fence
+			unsigned int overflows = 0;//Кадру не хватило одной области
+		};
+
+		static constexpr size_t invalid_offset = ~static_cast<size_t>(0);
+
+		RingBuffer(VertexBuffer& vertex_buffer, const unsigned int frames_in_flight = 3);
+		RingBuffer(IndexBuffer& index_buffer, const unsigned int frames_in_flight = 3);
+		RingBuffer(UniformBuffer& uniform_buffer, const unsigned int frames_in_flight = 3);
+		~RingBuffer();
+
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+
+		//Смещение записанных данных в байтах от начала буфера (кратно alignment) или invalid_offset
+		size_t write(const void* data, const size_t size, const size_t alignment = 1);
+		void end_frame();
+
+		bool is_persistent() const { return m_bPersistent; }
+		size_t get_region_size() const { return m_region_size; }
+		const Statistics& get_statistics() const { return m_statistics; }
+		void reset_statistics() { m_statistics = Statistics(); }
+
+	private:
+		RingBuffer(const size_t size, const bool persistent, const unsigned int frames_in_flight);
+
+		void begin_region();
+		void wait_fence(void*& fence);
+
+		std::function<void(const void*, const size_t, const size_t)> m_update_range;
+		std::function<void()> m_orphan;
+
+		bool m_bPersistent;
+		size_t m_region_size;
+		std::vector<void*> m_fences;//GLsync на каждую область
+		unsigned int m_region = 0;
+		bool m_bRegionOpen = false;
+		unsigned int m_frame_regions_count = 0;//Сколько областей, заканчивая m_region, занято в этом кадре
+		size_t m_offset = 0;
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,147 @@
+#include "ShaderCompiler.hpp"
+#include "ProgramBinaryCache.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "SimpleEngineCore/Timing.hpp"
+#include <glad/glad.h>
+#include <chrono>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	//KHR_parallel_shader_compile, в сгенерированном glad расширений нет
+	constexpr GLenum completion_status = 0x91B1;
+
+	ShaderCompiler::~ShaderCompiler() {
+
+		//Недождавшиеся программы никому не отданы - удаляем вместе с шейдерами
+		for (const size_t program : m_pending) {
+
+			const Entry& entry = m_entries[program];
+			glDeleteProgram(entry.program_id);
+			glDeleteShader(entry.vertex_shader_id);
+			glDeleteShader(entry.fragment_shader_id);
+		}
+	}
+
+	size_t ShaderCompiler::submit(const char* vertex_shader_src, const char* fragment_shader_src) {
+
+		//Записи не трогаем: поток с контекстом может в это же время опрашивать их в poll()
+		if (!Renderer_OpenGL::has_current_context()) {
+			std::cerr << "ShaderCompiler::submit: no GL context in this thread\n";
+			return invalid_program;
+		}
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const size_t program = m_entries.size();
+		m_entries.emplace_back();
+		Entry& entry = m_entries.back();
+		++m_statistics.submitted;
+
+		entry.program_id = glCreateProgram();
+		if (ProgramBinaryCache::is_enabled()) {
+
+			entry.cache_key = ProgramBinaryCache::make_key(vertex_shader_src, fragment_shader_src);
+			if (ProgramBinaryCache::load(entry.cache_key, entry.program_id)) {
+				entry.status = EStatus::Ready;
+				entry.pProgram.reset(new ShaderProgram(entry.program_id));
+				++m_statistics.ready;
+				++m_statistics.from_cache;
+				m_statistics.submit_ms += milliseconds_since(start_time);
+				return program;
+			}
+		}
+
+		//Линковку отправляем сразу за компиляцией: ошибки компиляции всё равно всплывут в статусе линковки
+		entry.compile_start_time = std::chrono::steady_clock::now();
+		entry.vertex_shader_id = ShaderProgram::create_shader(vertex_shader_src, GL_VERTEX_SHADER);
+		entry.fragment_shader_id = ShaderProgram::create_shader(fragment_shader_src, GL_FRAGMENT_SHADER);
+
+		glAttachShader(entry.program_id, entry.vertex_shader_id);
+		glAttachShader(entry.program_id, entry.fragment_shader_id);
+		if (ProgramBinaryCache::is_enabled())
+			glProgramParameteri(entry.program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(entry.program_id);
+
+		m_pending.push_back(program);
+		m_statistics.submit_ms += milliseconds_since(start_time);
+		return program;
+	}
+
+	bool ShaderCompiler::is_completed(const Entry& entry) {
+
+		GLint completed = GL_FALSE;
+		glGetProgramiv(entry.program_id, completion_status, &completed);
+		return completed == GL_TRUE;
+	}
+
+	void ShaderCompiler::complete(Entry& entry) {
+
+		GLint success = GL_FALSE;
+		glGetProgramiv(entry.program_id, GL_LINK_STATUS, &success);
+		if (success == GL_FALSE) {
+
+			ShaderProgram::print_shader_compile_errors(entry.vertex_shader_id, "VERTEX");
+			ShaderProgram::print_shader_compile_errors(entry.fragment_shader_id, "FRAGMENT");
+			GLchar info_log[1024];
+			glGetProgramInfoLog(entry.program_id, sizeof(info_log), nullptr, info_log);
+			std::cout << "SHADER PROGRAM: Link-time error:\n" << info_log;
+			glDeleteProgram(entry.program_id);
+			entry.program_id = 0;
+			entry.status = EStatus::Failed;
+			++m_statistics.failed;
+		}
+		else {
+
+			glDetachShader(entry.program_id, entry.vertex_shader_id);
+			glDetachShader(entry.program_id, entry.fragment_shader_id);
+			ProgramBinaryCache::on_program_compiled(milliseconds_since(entry.compile_start_time));
+			if (entry.cache_key != 0)
+				ProgramBinaryCache::store(entry.cache_key, entry.program_id);
+			entry.status = EStatus::Ready;
+			entry.pProgram.reset(new ShaderProgram(entry.program_id));
+			++m_statistics.ready;
+		}
+
+		glDeleteShader(entry.vertex_shader_id);
+		glDeleteShader(entry.fragment_shader_id);
+		entry.vertex_shader_id = 0;
+		entry.fragment_shader_id = 0;
+	}
+
+	void ShaderCompiler::poll(const size_t max_blocking_programs) {
+
+		if (m_pending.empty())
+			return;
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const bool can_query_completion = Renderer_OpenGL::supports_parallel_shader_compile();
+		size_t blocking_programs = 0;
+		size_t write_position = 0;
+		for (const size_t program : m_pending) {
+
+			Entry& entry = m_entries[program];
+			const bool ready_to_complete = can_query_completion ? is_completed(entry) : blocking_programs++ < max_blocking_programs;
+			if (ready_to_complete)
+				complete(entry);
+			else
+				m_pending[write_position++] = program;
+		}
+		m_pending.resize(write_position);
+		m_statistics.poll_ms += milliseconds_since(start_time);
+	}
+
+	void ShaderCompiler::finish() {
+
+		const auto start_time = std::chrono::steady_clock::now();
+		for (const size_t program : m_pending)
+			complete(m_entries[program]);
+		m_pending.clear();
+		m_statistics.poll_ms += milliseconds_since(start_time);
+	}
+
+	const ShaderProgram& ShaderCompiler::get_or(const size_t program, const ShaderProgram& fallback) const {
+
+		const ShaderProgram* pProgram = get(program);
+		return pProgram ? *pProgram : fallback;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "ShaderProgram.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Пакетная компиляция программ без ожидания: submit только отправляет glCompileShader/glLinkProgram, статус не
+	//спрашивается - запрос статуса сразу после компиляции останавливает поток до её конца. С KHR_parallel_shader_compile
+	//драйвер компилирует в своих потоках, а poll забирает готовые по GL_COMPLETION_STATUS_KHR; пока программа не готова,
+	//рисуем запасной get_or(). Все вызовы - из потока с GL контекстом; submit из другого потока отказывает
+	class ShaderCompiler {
+	public:
+		enum class EStatus {
+
+			Pending,
+			Ready,
+			Failed
+		};
+
+		struct Statistics {
+
+			size_t submitted = 0;
+			size_t ready = 0;
+			size_t failed = 0;
+			size_t from_cache = 0;//Взято из ProgramBinaryCache прямо в submit
+			double submit_ms = 0.0;
+			double poll_ms = 0.0;//Включая ожидание программ без KHR_parallel_shader_compile
+		};
+
+		static constexpr size_t invalid_program = ~static_cast<size_t>(0);
+
+		ShaderCompiler() = default;
+		ShaderCompiler(const ShaderCompiler&) = delete;
+		ShaderCompiler& operator=(const ShaderCompiler&) = delete;
+		~ShaderCompiler();
+
+		//Возвращает номер программы для get/get_status. Без GL контекста в этом потоке - invalid_program
+		//(с use_render_thread отправлять из команды enqueue_render_command)
+		size_t submit(const char* vertex_shader_src, const char* fragment_shader_src);
+		//Забирает всё, что уже готово. Без расширения готовность не узнать без ожидания -
+		//тогда за вызов дожидаемся не больше max_blocking_programs, чтобы кадр не вставал надолго
+		void poll(const size_t max_blocking_programs = 4);
+		//Дождаться всех
+		void finish();
+
+		EStatus get_status(const size_t program) const { return program < m_entries.size() ? m_entries[program].status : EStatus::Failed; }
+		//nullptr, пока программа не готова или если она не собралась
+		const ShaderProgram* get(const size_t program) const { return program < m_entries.size() ? m_entries[program].pProgram.get() : nullptr; }
+		const ShaderProgram& get_or(const size_t program, const ShaderProgram& fallback) const;
+		size_t get_pending_count() const { return m_pending.size(); }
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		struct Entry {
+
+			unsigned int program_id = 0;
+			unsigned int vertex_shader_id = 0;
+			unsigned int fragment_shader_id = 0;
+			uint64_t cache_key = 0;
+			//Начало компиляции: время до готовности уходит в ProgramBinaryCache::on_program_compiled
+			std::chrono::steady_clock::time_point compile_start_time;
+			EStatus status = EStatus::Pending;
+			std::unique_ptr<ShaderProgram> pProgram;
+		};
+
+		static bool is_completed(const Entry& entry);
+		//Статус линковки (ждёт, если программа ещё не готова) и перевод в Ready / Failed
+		void complete(Entry& entry);
+
+		std::vector<Entry> m_entries;
+		//Номера Pending программ в порядке отправки
+		std::vector<size_t> m_pending;
+		Statistics m_statistics;
+	};
+}
@@ -0,0 +1,204 @@
+#include "ShaderLibrary.hpp"
+#include "SimpleEngineCore/Timing.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+namespace SimpleEngine {
+
+	static bool is_identifier_char(const char c) {
+
+		return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+	}
+
+	//Есть ли name в тексте отдельным идентификатором
+	static bool is_identifier_used(const std::string& text, const std::string& name) {
+
+		for (size_t position = text.find(name); position != std::string::npos; position = text.find(name, position + 1)) {
+			const size_t end = position + name.size();
+			if ((position == 0 || !is_identifier_char(text[position - 1])) && (end == text.size() || !is_identifier_char(text[end])))
+				return true;
+		}
+		return false;
+	}
+
+	//"  #include "file"  " -> file; пусто, если строка - не #include
+	static std::string parse_include(const std::string& line) {
+
+		size_t position = line.find_first_not_of(" \t");
+		if (position == std::string::npos || line.compare(position, 8, "#include") != 0)
+			return std::string();
+		const size_t open_quote = line.find('"', position + 8);
+		const size_t close_quote = open_quote == std::string::npos ? std::string::npos : line.find('"', open_quote + 1);
+		if (close_quote == std::string::npos)
+			return std::string();
+		return line.substr(open_quote + 1, close_quote - open_quote - 1);
+	}
+
+	ShaderLibrary::ShaderLibrary(std::string directory)
+		: m_directory(std::move(directory)) {
+	}
+
+	void ShaderLibrary::add_source(const std::string& name, std::string source) {
+
+		m_sources[name] = std::move(source);
+	}
+
+	void ShaderLibrary::add_fallback_source(const std::string& name, std::string source) {
+
+		m_fallback_sources[name] = std::move(source);
+	}
+
+	const std::string* ShaderLibrary::find_source(const std::string& name) {
+
+		const auto it = m_sources.find(name);
+		if (it != m_sources.end())
+			return &it->second;
+
+		const std::filesystem::path path = m_directory.empty() ? std::filesystem::path(name) : std::filesystem::path(m_directory) / name;
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream) {
+			const auto fallback_it = m_fallback_sources.find(name);
+			if (fallback_it != m_fallback_sources.end())
+				return &(m_sources[name] = fallback_it->second);
+			std::cerr << "ShaderLibrary: can't open " << path.string() << "\n";
+			return nullptr;
+		}
+		std::stringstream source;
+		source << stream.rdbuf();
+		++m_statistics.files_loaded;
+		return &(m_sources[name] = source.str());
+	}
+
+	bool ShaderLibrary::expand_includes(const std::string& name, std::unordered_set<std::string>& included, std::string& result) {
+
+		const std::string* pSource = find_source(name);
+		if (!pSource)
+			return false;
+		//Номер исходника для #line - по нему в логе компиляции видно, из какого файла строка
+		const size_t source_index = included.size() - 1;
+
+		std::istringstream stream(*pSource);
+		std::string line;
+		size_t line_number = 0;
+		while (std::getline(stream, line)) {
+
+			++line_number;
+			const std::string include_name = parse_include(line);
+			if (include_name.empty()) {
+				result += line;
+				result += '\n';
+				continue;
+			}
+			//Каждый файл подключается один раз - это же защищает от циклов
+			if (!included.insert(include_name).second)
+				continue;
+			result += "#line 1 " + std::to_string(included.size() - 1) + "\n";
+			if (!expand_includes(include_name, included, result))
+				return false;
+			result += "#line " + std::to_string(line_number + 1) + " " + std::to_string(source_index) + "\n";
+		}
+		return true;
+	}
+
+	bool ShaderLibrary::preprocess(const std::string& name, const std::vector<std::string>& defines, std::string& result) {
+
+		std::unordered_set<std::string> included{ name };
+		std::string expanded;
+		if (!expand_includes(name, included, expanded))
+			return false;
+
+		std::string define_lines;
+		for (const std::string& define : defines) {
+
+			const size_t separator = define.find('=');
+			const std::string define_name = define.substr(0, separator);
+			if (!is_identifier_used(expanded, define_name))
+				continue;
+			define_lines += "#define " + define_name;
+			if (separator != std::string::npos)
+				define_lines += " " + define.substr(separator + 1);
+			define_lines += '\n';
+		}
+
+		//#version должна быть первой - define'ы встают сразу за ней
+		size_t insert_position = 0;
+		size_t version_line = 1;
+		const size_t version_position = expanded.find("#version");
+		if (version_position != std::string::npos) {
+			insert_position = expanded.find('\n', version_position);
+			insert_position = insert_position == std::string::npos ? expanded.size() : insert_position + 1;
+			version_line = static_cast<size_t>(std::count(expanded.begin(), expanded.begin() + insert_position, '\n')) + 1;
+		}
+		if (!define_lines.empty())
+			define_lines += "#line " + std::to_string(version_line) + " 0\n";
+
+		result = expanded.substr(0, insert_position) + define_lines + expanded.substr(insert_position);
+		return true;
+	}
+
+	ShaderProgram* ShaderLibrary::get_program(const std::string& vertex_name, const std::string& fragment_name, std::vector<std::string> defines) {
+
+		++m_statistics.requests;
+		//Из повторов имени (TINT=0.6, TINT=0.8) остаётся последний: два #define с разными значениями - ошибка GLSL
+		std::unordered_set<std::string> define_names;
+		std::vector<std::string> unique_defines;
+		unique_defines.reserve(defines.size());
+		for (auto it = defines.rbegin(); it != defines.rend(); ++it) {
+			if (define_names.insert(it->substr(0, it->find('='))).second)
+				unique_defines.push_back(std::move(*it));
+		}
+		defines = std::move(unique_defines);
+		std::sort(defines.begin(), defines.end());
+
+		std::string variant_key = vertex_name + '\n' + fragment_name;
+		for (const std::string& define : defines)
+			variant_key += '\n' + define;
+		const auto variant_it = m_variants.find(variant_key);
+		if (variant_it != m_variants.end())
+			return variant_it->second;
+
+		const auto preprocess_start_time = std::chrono::steady_clock::now();
+		Program program;
+		const bool preprocessed = preprocess(vertex_name, defines, program.vertex_source) && preprocess(fragment_name, defines, program.fragment_source);
+		m_statistics.preprocess_ms += milliseconds_since(preprocess_start_time);
+		if (!preprocessed) {
+			m_variants.emplace(std::move(variant_key), nullptr);
+			return nullptr;
+		}
+		++m_statistics.variants;
+
+		const std::hash<std::string_view> hasher;
+		const size_t hash = hasher(program.vertex_source) * 31 + hasher(program.fragment_source);
+		const auto range = m_programs_by_hash.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it) {
+
+			const Program& existing = m_programs[it->second];
+			if (existing.vertex_source == program.vertex_source && existing.fragment_source == program.fragment_source) {
+				++m_statistics.deduplicated;
+				ShaderProgram* pShared = existing.pProgram->isCompiled() ? existing.pProgram.get() : nullptr;
+				m_variants.emplace(std::move(variant_key), pShared);
+				return pShared;
+			}
+		}
+
+		const auto compile_start_time = std::chrono::steady_clock::now();
+		program.pProgram = std::make_unique<ShaderProgram>(program.vertex_source.c_str(), program.fragment_source.c_str());
+		m_statistics.compile_ms += milliseconds_since(compile_start_time);
+		++m_statistics.programs;
+
+		ShaderProgram* pProgram = program.pProgram->isCompiled() ? program.pProgram.get() : nullptr;
+		if (!pProgram)
+			std::cerr << "ShaderLibrary: " << vertex_name << " + " << fragment_name << " failed to build\n";
+		m_programs_by_hash.emplace(hash, m_programs.size());
+		m_programs.push_back(std::move(program));
+		m_variants.emplace(std::move(variant_key), pProgram);
+		return pProgram;
+	}
+}
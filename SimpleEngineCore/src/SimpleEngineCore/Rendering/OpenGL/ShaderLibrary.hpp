@@ -0,0 +1,66 @@
+#pragma once
+#include "ShaderProgram.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//GLSL из файлов каталога с #include "file" и вариантами через #define. Вариант собирается только при первом запросе;
+	//define'ы, которых нет в тексте шейдера, не вставляются - варианты, отличающиеся только ими, получают одну программу.
+	//Одинаковый после препроцессора текст (по хешу) - одна ShaderProgram на все материалы. Вызовы - из потока с GL контекстом
+	class ShaderLibrary {
+	public:
+		struct Statistics {
+
+			size_t requests = 0;
+			size_t variants = 0;//Разных наборов файлы + define'ы, прошедших препроцессор
+			size_t programs = 0;//Собрано ShaderProgram
+			size_t deduplicated = 0;//Варианты, получившие уже собранную программу
+			size_t files_loaded = 0;
+			double preprocess_ms = 0.0;
+			double compile_ms = 0.0;
+		};
+
+		explicit ShaderLibrary(std::string directory = std::string());
+		ShaderLibrary(const ShaderLibrary&) = delete;
+		ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+		//Исходник без файла (встроенные шейдеры, тесты): находится по имени раньше файлов, подключается через #include
+		void add_source(const std::string& name, std::string source);
+		//Исходник на случай, если файла с таким именем в каталоге нет (копии, вшитые в бинарник)
+		void add_fallback_source(const std::string& name, std::string source);
+
+		//defines - "NAME" или "NAME=VALUE", порядок не важен; из повторов одного имени действует последний.
+		//nullptr, если файла нет или программа не собралась
+		ShaderProgram* get_program(const std::string& vertex_name, const std::string& fragment_name,
+								   std::vector<std::string> defines = std::vector<std::string>());
+
+		const Statistics& get_statistics() const { return m_statistics; }
+
+	private:
+		struct Program {
+
+			std::string vertex_source;
+			std::string fragment_source;
+			std::unique_ptr<ShaderProgram> pProgram;
+		};
+
+		const std::string* find_source(const std::string& name);
+		//Текст с раскрытыми #include (каждый файл - один раз) и define'ами сразу после #version
+		bool preprocess(const std::string& name, const std::vector<std::string>& defines, std::string& result);
+		bool expand_includes(const std::string& name, std::unordered_set<std::string>& included, std::string& result);
+
+		std::string m_directory;
+		std::unordered_map<std::string, std::string> m_sources;
+		std::unordered_map<std::string, std::string> m_fallback_sources;
+		//Ключ запроса (файлы и отсортированные define'ы) -> программа, nullptr - не собралась
+		std::unordered_map<std::string, ShaderProgram*> m_variants;
+		std::vector<Program> m_programs;
+		std::unordered_multimap<size_t, size_t> m_programs_by_hash;
+		Statistics m_statistics;
+	};
+}
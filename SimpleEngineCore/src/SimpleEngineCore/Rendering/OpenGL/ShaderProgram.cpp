@@ -1,15 +1,26 @@
 #include "ShaderProgram.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "UniformBuffer.hpp"
+#include "ProgramBinaryCache.hpp"
+#include "SimpleEngineCore/Timing.hpp"
 #include <glad/glad.h>
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
 
 namespace SimpleEngine {
 
-	bool create_shader(const char* source, const GLenum shader_type, GLuint& shader_id) {
+	unsigned int ShaderProgram::create_shader(const char* source, const unsigned int shader_type) {
 
-		shader_id = glCreateShader(shader_type);
+		const GLuint shader_id = glCreateShader(shader_type);
 		glShaderSource(shader_id, 1, &source, nullptr);
 		glCompileShader(shader_id);
+		return shader_id;
+	}
+
+	void ShaderProgram::print_shader_compile_errors(const unsigned int shader_id, const char* stage) {
 
 		GLint success;
 		glGetShaderiv(shader_id, GL_COMPILE_STATUS, &success);
@@ -17,40 +28,45 @@ namespace SimpleEngine {
 			char info_log[1024];
 			glGetShaderInfoLog(shader_id, 1024, nullptr, info_log);
 
-			std::cout << "Shader compilation error:\n" << info_log;
-			return false;
+			std::cout << stage << " SHADER: compile-time error!\n" << info_log;
 		}
-		return true;
 	}
 
 	ShaderProgram::ShaderProgram(const char* vertex_shader_src, const char* fragment_shader_src) {
 
-		GLuint vertex_shader_id = 0;
-		if (!create_shader(vertex_shader_src, GL_VERTEX_SHADER, vertex_shader_id)) {
-
-			std::cout << "VERTEX SHADER: compile-time error!\n";
-			glDeleteShader(vertex_shader_id);
-			return;
+		//Из кэша - без компиляции: одна glProgramBinary вместо компиляции и линковки двух шейдеров
+		const bool use_cache = ProgramBinaryCache::is_enabled();
+		const uint64_t cache_key = use_cache ? ProgramBinaryCache::make_key(vertex_shader_src, fragment_shader_src) : 0;
+		if (use_cache) {
+
+			m_id = glCreateProgram();
+			if (ProgramBinaryCache::load(cache_key, m_id)) {
+				m_isCompiled = true;
+				reflect_uniforms();
+				bind_uniform_blocks();
+				return;
+			}
+			glDeleteProgram(m_id);
+			m_id = 0;
 		}
 
-		GLuint fragment_shader_id = 0;
-		if (!create_shader(fragment_shader_src, GL_FRAGMENT_SHADER, fragment_shader_id)) {
-
-			std::cout << "FRAGMENT SHADER: compile-time error!\n";
-			glDeleteShader(vertex_shader_id);
-			glDeleteShader(fragment_shader_id);
-			return;
-		}
+		const auto compile_start_time = std::chrono::steady_clock::now();
+		const GLuint vertex_shader_id = create_shader(vertex_shader_src, GL_VERTEX_SHADER);
+		const GLuint fragment_shader_id = create_shader(fragment_shader_src, GL_FRAGMENT_SHADER);
 
 		m_id = glCreateProgram();
 		glAttachShader(m_id, vertex_shader_id);
 		glAttachShader(m_id, fragment_shader_id);
+		if (use_cache)
+			glProgramParameteri(m_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(m_id);
 
 		GLint success;
 		glGetProgramiv(m_id, GL_LINK_STATUS, &success);
 		if (success == GL_FALSE) {
 
+			print_shader_compile_errors(vertex_shader_id, "VERTEX");
+			print_shader_compile_errors(fragment_shader_id, "FRAGMENT");
 			GLchar info_log[1024];
 			glGetProgramInfoLog(m_id, 1024, nullptr, info_log);
 			std::cout << "SHADER PROGRAM: Link-time error:\n" << info_log;
@@ -62,27 +78,44 @@ namespace SimpleEngine {
 		}
 		else {
 			m_isCompiled = true;
+			reflect_uniforms();
+			bind_uniform_blocks();
 		}
 
 		glDetachShader(m_id, vertex_shader_id);
 		glDetachShader(m_id, fragment_shader_id);
 		glDeleteShader(vertex_shader_id);
 		glDeleteShader(fragment_shader_id);
+		ProgramBinaryCache::on_program_compiled(milliseconds_since(compile_start_time));
+
+		if (use_cache)
+			ProgramBinaryCache::store(cache_key, m_id);
+	}
+
+	ShaderProgram::ShaderProgram(const unsigned int linked_program_id)
+		: m_isCompiled(true)
+		, m_id(linked_program_id) {
+
+		reflect_uniforms();
+		bind_uniform_blocks();
 	}
 
 	void ShaderProgram::bind() const {
-		glUseProgram(m_id);
+		Renderer_OpenGL::bind_shader_program(m_id);
 	}
 
 	void ShaderProgram::unbind() {
-		glUseProgram(0);
+		Renderer_OpenGL::bind_shader_program(0);
 	}
 
 	ShaderProgram& ShaderProgram::operator=(ShaderProgram&& shaderProgram) {
 
+		Renderer_OpenGL::on_shader_program_deleted(m_id);
 		glDeleteProgram(m_id);
 		m_id = shaderProgram.m_id;
 		m_isCompiled = shaderProgram.m_isCompiled;
+		m_uniform_locations = std::move(shaderProgram.m_uniform_locations);
+		m_uniform_lookup_misses = shaderProgram.m_uniform_lookup_misses;
 
 		shaderProgram.m_id = 0;
 		shaderProgram.m_isCompiled = false;
@@ -93,16 +126,104 @@ namespace SimpleEngine {
 
 		m_id = shaderProgram.m_id;
 		m_isCompiled = shaderProgram.m_isCompiled;
+		m_uniform_locations = std::move(shaderProgram.m_uniform_locations);
+		m_uniform_lookup_misses = shaderProgram.m_uniform_lookup_misses;
 
 		shaderProgram.m_id = 0;
 		shaderProgram.m_isCompiled = false;
 	}
 
-	void ShaderProgram::setMatrix4(const char* name, const glm::mat4& matrix) const {
-		glUniformMatrix4fv(glGetUniformLocation(m_id, name), 1, GL_FALSE, glm::value_ptr(matrix));
+	void ShaderProgram::reflect_uniforms() {
+
+		m_uniform_locations.clear();
+
+		GLint uniforms_count = 0;
+		GLint max_name_length = 0;
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &uniforms_count);
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+		std::string name(static_cast<size_t>(max_name_length) + 1, '\0');
+		for (GLint i = 0; i < uniforms_count; ++i) {
+
+			GLsizei name_length = 0;
+			GLint array_size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_id, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()), &name_length, &array_size, &type, name.data());
+			name[name_length] = '\0';
+
+			//Юниформы из uniform block'ов не имеют location
+			const GLint location = glGetUniformLocation(m_id, name.c_str());
+			if (location < 0)
+				continue;
+
+			//"lights[0]" доступен и как "lights"
+			if (name_length > 3 && name.compare(name_length - 3, 3, "[0]") == 0)
+				name[name_length - 3] = '\0';
+
+			m_uniform_locations.push_back({ hash_uniform_name(name.c_str()), location, name.c_str() });
+		}
+
+		std::sort(m_uniform_locations.begin(), m_uniform_locations.end(),
+			[](const UniformLocation& lhs, const UniformLocation& rhs) { return lhs.hash < rhs.hash; });
+	}
+
+	void ShaderProgram::bind_uniform_blocks() const {
+
+		GLint blocks_count = 0;
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &blocks_count);
+
+		char block_name[256];
+		for (GLint i = 0; i < blocks_count; ++i) {
+
+			glGetActiveUniformBlockName(m_id, static_cast<GLuint>(i), sizeof(block_name), nullptr, block_name);
+			const int binding = UniformBuffer::get_block_binding(block_name);
+			if (binding >= 0)
+				glUniformBlockBinding(m_id, static_cast<GLuint>(i), static_cast<GLuint>(binding));
+		}
+	}
+
+	int ShaderProgram::get_uniform_location(const UniformName name) const {
+
+		auto it = std::lower_bound(m_uniform_locations.begin(), m_uniform_locations.end(), name.hash,
+			[](const UniformLocation& entry, const uint32_t hash) { return entry.hash < hash; });
+		for (; it != m_uniform_locations.end() && it->hash == name.hash; ++it) {
+			if (it->name == name.name)
+				return it->location;
+		}
+		++m_uniform_lookup_misses;
+		return -1;
+	}
+
+	void ShaderProgram::setFloat(const int location, const float value) const {
+		glUniform1f(location, value);
+	}
+
+	void ShaderProgram::setInt(const int location, const int value) const {
+		glUniform1i(location, value);
+	}
+
+	void ShaderProgram::setVec2(const int location, const glm::vec2& value) const {
+		glUniform2fv(location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::setVec3(const int location, const glm::vec3& value) const {
+		glUniform3fv(location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::setVec4(const int location, const glm::vec4& value) const {
+		glUniform4fv(location, 1, glm::value_ptr(value));
+	}
+
+	void ShaderProgram::setMatrix3(const int location, const glm::mat3& matrix) const {
+		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+	}
+
+	void ShaderProgram::setMatrix4(const int location, const glm::mat4& matrix) const {
+		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 	}
 
 	ShaderProgram::~ShaderProgram() {
+		Renderer_OpenGL::on_shader_program_deleted(m_id);
 		glDeleteProgram(m_id);
 	}
 }
\ No newline at end of file
@@ -1,8 +1,36 @@
 #pragma once
 #include <glm/mat4x4.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace SimpleEngine {
 
+	//FNV-1a, constexpr - имя юниформа можно захешировать на этапе компиляции
+	constexpr uint32_t hash_uniform_name(const char* name) {
+
+		uint32_t hash = 2166136261u;
+		while (*name) {
+			hash ^= static_cast<uint8_t>(*name++);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	//Строка имени должна жить, пока используется UniformName: при совпадении хеша сверяется и она
+	struct UniformName {
+
+		constexpr UniformName(const char* name) : hash(hash_uniform_name(name)), name(name) {}
+
+		uint32_t hash;
+		const char* name;
+	};
+
 	class ShaderProgram {
 
 	public:
@@ -16,12 +44,55 @@ namespace SimpleEngine {
 		void bind() const;
 		static void unbind();
 		bool isCompiled() const { return m_isCompiled; }
-		void setMatrix4(const char* name, const glm::mat4& matrix) const;
+		unsigned int get_id() const { return m_id; }
+
+		//-1, если такого активного юниформа нет (glUniform* с -1 ничего не делает)
+		int get_uniform_location(const UniformName name) const;
+		size_t get_uniform_lookup_misses() const { return m_uniform_lookup_misses; }
+
+		void setFloat(const int location, const float value) const;
+		void setInt(const int location, const int value) const;
+		void setVec2(const int location, const glm::vec2& value) const;
+		void setVec3(const int location, const glm::vec3& value) const;
+		void setVec4(const int location, const glm::vec4& value) const;
+		void setMatrix3(const int location, const glm::mat3& matrix) const;
+		void setMatrix4(const int location, const glm::mat4& matrix) const;
+
+		void setFloat(const UniformName name, const float value) const { setFloat(get_uniform_location(name), value); }
+		void setInt(const UniformName name, const int value) const { setInt(get_uniform_location(name), value); }
+		void setVec2(const UniformName name, const glm::vec2& value) const { setVec2(get_uniform_location(name), value); }
+		void setVec3(const UniformName name, const glm::vec3& value) const { setVec3(get_uniform_location(name), value); }
+		void setVec4(const UniformName name, const glm::vec4& value) const { setVec4(get_uniform_location(name), value); }
+		void setMatrix3(const UniformName name, const glm::mat3& matrix) const { setMatrix3(get_uniform_location(name), matrix); }
+		void setMatrix4(const UniformName name, const glm::mat4& matrix) const { setMatrix4(get_uniform_location(name), matrix); }
 
 		~ShaderProgram();
 
 	private:
+		friend class ShaderCompiler;
+		//Уже слинкованная программа (ShaderCompiler дождался её сам) - только рефлексия юниформов
+		explicit ShaderProgram(const unsigned int linked_program_id);
+
+		//Только отправляет компиляцию: статус спрашиваем один раз после линковки - каждый запрос ждёт конца компиляции
+		static unsigned int create_shader(const char* source, const unsigned int shader_type);
+		//Лог компиляции, если шейдер не скомпилировался
+		static void print_shader_compile_errors(const unsigned int shader_id, const char* stage);
+
+		void reflect_uniforms();
+		void bind_uniform_blocks() const;
+
 		bool m_isCompiled = false;
 		unsigned int m_id = 0;
+		struct UniformLocation {
+
+			uint32_t hash;
+			int location;
+			//Сверяется при совпадении хеша: иначе неизвестное имя с тем же хешем получило бы чужой location
+			std::string name;
+		};
+
+		//Отсортировано по хешу имени, записи с одинаковым хешем идут подряд
+		std::vector<UniformLocation> m_uniform_locations;
+		mutable size_t m_uniform_lookup_misses = 0;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,27 @@
+#include "StaticMesh.hpp"
+#include "SimpleEngineCore/MeshFile.hpp"
+
+namespace SimpleEngine {
+
+	std::unique_ptr<StaticMesh> StaticMesh::load(const std::string& path) {
+
+		MeshFile mesh_file;
+		if (!mesh_file.open(path))
+			return nullptr;
+		//Отображение закрывается на выходе - после glBufferData данные уже у драйвера
+		return std::make_unique<StaticMesh>(mesh_file);
+	}
+
+	StaticMesh::StaticMesh(const MeshFile& mesh_file)
+		: m_vertex_buffer(mesh_file.get_vertex_data(), mesh_file.get_vertex_data_size(), mesh_file.get_layout())
+		, m_index_buffer(mesh_file.get_indexes(), mesh_file.get_indexes_count(), VertexBuffer::EUsage::Static,
+						 mesh_file.get_index_size() == sizeof(uint16_t) ? IndexBuffer::EType::UnsignedShort : IndexBuffer::EType::UnsignedInt)
+		, m_vertices_count(mesh_file.get_vertices_count())
+		, m_bounds_center(mesh_file.get_bounds_center())
+		, m_bounds_radius(mesh_file.get_bounds_radius())
+		, m_lods(mesh_file.get_lods()) {
+
+		m_vertex_array.add_vertex_buffer(m_vertex_buffer);
+		m_vertex_array.set_index_buffer(m_index_buffer);
+	}
+}
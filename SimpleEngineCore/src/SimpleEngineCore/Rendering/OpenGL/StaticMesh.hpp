@@ -0,0 +1,43 @@
+#pragma once
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexArray.hpp"
+#include "SimpleEngineCore/Lod.hpp"
+#include <glm/vec3.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SimpleEngine {
+
+	class MeshFile;
+
+	//Неизменяемый меш из файла .semesh: свой VertexBuffer/IndexBuffer под одним VAO и ограничивающая сфера
+	class StaticMesh {
+	public:
+		//nullptr, если файл не открылся или не прошёл проверку
+		static std::unique_ptr<StaticMesh> load(const std::string& path);
+		//Данные уходят в GL прямо из отображения файла, без копии в памяти процесса
+		explicit StaticMesh(const MeshFile& mesh_file);
+
+		StaticMesh(const StaticMesh&) = delete;
+		StaticMesh& operator=(const StaticMesh&) = delete;
+
+		const VertexArray& get_vertex_array() const { return m_vertex_array; }
+		size_t get_vertices_count() const { return m_vertices_count; }
+		size_t get_indexes_count() const { return m_index_buffer.get_count(); }
+		const glm::vec3& get_bounds_center() const { return m_bounds_center; }
+		float get_bounds_radius() const { return m_bounds_radius; }
+		//Уровни детализации - диапазоны общего IndexBuffer, первый - полная модель
+		const std::vector<MeshLod>& get_lods() const { return m_lods; }
+
+	private:
+		VertexBuffer m_vertex_buffer;
+		IndexBuffer m_index_buffer;
+		VertexArray m_vertex_array;
+		size_t m_vertices_count;
+		glm::vec3 m_bounds_center;
+		float m_bounds_radius;
+		std::vector<MeshLod> m_lods;
+	};
+}
@@ -0,0 +1,143 @@
+#include "Texture2D.hpp"
+#include "Renderer_OpenGL.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	//EXT_texture_compression_s3tc и EXT_texture_sRGB, в сгенерированном glad расширений нет
+	constexpr GLenum compressed_rgb_s3tc_dxt1 = 0x83F0;
+	constexpr GLenum compressed_rgba_s3tc_dxt1 = 0x83F1;
+	constexpr GLenum compressed_rgba_s3tc_dxt5 = 0x83F3;
+	constexpr GLenum compressed_srgb_s3tc_dxt1 = 0x8C4C;
+	constexpr GLenum compressed_srgb_alpha_s3tc_dxt1 = 0x8C4D;
+	constexpr GLenum compressed_srgb_alpha_s3tc_dxt5 = 0x8C4F;
+
+	constexpr GLenum image_format_to_GLenum(const EImageFormat format, const bool srgb) {
+
+		switch (format) {
+			case EImageFormat::RGBA8: return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+			case EImageFormat::BC1:   return srgb ? compressed_srgb_s3tc_dxt1 : compressed_rgb_s3tc_dxt1;
+			case EImageFormat::BC1A:  return srgb ? compressed_srgb_alpha_s3tc_dxt1 : compressed_rgba_s3tc_dxt1;
+			case EImageFormat::BC3:   return srgb ? compressed_srgb_alpha_s3tc_dxt5 : compressed_rgba_s3tc_dxt5;
+			case EImageFormat::BC7:   return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+		}
+		return GL_RGBA8;
+	}
+
+	Texture2D::Texture2D(const uint32_t width, const uint32_t height, const unsigned int levels_count, const EImageFormat format, const bool srgb)
+		: m_width(width)
+		, m_height(height)
+		, m_levels_count(std::clamp(levels_count, 1u, get_mip_levels_count(width, height)))
+		, m_format(format)
+		, m_srgb(srgb) {
+
+		allocate();
+	}
+
+	void Texture2D::allocate() {
+
+		glGenTextures(1, &m_id);
+		Renderer_OpenGL::bind_texture(0, m_id);
+		glTexStorage2D(GL_TEXTURE_2D, m_levels_count, image_format_to_GLenum(m_format, m_srgb), m_width, m_height);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_levels_count > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	}
+
+	Texture2D& Texture2D::operator=(Texture2D&& texture) noexcept {
+
+		if (this != &texture) {
+			Renderer_OpenGL::on_texture_deleted(m_id);
+			glDeleteTextures(1, &m_id);
+		}
+		m_id = texture.m_id;
+		m_width = texture.m_width;
+		m_height = texture.m_height;
+		m_levels_count = texture.m_levels_count;
+		m_format = texture.m_format;
+		m_srgb = texture.m_srgb;
+		texture.m_id = 0;
+		texture.m_levels_count = 0;
+		return *this;
+	}
+
+	Texture2D::Texture2D(Texture2D&& texture) noexcept
+		: m_id(texture.m_id)
+		, m_width(texture.m_width)
+		, m_height(texture.m_height)
+		, m_levels_count(texture.m_levels_count)
+		, m_format(texture.m_format)
+		, m_srgb(texture.m_srgb) {
+
+		texture.m_id = 0;
+		texture.m_levels_count = 0;
+	}
+
+	Texture2D::~Texture2D() {
+
+		Renderer_OpenGL::on_texture_deleted(m_id);
+		glDeleteTextures(1, &m_id);
+	}
+
+	void Texture2D::set_level_data(const unsigned int level, const void* data, const size_t size) {
+
+		if (level >= m_levels_count) {
+			std::cerr << "Texture2D: level " << level << " is out of " << m_levels_count << " levels\n";
+			return;
+		}
+
+		const GLsizei width = std::max(1u, m_width >> level);
+		const GLsizei height = std::max(1u, m_height >> level);
+		Renderer_OpenGL::bind_texture(0, m_id);
+		if (is_block_compressed(m_format))
+			glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, image_format_to_GLenum(m_format, m_srgb), static_cast<GLsizei>(size), data);
+		else
+			glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	}
+
+	void Texture2D::generate_mips() {
+
+		if (m_levels_count < 2 || is_block_compressed(m_format))
+			return;
+		Renderer_OpenGL::bind_texture(0, m_id);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	void Texture2D::drop_top_levels(unsigned int count) {
+
+		count = std::min(count, m_levels_count - 1);
+		if (count == 0)
+			return;
+
+		const unsigned int old_id = m_id;
+		m_width = std::max(1u, m_width >> count);
+		m_height = std::max(1u, m_height >> count);
+		m_levels_count -= count;
+		allocate();
+
+		for (unsigned int level = 0; level < m_levels_count; ++level) {
+			glCopyImageSubData(old_id, GL_TEXTURE_2D, level + count, 0, 0, 0,
+							   m_id, GL_TEXTURE_2D, level, 0, 0, 0,
+							   std::max(1u, m_width >> level), std::max(1u, m_height >> level), 1);
+		}
+
+		Renderer_OpenGL::on_texture_deleted(old_id);
+		glDeleteTextures(1, &old_id);
+	}
+
+	void Texture2D::bind(const unsigned int unit) const {
+
+		Renderer_OpenGL::bind_texture(unit, m_id);
+	}
+
+	size_t Texture2D::get_size() const {
+
+		size_t size = 0;
+		for (unsigned int level = 0; level < m_levels_count; ++level)
+			size += get_image_level_size(m_format, std::max(1u, m_width >> level), std::max(1u, m_height >> level));
+		return size;
+	}
+}
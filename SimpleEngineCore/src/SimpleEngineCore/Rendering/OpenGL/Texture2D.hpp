@@ -0,0 +1,47 @@
+#pragma once
+#include "SimpleEngineCore/ImageDecoder.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace SimpleEngine {
+
+	//Неизменяемое хранилище glTexStorage2D: все уровни выделяются сразу, драйверу не нужно проверять полноту цепочки
+	class Texture2D {
+	public:
+		Texture2D(const uint32_t width, const uint32_t height, const unsigned int levels_count, const EImageFormat format, const bool srgb);
+		~Texture2D();
+
+		Texture2D(const Texture2D&) = delete;
+		Texture2D& operator=(const Texture2D&) = delete;
+		Texture2D& operator=(Texture2D&& texture) noexcept;
+		Texture2D(Texture2D&& texture) noexcept;
+
+		//data - указатель в памяти или, если привязан EBufferTarget::PixelUnpack, смещение в этом буфере
+		void set_level_data(const unsigned int level, const void* data, const size_t size);
+		//Уровни 1.. из нулевого средствами GPU
+		void generate_mips();
+		//Сбрасывает count самых подробных уровней: выделяется хранилище меньше, оставшиеся уровни копируются
+		//glCopyImageSubData без участия CPU. Последний уровень не сбрасывается
+		void drop_top_levels(unsigned int count);
+
+		void bind(const unsigned int unit) const;
+
+		unsigned int get_id() const { return m_id; }
+		uint32_t get_width() const { return m_width; }
+		uint32_t get_height() const { return m_height; }
+		unsigned int get_levels_count() const { return m_levels_count; }
+		EImageFormat get_format() const { return m_format; }
+		//Байт видеопамяти под все уровни
+		size_t get_size() const;
+
+	private:
+		void allocate();
+
+		unsigned int m_id = 0;
+		uint32_t m_width = 0;
+		uint32_t m_height = 0;
+		unsigned int m_levels_count = 0;
+		EImageFormat m_format = EImageFormat::RGBA8;
+		bool m_srgb = false;
+	};
+}
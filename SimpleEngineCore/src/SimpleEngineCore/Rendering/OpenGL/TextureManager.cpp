@@ -0,0 +1,262 @@
+#include "TextureManager.hpp"
+#include "Renderer_OpenGL.hpp"
+#include "SimpleEngineCore/MappedFile.hpp"
+#include "SimpleEngineCore/Timing.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace SimpleEngine {
+
+	void TextureManager::DecodeJob::operator()() {
+
+		const auto start_time = std::chrono::steady_clock::now();
+		MappedFile file;
+		if (!file.open(path)) {
+			error = "can't open file";
+		}
+		else {
+			file_bytes = file.get_size();
+			//Исключение из задачи JobSystem уронило бы рабочий поток, а картинка до 16384x16384 - это гигабайт
+			try {
+				result = decode_image(file.get_data(), file.get_size(), image, error);
+				if (result && generate_mips && image.format == EImageFormat::RGBA8 && image.levels.size() == 1)
+					SimpleEngine::generate_mips(image);
+			}
+			catch (const std::bad_alloc&) {
+				image = Image();
+				error = "out of memory";
+				result = false;
+			}
+		}
+		decode_ms = milliseconds_since(start_time);
+	}
+
+	TextureManager::TextureManager(JobSystem* pJobSystem)
+		: m_pJobSystem(pJobSystem) {
+	}
+
+	TextureManager::~TextureManager() {
+
+		for (const size_t texture : m_decoding) {
+			//Без рабочих потоков задачи в очередь не ставились
+			if (m_pJobSystem && m_pJobSystem->get_threads_count() > 1)
+				m_pJobSystem->wait(m_entries[texture].pJob->counter);
+		}
+		Renderer_OpenGL::on_buffer_deleted(m_pixel_buffer_id);
+		glDeleteBuffers(1, &m_pixel_buffer_id);
+	}
+
+	size_t TextureManager::load(const std::string& path) {
+
+		if (!Renderer_OpenGL::has_current_context()) {
+			std::cerr << "TextureManager::load: no GL context in this thread\n";
+			return invalid_texture;
+		}
+
+		const auto it = m_textures_by_path.find(path);
+		if (it != m_textures_by_path.end())
+			return it->second;
+
+		const size_t texture = m_entries.size();
+		m_entries.emplace_back();
+		m_entries.back().path = path;
+		m_textures_by_path.emplace(path, texture);
+		++m_statistics.textures;
+		start_decode(texture);
+		return texture;
+	}
+
+	void TextureManager::start_decode(const size_t texture) {
+
+		Entry& entry = m_entries[texture];
+		entry.pJob = std::make_unique<DecodeJob>();
+		entry.pJob->path = entry.path;
+		entry.pJob->generate_mips = !settings.gpu_mips;
+		//Задачу может взять и основной поток, если ждёт в JobSystem::wait() чего-то своего - тогда кадр подождёт декодирование
+		if (m_pJobSystem && m_pJobSystem->get_threads_count() > 1)
+			m_pJobSystem->run(*entry.pJob, entry.pJob->counter);
+		m_decoding.push_back(texture);
+	}
+
+	const Texture2D* TextureManager::use(const size_t texture) {
+
+		if (texture >= m_entries.size())
+			return nullptr;
+		Entry& entry = m_entries[texture];
+		entry.last_used_frame = m_frame;
+		return entry.pTexture.get();
+	}
+
+	const std::string& TextureManager::get_error(const size_t texture) const {
+
+		static const std::string invalid_texture_error = "invalid texture";
+		return texture < m_entries.size() ? m_entries[texture].error : invalid_texture_error;
+	}
+
+	void TextureManager::update() {
+
+		++m_frame;
+		m_uploaded_this_frame = 0;
+
+		const bool inline_decode = !m_pJobSystem || m_pJobSystem->get_threads_count() == 1;
+		bool decoded_inline = false;
+		size_t still_decoding = 0;
+		for (const size_t texture : m_decoding) {
+
+			Entry& entry = m_entries[texture];
+			DecodeJob& job = *entry.pJob;
+			if (inline_decode) {
+				if (decoded_inline) {
+					m_decoding[still_decoding++] = texture;
+					continue;
+				}
+				job();
+				decoded_inline = true;
+			}
+			else if (job.counter.pending.load(std::memory_order_acquire) > 0) {
+				m_decoding[still_decoding++] = texture;
+				continue;
+			}
+
+			++m_statistics.decoded_images;
+			m_statistics.file_bytes += job.file_bytes;
+			m_statistics.decoded_bytes += job.image.data.size();
+			m_statistics.decode_ms += job.decode_ms;
+			if (m_statistics.decode_ms > 0.0)
+				m_statistics.decode_megabytes_per_second = m_statistics.decoded_bytes / (1024.0 * 1024.0) / (m_statistics.decode_ms / 1000.0);
+
+			if (job.result) {
+				m_uploading.push_back(texture);
+				continue;
+			}
+			std::cerr << "TextureManager: " << entry.path << ": " << job.error << "\n";
+			entry.error = job.error;
+			//Не перечиталась после сброса уровней - остаётся уменьшенной до конца
+			if (entry.pTexture) {
+				entry.restore_failed = true;
+				++m_statistics.failed_restores;
+			}
+			else {
+				entry.status = EStatus::Failed;
+				++m_statistics.failed;
+			}
+			entry.pJob = nullptr;
+		}
+		m_decoding.resize(still_decoding);
+
+		size_t uploads_done = 0;
+		for (; uploads_done < m_uploading.size(); ++uploads_done) {
+			if (!upload(m_entries[m_uploading[uploads_done]]))
+				break;
+		}
+		m_uploading.erase(m_uploading.begin(), m_uploading.begin() + uploads_done);
+
+		enforce_memory_budget();
+		restore_dropped_levels();
+	}
+
+	bool TextureManager::upload(Entry& entry) {
+
+		const Image& image = entry.pJob->image;
+		const size_t size = image.data.size();
+		if (m_uploaded_this_frame > 0 && m_uploaded_this_frame + size > settings.upload_budget_bytes)
+			return false;
+
+		const auto start_time = std::chrono::steady_clock::now();
+		const bool gpu_mips = !entry.pJob->generate_mips && image.format == EImageFormat::RGBA8 && image.levels.size() == 1;
+		const unsigned int levels_count = gpu_mips ? get_mip_levels_count(image.get_width(), image.get_height()) : static_cast<unsigned int>(image.levels.size());
+		auto pTexture = std::make_unique<Texture2D>(image.get_width(), image.get_height(), levels_count, image.format, image.srgb);
+
+		//Копия в PBO, из него glTexSubImage2D идёт асинхронно - без ожидания, пока драйвер заберёт память картинки.
+		//Буфер каждый раз "осиротевает", чтобы не ждать прошлую загрузку
+		if (!m_pixel_buffer_id)
+			glGenBuffers(1, &m_pixel_buffer_id);
+		Renderer_OpenGL::bind_buffer(EBufferTarget::PixelUnpack, m_pixel_buffer_id);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		void* pMappedData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (pMappedData) {
+			std::memcpy(pMappedData, image.data.data(), size);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		}
+		else {
+			Renderer_OpenGL::bind_buffer(EBufferTarget::PixelUnpack, 0);
+		}
+
+		for (size_t level = 0; level < image.levels.size(); ++level) {
+
+			const ImageLevel& image_level = image.levels[level];
+			const void* pData = pMappedData ? reinterpret_cast<const void*>(image_level.offset) : image.data.data() + image_level.offset;
+			pTexture->set_level_data(static_cast<unsigned int>(level), pData, image_level.size);
+		}
+		//Иначе следующие glTex*Image с указателями в память прочитают из буфера
+		Renderer_OpenGL::bind_buffer(EBufferTarget::PixelUnpack, 0);
+		if (gpu_mips)
+			pTexture->generate_mips();
+
+		if (entry.pTexture) {
+			m_statistics.resident_bytes -= entry.pTexture->get_size();
+			++m_statistics.restored_textures;
+		}
+		else {
+			++m_statistics.ready;
+		}
+		entry.full_size = pTexture->get_size();
+		m_statistics.resident_bytes += entry.full_size;
+		entry.pTexture = std::move(pTexture);
+		entry.status = EStatus::Ready;
+		entry.pJob = nullptr;
+
+		m_uploaded_this_frame += size;
+		m_statistics.uploaded_bytes += size;
+		m_statistics.upload_ms += milliseconds_since(start_time);
+		return true;
+	}
+
+	void TextureManager::enforce_memory_budget() {
+
+		while (m_statistics.resident_bytes > settings.memory_budget_bytes) {
+
+			//Дольше всех не использованная, из равных - самая большая
+			Entry* pVictim = nullptr;
+			for (Entry& entry : m_entries) {
+
+				if (!entry.pTexture || entry.pTexture->get_levels_count() < 2)
+					continue;
+				if (!pVictim || entry.last_used_frame < pVictim->last_used_frame
+					|| (entry.last_used_frame == pVictim->last_used_frame && entry.pTexture->get_size() > pVictim->pTexture->get_size()))
+					pVictim = &entry;
+			}
+			if (!pVictim)
+				break;
+
+			const size_t size_before = pVictim->pTexture->get_size();
+			pVictim->pTexture->drop_top_levels(1);
+			const size_t evicted_bytes = size_before - pVictim->pTexture->get_size();
+			m_statistics.resident_bytes -= evicted_bytes;
+			m_statistics.evicted_bytes += evicted_bytes;
+			++m_statistics.evicted_levels;
+		}
+	}
+
+	void TextureManager::restore_dropped_levels() {
+
+		//Запас в четверть бюджета: иначе перечитанная текстура сразу же снова теряла бы уровни
+		const size_t restore_budget = settings.memory_budget_bytes - settings.memory_budget_bytes / 4;
+		size_t planned_bytes = m_statistics.resident_bytes;
+		for (size_t texture = 0; texture < m_entries.size(); ++texture) {
+
+			Entry& entry = m_entries[texture];
+			if (!entry.pTexture || entry.pJob || entry.restore_failed || entry.last_used_frame + 1 < m_frame)
+				continue;
+			const size_t missing_bytes = entry.full_size - entry.pTexture->get_size();
+			if (missing_bytes == 0 || planned_bytes + missing_bytes > restore_budget)
+				continue;
+			planned_bytes += missing_bytes;
+			start_decode(texture);
+		}
+	}
+}
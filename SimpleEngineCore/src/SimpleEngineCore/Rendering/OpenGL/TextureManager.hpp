@@ -0,0 +1,126 @@
+#pragma once
+#include "Texture2D.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+#include "SimpleEngineCore/ImageDecoder.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SimpleEngine {
+
+	//Текстуры из файлов без остановки кадра: чтение, декодирование и мипы - в задачах JobSystem, в update() готовые
+	//картинки уходят на GPU через PBO не больше upload_budget_bytes за кадр. Если текстуры занимают больше
+	//memory_budget_bytes, у давно не использованных сбрасываются подробные уровни, пока не влезем; когда место
+	//появится, используемая текстура перечитывается целиком. Все вызовы - из потока с GL контекстом
+	class TextureManager {
+	public:
+		static constexpr size_t invalid_texture = ~static_cast<size_t>(0);
+
+		enum class EStatus {
+
+			Loading,
+			Ready,
+			Failed
+		};
+
+		struct Settings {
+
+			size_t memory_budget_bytes = 256ull * 1024 * 1024;
+			//Не меньше одной текстуры за update(), даже если она больше
+			size_t upload_budget_bytes = 16ull * 1024 * 1024;
+			//Мипы RGBA8 без своих уровней: glGenerateMipmap вместо фильтра в рабочем потоке
+			bool gpu_mips = false;
+		};
+
+		struct Statistics {
+
+			size_t textures = 0;
+			size_t ready = 0;
+			size_t failed = 0;
+			size_t decoded_images = 0;
+			size_t file_bytes = 0;
+			size_t decoded_bytes = 0;//Пиксели со всеми уровнями, построенными в рабочих потоках
+			double decode_ms = 0.0;//Сумма по задачам, включая мипы
+			double decode_megabytes_per_second = 0.0;//decoded_bytes за decode_ms одного потока
+			size_t uploaded_bytes = 0;
+			double upload_ms = 0.0;
+			size_t resident_bytes = 0;
+			size_t evicted_levels = 0;
+			size_t evicted_bytes = 0;
+			size_t restored_textures = 0;//Перечитаны после сброса уровней
+			size_t failed_restores = 0;
+		};
+
+		//Без pJobSystem (или с ним, но без рабочих потоков) картинки декодируются в update() по одной за вызов
+		explicit TextureManager(JobSystem* pJobSystem = nullptr);
+		TextureManager(const TextureManager&) = delete;
+		TextureManager& operator=(const TextureManager&) = delete;
+		//Ждёт незавершённые задачи - они пишут в свои записи
+		~TextureManager();
+
+		//Номер текстуры для use/get_status; файл, уже запрошенный раньше, получает тот же номер.
+		//Без GL контекста в этом потоке - invalid_texture: записи в это время может менять update()
+		size_t load(const std::string& path);
+		//Раз в кадр до отрисовки: готовые картинки - на GPU, затем соблюдение бюджета памяти
+		void update();
+
+		//nullptr, пока текстура не загружена или если не загрузилась. Отмечает использование в этом кадре
+		const Texture2D* use(const size_t texture);
+		EStatus get_status(const size_t texture) const { return texture < m_entries.size() ? m_entries[texture].status : EStatus::Failed; }
+		const std::string& get_error(const size_t texture) const;
+		size_t get_textures_count() const { return m_entries.size(); }
+		const Statistics& get_statistics() const { return m_statistics; }
+
+		Settings settings;
+
+	private:
+		//Живёт в куче: JobSystem держит указатель на неё и на counter до конца задачи
+		struct DecodeJob {
+
+			std::string path;
+			bool generate_mips = true;
+			Image image;
+			std::string error;
+			bool result = false;
+			size_t file_bytes = 0;
+			double decode_ms = 0.0;
+			JobCounter counter;
+
+			void operator()();
+		};
+
+		struct Entry {
+
+			std::string path;
+			EStatus status = EStatus::Loading;
+			std::string error;
+			std::unique_ptr<Texture2D> pTexture;
+			//Пока есть - идёт загрузка (или перечитывание после сброса уровней, тогда pTexture ещё старая)
+			std::unique_ptr<DecodeJob> pJob;
+			uint64_t last_used_frame = 0;
+			size_t full_size = 0;//Со всеми уровнями, до сброса
+			//Перечитать не удалось - остаётся со сброшенными уровнями, иначе пробовали бы каждый кадр
+			bool restore_failed = false;
+		};
+
+		void start_decode(const size_t texture);
+		//false - не влезает в бюджет загрузки этого кадра
+		bool upload(Entry& entry);
+		void enforce_memory_budget();
+		void restore_dropped_levels();
+
+		JobSystem* m_pJobSystem = nullptr;
+		std::vector<Entry> m_entries;
+		std::unordered_map<std::string, size_t> m_textures_by_path;
+		//Номера с задачей декодирования в порядке запуска и декодированные, ждущие загрузки на GPU
+		std::vector<size_t> m_decoding;
+		std::vector<size_t> m_uploading;
+		unsigned int m_pixel_buffer_id = 0;
+		uint64_t m_frame = 1;
+		size_t m_uploaded_this_frame = 0;
+		Statistics m_statistics;
+	};
+}
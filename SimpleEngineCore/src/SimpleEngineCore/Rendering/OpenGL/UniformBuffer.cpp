@@ -0,0 +1,117 @@
+#include "UniformBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
+#include <glad/glad.h>
+#include <cstring>
+#include <iostream>
+
+namespace SimpleEngine {
+
+	struct UniformBlockName {
+
+		const char* name;
+		UniformBlockBinding binding;
+	};
+
+	constexpr UniformBlockName uniform_block_names[] = {
+		{ "CameraData", UniformBlockBinding::Camera }
+	};
+
+	UniformBuffer::UniformBuffer(const size_t size, const UniformBlockBinding binding, const bool persistent)
+		: m_size(size)
+		, m_binding(binding) {
+
+		glGenBuffers(1, &m_id);
+		if (persistent && GLAD_GL_VERSION_4_4) {
+			m_pMappedData = Renderer_OpenGL::create_persistent_storage(EBufferTarget::Uniform, m_id, nullptr, size);
+		}
+		else {
+			Renderer_OpenGL::bind_buffer(EBufferTarget::Uniform, m_id);
+			glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBindBufferBase(GL_UNIFORM_BUFFER, static_cast<GLuint>(binding), m_id);
+	}
+
+	UniformBuffer& UniformBuffer::operator=(UniformBuffer&& uniform_buffer) noexcept {
+
+		//Свой буфер удаляем (постоянное отображение снимается вместе с ним), иначе он течёт, а кэш привязок помнит его id
+		if (this != &uniform_buffer) {
+			Renderer_OpenGL::on_buffer_deleted(m_id);
+			glDeleteBuffers(1, &m_id);
+		}
+		m_id = uniform_buffer.m_id;
+		m_size = uniform_buffer.m_size;
+		m_binding = uniform_buffer.m_binding;
+		m_pMappedData = uniform_buffer.m_pMappedData;
+		uniform_buffer.m_id = 0;
+		uniform_buffer.m_size = 0;
+		uniform_buffer.m_pMappedData = nullptr;
+		return *this;
+	}
+
+	UniformBuffer::UniformBuffer(UniformBuffer&& uniform_buffer) noexcept
+		: m_id(uniform_buffer.m_id)
+		, m_size(uniform_buffer.m_size)
+		, m_binding(uniform_buffer.m_binding)
+		, m_pMappedData(uniform_buffer.m_pMappedData) {
+
+		uniform_buffer.m_id = 0;
+		uniform_buffer.m_size = 0;
+		uniform_buffer.m_pMappedData = nullptr;
+	}
+
+	void UniformBuffer::update_buffer(const void* data, const size_t size, const size_t offset) const {
+
+		if (offset + size > m_size) {
+			std::cout << "UniformBuffer::update_buffer: " << size << " bytes at " << offset << " don't fit into " << m_size << "\n";
+			return;
+		}
+
+		if (m_pMappedData) {
+			std::memcpy(static_cast<char*>(m_pMappedData) + offset, data, size);
+			return;
+		}
+
+		Renderer_OpenGL::bind_buffer(EBufferTarget::Uniform, m_id);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	}
+
+	void UniformBuffer::orphan() const {
+
+		if (m_pMappedData)
+			return;
+
+		Renderer_OpenGL::bind_buffer(EBufferTarget::Uniform, m_id);
+		glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	void UniformBuffer::bind_range(const size_t offset, const size_t size) const {
+
+		//glBindBufferRange меняет и общую точку GL_UNIFORM_BUFFER - держим кэш в курсе
+		Renderer_OpenGL::bind_buffer(EBufferTarget::Uniform, m_id);
+		glBindBufferRange(GL_UNIFORM_BUFFER, static_cast<GLuint>(m_binding), m_id, offset, size);
+	}
+
+	size_t UniformBuffer::get_offset_alignment() {
+
+		static const size_t offset_alignment = [] {
+			GLint alignment = 256;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			return static_cast<size_t>(alignment);
+		}();
+		return offset_alignment;
+	}
+
+	int UniformBuffer::get_block_binding(const char* block_name) {
+
+		for (const UniformBlockName& block : uniform_block_names) {
+			if (std::strcmp(block.name, block_name) == 0)
+				return static_cast<int>(block.binding);
+		}
+		return -1;
+	}
+
+	UniformBuffer::~UniformBuffer() {
+		Renderer_OpenGL::on_buffer_deleted(m_id);
+		glDeleteBuffers(1, &m_id);
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+#include <cstddef>
+
+namespace SimpleEngine {
+
+	//Uniform block'и движка живут на фиксированных точках привязки.
+	//ShaderProgram после линковки сам связывает с ними блоки с теми же именами.
+	enum class UniformBlockBinding : unsigned int {
+
+		Camera = 0
+	};
+
+	//Раскладка std140 совпадает с блоком в шейдерах:
+	//layout(std140) uniform CameraData { mat4 view_matrix; mat4 projection_matrix; mat4 view_projection_matrix; vec4 camera_position; };
+	struct CameraData {
+
+		glm::mat4 view_matrix;
+		glm::mat4 projection_matrix;
+		glm::mat4 view_projection_matrix;
+		glm::vec4 camera_position;
+	};
+
+	class UniformBuffer {
+	public:
+		//persistent - glBufferStorage с постоянным отображением (для RingBuffer), без GL 4.4 - обычный буфер
+		UniformBuffer(const size_t size, const UniformBlockBinding binding, const bool persistent = false);
+		~UniformBuffer();
+
+		UniformBuffer(const UniformBuffer&) = delete;
+		UniformBuffer& operator=(const UniformBuffer&) = delete;
+		UniformBuffer& operator=(UniformBuffer&& uniform_buffer) noexcept;
+		UniformBuffer(UniformBuffer&& uniform_buffer) noexcept;
+
+		void update_buffer(const void* data, const size_t size, const size_t offset = 0) const;
+		void orphan() const;
+		//Привязывает к точке блока только часть буфера, offset кратен get_offset_alignment()
+		void bind_range(const size_t offset, const size_t size) const;
+		size_t get_size() const { return m_size; }
+		void* get_mapped_data() const { return m_pMappedData; }
+
+		static size_t get_offset_alignment();
+
+		//-1, если блок с таким именем движку неизвестен
+		static int get_block_binding(const char* block_name);
+
+	private:
+		unsigned int m_id = 0;
+		size_t m_size = 0;
+		UniformBlockBinding m_binding = UniformBlockBinding::Camera;
+		void* m_pMappedData = nullptr;
+	};
+}
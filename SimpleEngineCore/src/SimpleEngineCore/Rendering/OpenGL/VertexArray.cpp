@@ -1,4 +1,5 @@
 #include "VertexArray.hpp"
+#include "Renderer_OpenGL.hpp"
 #include <glad/glad.h>
 
 namespace SimpleEngine {
@@ -11,6 +12,8 @@ namespace SimpleEngine {
 
 		m_id = vertex_array.m_id;
 		m_elements_count = vertex_array.m_id;
+		m_indexes_count = vertex_array.m_indexes_count;
+		m_index_type = vertex_array.m_index_type;
 		vertex_array.m_id = 0;
 		vertex_array.m_elements_count = 0;
 		return *this;
@@ -18,36 +21,43 @@ namespace SimpleEngine {
 
 	VertexArray::VertexArray(VertexArray&& vertex_array) noexcept
 		: m_id(vertex_array.m_id)
-		, m_elements_count(vertex_array.m_elements_count) {
+		, m_elements_count(vertex_array.m_elements_count)
+		, m_indexes_count(vertex_array.m_indexes_count)
+		, m_index_type(vertex_array.m_index_type) {
 
 		vertex_array.m_id = 0;
 		vertex_array.m_elements_count = 0;
 	}
 
 	void VertexArray::bind() const {
-		glBindVertexArray(m_id);
+		Renderer_OpenGL::bind_vertex_array(m_id);
 	}
 
 	void VertexArray::unbind() {
-		glBindVertexArray(0);
+		Renderer_OpenGL::bind_vertex_array(0);
 	}
 
 	void VertexArray::add_vertex_buffer(const VertexBuffer& vertex_buffer) {
 
-		bind();// VertexArray 
-		vertex_buffer.bind();// VertexBuffer 
+		bind();//Делаем VertexArray текущим
+		vertex_buffer.bind();//Делаем VertexBuffer текущим
 
 		for (const BufferElement& current_element : vertex_buffer.get_layout().get_elements()) {
-			glEnableVertexAttribArray(m_elements_count);
-			glVertexAttribPointer (
-				m_elements_count,
-				static_cast<GLint>(current_element.components_count),
-				current_element.component_type,
-				GL_FALSE,
-				static_cast<GLsizei>(vertex_buffer.get_layout().get_stride()),
-				reinterpret_cast<const void*>(current_element.offset)
-			);
-			++m_elements_count;
+			//Матрица занимает несколько location'ов подряд - по одному на столбец
+			const size_t slot_size = current_element.size / current_element.slots_count;
+			for (size_t slot = 0; slot < current_element.slots_count; ++slot) {
+				glEnableVertexAttribArray(m_elements_count);
+				glVertexAttribPointer (
+					m_elements_count,
+					static_cast<GLint>(current_element.components_count),
+					current_element.component_type,
+					current_element.normalized ? GL_TRUE : GL_FALSE,
+					static_cast<GLsizei>(vertex_buffer.get_layout().get_stride()),
+					reinterpret_cast<const void*>(current_element.offset + slot * slot_size)
+				);
+				glVertexAttribDivisor(m_elements_count, current_element.divisor);
+				++m_elements_count;
+			}
 		}
 	}
 
@@ -56,9 +66,11 @@ namespace SimpleEngine {
 		bind();
 		index_buffer.bind();
 		m_indexes_count = index_buffer.get_count();
+		m_index_type = index_buffer.get_type();
 	}
 
 	VertexArray::~VertexArray() {
+		Renderer_OpenGL::on_vertex_array_deleted(m_id);
 		glDeleteVertexArrays(1, &m_id);
 	}
 }
\ No newline at end of file
@@ -17,6 +17,8 @@ namespace SimpleEngine {
 		void bind() const;
 		static void unbind();
 		size_t get_indexes_count() const { return m_indexes_count; }
+		IndexBuffer::EType get_index_type() const { return m_index_type; }
+		unsigned int get_id() const { return m_id; }
 
 		~VertexArray();
 
@@ -24,5 +26,6 @@ namespace SimpleEngine {
 		unsigned int m_id = 0;
 		unsigned int m_elements_count = 0;
 		size_t m_indexes_count = 0;
+		IndexBuffer::EType m_index_type = IndexBuffer::EType::UnsignedInt;
 	};
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "VertexBuffer.hpp"
+#include "Renderer_OpenGL.hpp"
 #include <glad/glad.h>
 #include <iostream>
+#include <cstring>
 
 namespace SimpleEngine {
 	
@@ -13,14 +15,21 @@ namespace SimpleEngine {
 
 			case ShaderDataType::Float2:
 			case ShaderDataType::Int2:
+			case ShaderDataType::Half2:
+			case ShaderDataType::UShort2N:
 				return 2;
 
 			case ShaderDataType::Float3:
 			case ShaderDataType::Int3:
+			case ShaderDataType::Mat3:
 				return 3;
 
 			case ShaderDataType::Float4:
 			case ShaderDataType::Int4:
+			case ShaderDataType::Mat4:
+			case ShaderDataType::Half4:
+			case ShaderDataType::Byte4N:
+			case ShaderDataType::UByte4N:
 				return 4;
 		}
 
@@ -28,6 +37,20 @@ namespace SimpleEngine {
 		return 0;
 	}
 
+	constexpr unsigned int shader_data_type_to_slots_count(const ShaderDataType type) {
+
+		switch (type) {
+			case ShaderDataType::Mat3:
+				return 3;
+
+			case ShaderDataType::Mat4:
+				return 4;
+
+			default:
+				return 1;
+		}
+	}
+
 	constexpr size_t shader_data_type_size(const ShaderDataType type) {
 
 		switch (type) {
@@ -35,13 +58,24 @@ namespace SimpleEngine {
 			case ShaderDataType::Float2:
 			case ShaderDataType::Float3:
 			case ShaderDataType::Float4:
-				return sizeof(GLfloat) * shader_data_type_to_components_count(type);
+			case ShaderDataType::Mat3:
+			case ShaderDataType::Mat4:
+				return sizeof(GLfloat) * shader_data_type_to_components_count(type) * shader_data_type_to_slots_count(type);
 
 			case ShaderDataType::Int:
 			case ShaderDataType::Int2:
 			case ShaderDataType::Int3:
 			case ShaderDataType::Int4:
 				return sizeof(GLint) * shader_data_type_to_components_count(type);
+
+			case ShaderDataType::Half2:
+			case ShaderDataType::Half4:
+			case ShaderDataType::UShort2N:
+				return sizeof(GLushort) * shader_data_type_to_components_count(type);
+
+			case ShaderDataType::Byte4N:
+			case ShaderDataType::UByte4N:
+				return sizeof(GLbyte) * shader_data_type_to_components_count(type);
 		}
 
 		std::cout << "Shader_data_type_size: unknown ShaderDataType!";
@@ -55,6 +89,8 @@ namespace SimpleEngine {
 			case ShaderDataType::Float2:
 			case ShaderDataType::Float3:
 			case ShaderDataType::Float4:
+			case ShaderDataType::Mat3:
+			case ShaderDataType::Mat4:
 				return GL_FLOAT;
 
 			case ShaderDataType::Int:
@@ -62,6 +98,19 @@ namespace SimpleEngine {
 			case ShaderDataType::Int3:
 			case ShaderDataType::Int4:
 				return GL_INT;
+
+			case ShaderDataType::Half2:
+			case ShaderDataType::Half4:
+				return GL_HALF_FLOAT;
+
+			case ShaderDataType::Byte4N:
+				return GL_BYTE;
+
+			case ShaderDataType::UByte4N:
+				return GL_UNSIGNED_BYTE;
+
+			case ShaderDataType::UShort2N:
+				return GL_UNSIGNED_SHORT;
 		}
 
 		std::cout << "Shader_data_type_to_component_type: unknown ShaderDataType!";
@@ -75,50 +124,114 @@ namespace SimpleEngine {
 			case VertexBuffer::EUsage::Static: return GL_STATIC_DRAW;
 			case VertexBuffer::EUsage::Dynamic: return GL_DYNAMIC_DRAW;
 			case VertexBuffer::EUsage::Stream: return GL_STREAM_DRAW;
+			case VertexBuffer::EUsage::Persistent: return GL_STREAM_DRAW;
 		}
 
 		std::cout << "Unknown VertexBuffer usage";
 		return GL_STREAM_DRAW;
 	}
 
-	BufferElement::BufferElement(const ShaderDataType _type)
+	BufferElement::BufferElement(const ShaderDataType _type, const unsigned int _divisor)
 		: type(_type)
 		, component_type(shader_data_type_to_component_type(_type))
 		, components_count(shader_data_type_to_components_count(_type))
+		, slots_count(shader_data_type_to_slots_count(_type))
 		, size(shader_data_type_size(_type))
-		, offset(0) {}
+		, offset(0)
+		, divisor(_divisor)
+		, normalized(_type == ShaderDataType::Byte4N || _type == ShaderDataType::UByte4N || _type == ShaderDataType::UShort2N) {}
 
 	VertexBuffer::VertexBuffer(const void* data, const size_t size, BufferLayout buffer_layout, const EUsage usage)
-		: m_buffer_layout(std::move(buffer_layout)) {
+		: m_buffer_layout(std::move(buffer_layout))
+		, m_size(size)
+		, m_usage(usage) {
 
 		glGenBuffers(1, &m_id);
-		glBindBuffer(GL_ARRAY_BUFFER, m_id);
+		Renderer_OpenGL::bind_buffer(EBufferTarget::Array, m_id);
+		if (usage == EUsage::Persistent && GLAD_GL_VERSION_4_4) {
+			m_pMappedData = Renderer_OpenGL::create_persistent_storage(EBufferTarget::Array, m_id, data, size);
+			return;
+		}
 		glBufferData(GL_ARRAY_BUFFER, size, data, usage_to_GLenum(usage));
 	}
 
 	VertexBuffer& VertexBuffer::operator=(VertexBuffer&& vertex_buffer) noexcept {
 
 		m_id = vertex_buffer.m_id;
+		m_size = vertex_buffer.m_size;
+		m_usage = vertex_buffer.m_usage;
+		m_pMappedData = vertex_buffer.m_pMappedData;
 		vertex_buffer.m_id = 0;
+		vertex_buffer.m_size = 0;
+		vertex_buffer.m_pMappedData = nullptr;
 		return *this;
 	}
 
 	VertexBuffer::VertexBuffer(VertexBuffer&& vertex_buffer) noexcept
 		: m_id(vertex_buffer.m_id)
-		, m_buffer_layout(std::move(vertex_buffer.m_buffer_layout)) {
+		, m_buffer_layout(std::move(vertex_buffer.m_buffer_layout))
+		, m_size(vertex_buffer.m_size)
+		, m_usage(vertex_buffer.m_usage)
+		, m_pMappedData(vertex_buffer.m_pMappedData) {
 
 		vertex_buffer.m_id = 0;
+		vertex_buffer.m_size = 0;
+		vertex_buffer.m_pMappedData = nullptr;
 	}
 
 	void VertexBuffer::bind() const {
-		glBindBuffer(GL_ARRAY_BUFFER, m_id);
+		Renderer_OpenGL::bind_buffer(EBufferTarget::Array, m_id);
 	}
 
 	void VertexBuffer::unbind() {
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		Renderer_OpenGL::bind_buffer(EBufferTarget::Array, 0);
+	}
+
+	void VertexBuffer::update_buffer(const void* data, const size_t size) const {
+
+		if (size > m_size) {
+			std::cout << "VertexBuffer::update_buffer: " << size << " bytes don't fit into " << m_size << "\n";
+			return;
+		}
+
+		if (m_pMappedData) {
+			std::memcpy(m_pMappedData, data, size);
+			return;
+		}
+
+		bind();
+		if (m_usage != EUsage::Static)
+			glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, usage_to_GLenum(m_usage));
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+	}
+
+	void VertexBuffer::update_buffer_range(const void* data, const size_t size, const size_t offset) const {
+
+		if (offset + size > m_size) {
+			std::cout << "VertexBuffer::update_buffer_range: [" << offset << ", " << offset + size << ") doesn't fit into " << m_size << "\n";
+			return;
+		}
+
+		if (m_pMappedData) {
+			std::memcpy(static_cast<char*>(m_pMappedData) + offset, data, size);
+			return;
+		}
+
+		bind();
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	}
+
+	void VertexBuffer::orphan() const {
+
+		if (m_pMappedData || m_usage == EUsage::Static)
+			return;
+
+		bind();
+		glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, usage_to_GLenum(m_usage));
 	}
 
 	VertexBuffer::~VertexBuffer() {
+		Renderer_OpenGL::on_buffer_deleted(m_id);
 		glDeleteBuffers(1, &m_id);
 	}
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 
 namespace SimpleEngine {
 
@@ -12,23 +14,40 @@ namespace SimpleEngine {
 		Int,
 		Int2,
 		Int3,
-		Int4
+		Int4,
+		Mat3,
+		Mat4,
+		//Сжатые атрибуты: в шейдере это по-прежнему float/vec, преобразует GPU при выборке.
+		//N - нормализованные целые: [-1, 1] для знаковых, [0, 1] для беззнаковых
+		Half2,
+		Half4,//Half3 занял бы 6 байт - атрибуты лучше держать кратными 4
+		Byte4N,
+		UByte4N,
+		UShort2N
 	};
 
 	struct BufferElement {
 
 		ShaderDataType type;
 		uint32_t component_type;
-		size_t components_count;
+		size_t components_count;//Для матриц - компонент в одном столбце
+		size_t slots_count;//Сколько location'ов занимает атрибут: Mat4 - 4 слота Float4
 		size_t size;
 		size_t offset;
+		unsigned int divisor;//0 - атрибут вершины, 1 - атрибут экземпляра (instancing)
+		bool normalized;
 
-		BufferElement(const ShaderDataType type);
+		BufferElement(const ShaderDataType type, const unsigned int divisor = 0);
 	};
 
 	class BufferLayout {
 	public:
 		BufferLayout(std::initializer_list<BufferElement> elements)
+			: BufferLayout(std::vector<BufferElement>(elements)) {
+		}
+
+		//Раскладка, известная только во время выполнения (например, из файла меша)
+		explicit BufferLayout(std::vector<BufferElement> elements)
 			: m_elements(std::move(elements)) {
 
 			size_t offset = 0;
@@ -45,7 +64,7 @@ namespace SimpleEngine {
 
 	private:
 		std::vector<BufferElement> m_elements;
-		size_t m_stride = 0;//      
+		size_t m_stride = 0;//Через какое количество байт идёт следующий элемент
 	};
 
 	class VertexBuffer {
@@ -55,7 +74,8 @@ namespace SimpleEngine {
 
 			Static,
 			Dynamic,
-			Stream
+			Stream,
+			Persistent//glBufferStorage + постоянно отображённая память; без GL 4.4 - как Stream
 		};
 
 		VertexBuffer(const void* data, const size_t size, BufferLayout buffer_layout, const EUsage usage = VertexBuffer::EUsage::Static);
@@ -67,13 +87,25 @@ namespace SimpleEngine {
 
 		void bind() const;
 		static void unbind();
+		//Для Dynamic/Stream буфер сначала "осиротевает", чтобы не ждать GPU
+		void update_buffer(const void* data, const size_t size) const;
+		//Без "осиротения": пишет только в [offset, offset + size)
+		void update_buffer_range(const void* data, const size_t size, const size_t offset) const;
+		//Отдаёт драйверу старое хранилище целиком (для Persistent с отображением ничего не делает)
+		void orphan() const;
+		//Для Persistent - указатель на отображённую память буфера, иначе nullptr
+		void* get_mapped_data() const { return m_pMappedData; }
 
 		const BufferLayout& get_layout() const { return m_buffer_layout; }
+		size_t get_size() const { return m_size; }
 
 		~VertexBuffer();
 
 	private:
 		unsigned int m_id = 0;
 		BufferLayout m_buffer_layout;
+		size_t m_size = 0;
+		EUsage m_usage = EUsage::Static;
+		void* m_pMappedData = nullptr;
 	};
 }
\ No newline at end of file
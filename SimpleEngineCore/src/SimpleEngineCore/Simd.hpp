@@ -0,0 +1,7 @@
+#pragma once
+
+//SSE есть на любом x86-64; на других платформах ядра уходят в скалярную ветку
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define SIMPLE_ENGINE_USE_SSE 1
+#include <xmmintrin.h>
+#endif
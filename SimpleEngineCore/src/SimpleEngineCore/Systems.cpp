@@ -0,0 +1,175 @@
+#include "SimpleEngineCore/Systems.hpp"
+#include "SimpleEngineCore/Registry.hpp"
+#include "SimpleEngineCore/Components.hpp"
+#include "SimpleEngineCore/Frustum.hpp"
+#include "SimpleEngineCore/Bvh.hpp"
+#include "SimpleEngineCore/Camera.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/RenderQueue.hpp"
+
+#include <glm/geometric.hpp>
+#include <algorithm>
+
+namespace SimpleEngine {
+
+	//Радиус растягиваем на наибольший масштаб по осям
+	static void get_world_sphere(const glm::mat4& world_matrix, const BoundsComponent& bounds, glm::vec3& center, float& radius) {
+
+		const float max_scale = std::max({ glm::length(glm::vec3(world_matrix[0])), glm::length(glm::vec3(world_matrix[1])), glm::length(glm::vec3(world_matrix[2])) });
+		center = glm::vec3(world_matrix * glm::vec4(bounds.center, 1.f));
+		radius = bounds.radius * max_scale;
+	}
+
+	void submit_mesh_renderers(Registry& registry, const TransformHierarchy& transform_hierarchy, RenderQueue& render_queue) {
+
+		registry.each<MeshRendererComponent, TransformComponent>(
+			[&transform_hierarchy, &render_queue](const Entity, const MeshRendererComponent& mesh_renderer, const TransformComponent& transform) {
+				if (mesh_renderer.pShaderProgram && mesh_renderer.pVertexArray && mesh_renderer.pMaterial && transform_hierarchy.is_valid(transform.node)) {
+					render_queue.submit(*mesh_renderer.pShaderProgram, *mesh_renderer.pVertexArray, *mesh_renderer.pMaterial,
+										transform_hierarchy.get_render_matrix(transform.node), mesh_renderer.pass, mesh_renderer.first_index, mesh_renderer.indexes_count);
+				}
+			}
+		);
+	}
+
+	void submit_visible_mesh_renderers(Registry& registry, const TransformHierarchy& transform_hierarchy, const Frustum& frustum,
+									   FrustumCuller& frustum_culler, RenderQueue& render_queue, JobSystem* pJobSystem) {
+
+		ComponentPool<BoundsComponent>& bounds_pool = registry.get_pool<BoundsComponent>();
+		auto is_renderable = [&transform_hierarchy](const MeshRendererComponent& mesh_renderer, const TransformComponent& transform) {
+			return mesh_renderer.pShaderProgram && mesh_renderer.pVertexArray && mesh_renderer.pMaterial && transform_hierarchy.is_valid(transform.node);
+		};
+
+		//Первый проход: сферы в мировые координаты, сущности без границ - сразу в очередь
+		frustum_culler.clear();
+		frustum_culler.reserve(bounds_pool.size());
+		registry.each<MeshRendererComponent, TransformComponent>(
+			[&](const Entity entity, const MeshRendererComponent& mesh_renderer, const TransformComponent& transform) {
+				if (!is_renderable(mesh_renderer, transform))
+					return;
+
+				const glm::mat4& world_matrix = transform_hierarchy.get_render_matrix(transform.node);
+				const BoundsComponent* pBounds = bounds_pool.try_get(entity);
+				if (!pBounds) {
+					render_queue.submit(*mesh_renderer.pShaderProgram, *mesh_renderer.pVertexArray, *mesh_renderer.pMaterial, world_matrix,
+										mesh_renderer.pass, mesh_renderer.first_index, mesh_renderer.indexes_count);
+					return;
+				}
+
+				glm::vec3 center;
+				float radius;
+				get_world_sphere(world_matrix, *pBounds, center, radius);
+				frustum_culler.add_sphere(center, radius);
+			}
+		);
+
+		//Второй проход в том же порядке: индексы видимых отсортированы, идём по ним курсором
+		const std::vector<uint32_t>& visible = frustum_culler.cull(frustum, pJobSystem);
+		uint32_t sphere_index = 0;
+		size_t visible_cursor = 0;
+		registry.each<MeshRendererComponent, TransformComponent>(
+			[&](const Entity entity, const MeshRendererComponent& mesh_renderer, const TransformComponent& transform) {
+				if (visible_cursor == visible.size() || !is_renderable(mesh_renderer, transform) || !bounds_pool.contains(entity))
+					return;
+
+				if (visible[visible_cursor] == sphere_index++) {
+					render_queue.submit(*mesh_renderer.pShaderProgram, *mesh_renderer.pVertexArray, *mesh_renderer.pMaterial,
+										transform_hierarchy.get_render_matrix(transform.node), mesh_renderer.pass, mesh_renderer.first_index, mesh_renderer.indexes_count);
+					++visible_cursor;
+				}
+			}
+		);
+	}
+
+	void gather_world_bounds(Registry& registry, const TransformHierarchy& transform_hierarchy, std::vector<Entity>& entities, std::vector<Aabb>& bounds) {
+
+		entities.clear();
+		bounds.clear();
+		registry.each<BoundsComponent, TransformComponent>(
+			[&](const Entity entity, const BoundsComponent& bounds_component, const TransformComponent& transform) {
+				if (!transform_hierarchy.is_valid(transform.node))
+					return;
+
+				glm::vec3 center;
+				float radius;
+				get_world_sphere(transform_hierarchy.get_render_matrix(transform.node), bounds_component, center, radius);
+				entities.push_back(entity);
+				bounds.push_back({ center - glm::vec3(radius), center + glm::vec3(radius) });
+			}
+		);
+	}
+
+	void submit_visible_mesh_renderers(Registry& registry, const TransformHierarchy& transform_hierarchy, const Frustum& frustum,
+									   Bvh& bvh, const std::vector<Entity>& bvh_entities, std::vector<uint32_t>& visible, RenderQueue& render_queue) {
+
+		ComponentPool<MeshRendererComponent>& mesh_renderer_pool = registry.get_pool<MeshRendererComponent>();
+		ComponentPool<TransformComponent>& transform_pool = registry.get_pool<TransformComponent>();
+		ComponentPool<BoundsComponent>& bounds_pool = registry.get_pool<BoundsComponent>();
+		registry.each<MeshRendererComponent, TransformComponent>(
+			[&](const Entity entity, const MeshRendererComponent& mesh_renderer, const TransformComponent& transform) {
+				if (bounds_pool.contains(entity) || !mesh_renderer.pShaderProgram || !mesh_renderer.pVertexArray || !mesh_renderer.pMaterial
+					|| !transform_hierarchy.is_valid(transform.node))
+					return;
+				render_queue.submit(*mesh_renderer.pShaderProgram, *mesh_renderer.pVertexArray, *mesh_renderer.pMaterial,
+									transform_hierarchy.get_render_matrix(transform.node), mesh_renderer.pass, mesh_renderer.first_index, mesh_renderer.indexes_count);
+			}
+		);
+
+		bvh.cull(frustum, visible);
+		for (const uint32_t primitive : visible) {
+
+			const Entity entity = bvh_entities[primitive];
+			const MeshRendererComponent* pMeshRenderer = mesh_renderer_pool.try_get(entity);
+			const TransformComponent* pTransform = transform_pool.try_get(entity);
+			if (pMeshRenderer && pTransform && pMeshRenderer->pShaderProgram && pMeshRenderer->pVertexArray && pMeshRenderer->pMaterial && transform_hierarchy.is_valid(pTransform->node)) {
+				render_queue.submit(*pMeshRenderer->pShaderProgram, *pMeshRenderer->pVertexArray, *pMeshRenderer->pMaterial,
+									transform_hierarchy.get_render_matrix(pTransform->node), pMeshRenderer->pass, pMeshRenderer->first_index, pMeshRenderer->indexes_count);
+			}
+		}
+	}
+
+	LodStatistics select_lods(Registry& registry, const TransformHierarchy& transform_hierarchy, const Camera& camera,
+							  const float viewport_height, const LodSettings& settings) {
+
+		LodStatistics statistics;
+		ComponentPool<BoundsComponent>& bounds_pool = registry.get_pool<BoundsComponent>();
+		const float pixel_scale = get_lod_pixel_scale(camera, viewport_height);
+		const glm::vec3& camera_position = camera.get_camera_position();
+		registry.each<LodComponent, MeshRendererComponent, TransformComponent>(
+			[&](const Entity entity, LodComponent& lod, MeshRendererComponent& mesh_renderer, const TransformComponent& transform) {
+				const BoundsComponent* pBounds = bounds_pool.try_get(entity);
+				if (lod.lods_count == 0 || !pBounds || !transform_hierarchy.is_valid(transform.node))
+					return;
+
+				glm::vec3 center;
+				float radius;
+				get_world_sphere(transform_hierarchy.get_render_matrix(transform.node), *pBounds, center, radius);
+				const float projected_radius = get_projected_radius(camera, pixel_scale, radius, glm::length(center - camera_position));
+				lod.current_lod = select_lod(lod.pLods, lod.lods_count, lod.current_lod, projected_radius, settings);
+
+				const MeshLod& selected = lod.pLods[lod.current_lod];
+				mesh_renderer.first_index = selected.first_index;
+				mesh_renderer.indexes_count = selected.indexes_count;
+				++statistics.objects;
+				statistics.triangles += selected.indexes_count / 3;
+				statistics.full_detail_triangles += lod.pLods[0].indexes_count / 3;
+			}
+		);
+		return statistics;
+	}
+
+	Camera* find_primary_camera(Registry& registry, Entity* pEntity) {
+
+		ComponentPool<CameraComponent>& cameras_pool = registry.get_pool<CameraComponent>();
+		std::vector<CameraComponent>& camera_components = cameras_pool.get_components();
+		for (size_t i = 0; i < camera_components.size(); ++i) {
+			if (camera_components[i].primary) {
+				if (pEntity)
+					*pEntity = cameras_pool.get_entities()[i];
+				return &camera_components[i].camera;
+			}
+		}
+		if (pEntity)
+			*pEntity = null_entity;
+		return nullptr;
+	}
+}
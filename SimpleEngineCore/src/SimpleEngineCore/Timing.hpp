@@ -0,0 +1,11 @@
+#pragma once
+#include <chrono>
+
+namespace SimpleEngine {
+
+	//Миллисекунды с start - для статистики, которую подсистемы копят в double
+	inline double milliseconds_since(const std::chrono::steady_clock::time_point start) {
+
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
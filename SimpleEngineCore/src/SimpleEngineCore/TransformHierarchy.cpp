@@ -0,0 +1,363 @@
+#include "SimpleEngineCore/TransformHierarchy.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+#include "SimpleEngineCore/Simd.hpp"
+
+#include <glm/trigonometric.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+
+namespace SimpleEngine {
+
+	//Матрицы glm хранятся по столбцам, поэтому столбец - ровно один __m128.
+	//Загрузки невыровненные: std::vector<glm::mat4> не обещает выравнивание на 16
+	void compose_trs(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale, glm::mat4& out) {
+
+		const glm::vec3 rotation_in_radians = glm::radians(rotation);
+		const float cos_x = std::cos(rotation_in_radians.x), sin_x = std::sin(rotation_in_radians.x);
+		const float cos_y = std::cos(rotation_in_radians.y), sin_y = std::sin(rotation_in_radians.y);
+		const float cos_z = std::cos(rotation_in_radians.z), sin_z = std::sin(rotation_in_radians.z);
+
+		//R = Rz * Ry * Rx, столбцы домножаются на масштаб, в последний столбец - перенос
+#ifdef SIMPLE_ENGINE_USE_SSE
+		const __m128 column0 = _mm_setr_ps(cos_z * cos_y, sin_z * cos_y, -sin_y, 0.f);
+		const __m128 column1 = _mm_setr_ps(cos_z * sin_y * sin_x - sin_z * cos_x, sin_z * sin_y * sin_x + cos_z * cos_x, cos_y * sin_x, 0.f);
+		const __m128 column2 = _mm_setr_ps(cos_z * sin_y * cos_x + sin_z * sin_x, sin_z * sin_y * cos_x - cos_z * sin_x, cos_y * cos_x, 0.f);
+		_mm_storeu_ps(&out[0][0], _mm_mul_ps(column0, _mm_set1_ps(scale.x)));
+		_mm_storeu_ps(&out[1][0], _mm_mul_ps(column1, _mm_set1_ps(scale.y)));
+		_mm_storeu_ps(&out[2][0], _mm_mul_ps(column2, _mm_set1_ps(scale.z)));
+		_mm_storeu_ps(&out[3][0], _mm_setr_ps(position.x, position.y, position.z, 1.f));
+#else
+		out[0] = glm::vec4(cos_z * cos_y, sin_z * cos_y, -sin_y, 0.f) * scale.x;
+		out[1] = glm::vec4(cos_z * sin_y * sin_x - sin_z * cos_x, sin_z * sin_y * sin_x + cos_z * cos_x, cos_y * sin_x, 0.f) * scale.y;
+		out[2] = glm::vec4(cos_z * sin_y * cos_x + sin_z * sin_x, sin_z * sin_y * cos_x - cos_z * sin_x, cos_y * cos_x, 0.f) * scale.z;
+		out[3] = glm::vec4(position, 1.f);
+#endif
+	}
+
+	//out = a * b; out может совпадать с b, но не с a
+	void multiply_matrices(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+
+#ifdef SIMPLE_ENGINE_USE_SSE
+		const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+		const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+		const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+		const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+		for (int column = 0; column < 4; ++column) {
+
+			__m128 result = _mm_mul_ps(a0, _mm_set1_ps(b[column][0]));
+			result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(b[column][1])));
+			result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(b[column][2])));
+			result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(b[column][3])));
+			_mm_storeu_ps(&out[column][0], result);
+		}
+#else
+		out = a * b;
+#endif
+	}
+
+	TransformNode TransformHierarchy::create(const TransformNode parent) {
+
+		TransformNode node;
+		if (!m_free_nodes.empty()) {
+			node = m_free_nodes.back();
+			m_free_nodes.pop_back();
+		}
+		else {
+			node = static_cast<TransformNode>(m_node_to_index.size());
+			m_node_to_index.push_back(invalid_transform_node);
+		}
+
+		const uint32_t parent_index = is_valid(parent) ? m_node_to_index[parent] : s_no_parent;
+		const uint32_t depth = parent_index == s_no_parent ? 0 : m_depths[parent_index] + 1;
+		//В конец можно дописывать всегда (родитель уже раньше), но уровни перемешаются - отсортируем перед update
+		if (!m_depths.empty() && depth < m_depths.back())
+			m_bOrderDirty = true;
+
+		m_node_to_index[node] = static_cast<uint32_t>(m_positions.size());
+		m_positions.emplace_back(0.f);
+		m_rotations.emplace_back(0.f);
+		m_scales.emplace_back(1.f);
+		m_local_matrices.emplace_back(1.f);
+		m_world_matrices.emplace_back(1.f);
+		m_previous_world_matrices.emplace_back(1.f);
+		m_render_matrices.emplace_back(1.f);
+		m_parents.push_back(parent_index);
+		m_depths.push_back(depth);
+		m_flags.push_back(LocalDirty | Created);
+		m_index_to_node.push_back(node);
+		return node;
+	}
+
+	void TransformHierarchy::destroy(const TransformNode node) {
+
+		if (!is_valid(node))
+			return;
+
+		//Дети всегда стоят после родителя - поддерево помечается одним проходом вперёд
+		const uint32_t first = m_node_to_index[node];
+		std::vector<uint8_t> removed(m_positions.size(), 0);
+		removed[first] = 1;
+		for (size_t i = first + 1; i < m_positions.size(); ++i) {
+			if (m_parents[i] != s_no_parent && removed[m_parents[i]])
+				removed[i] = 1;
+		}
+		remove_marked(removed);
+	}
+
+	bool TransformHierarchy::is_valid(const TransformNode node) const {
+
+		return node < m_node_to_index.size() && m_node_to_index[node] != invalid_transform_node;
+	}
+
+	void TransformHierarchy::reserve(const size_t count) {
+
+		m_positions.reserve(count);
+		m_rotations.reserve(count);
+		m_scales.reserve(count);
+		m_local_matrices.reserve(count);
+		m_world_matrices.reserve(count);
+		m_previous_world_matrices.reserve(count);
+		m_render_matrices.reserve(count);
+		m_parents.reserve(count);
+		m_depths.reserve(count);
+		m_flags.reserve(count);
+		m_index_to_node.reserve(count);
+		m_node_to_index.reserve(count);
+	}
+
+	void TransformHierarchy::clear() {
+
+		m_positions.clear();
+		m_rotations.clear();
+		m_scales.clear();
+		m_local_matrices.clear();
+		m_world_matrices.clear();
+		m_previous_world_matrices.clear();
+		m_render_matrices.clear();
+		m_parents.clear();
+		m_depths.clear();
+		m_flags.clear();
+		m_index_to_node.clear();
+		m_node_to_index.clear();
+		m_free_nodes.clear();
+		m_bOrderDirty = false;
+		m_bInterpolated = false;
+		m_statistics = Statistics();
+	}
+
+	void TransformHierarchy::set_position(const TransformNode node, const glm::vec3& position) {
+
+		const uint32_t index = m_node_to_index[node];
+		m_positions[index] = position;
+		m_flags[index] |= LocalDirty;
+	}
+
+	void TransformHierarchy::set_rotation(const TransformNode node, const glm::vec3& rotation) {
+
+		const uint32_t index = m_node_to_index[node];
+		m_rotations[index] = rotation;
+		m_flags[index] |= LocalDirty;
+	}
+
+	void TransformHierarchy::set_scale(const TransformNode node, const glm::vec3& scale) {
+
+		const uint32_t index = m_node_to_index[node];
+		m_scales[index] = scale;
+		m_flags[index] |= LocalDirty;
+	}
+
+	void TransformHierarchy::set_local(const TransformNode node, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+
+		const uint32_t index = m_node_to_index[node];
+		m_positions[index] = position;
+		m_rotations[index] = rotation;
+		m_scales[index] = scale;
+		m_flags[index] |= LocalDirty;
+	}
+
+	TransformNode TransformHierarchy::get_parent(const TransformNode node) const {
+
+		const uint32_t parent_index = m_parents[m_node_to_index[node]];
+		return parent_index == s_no_parent ? invalid_transform_node : m_index_to_node[parent_index];
+	}
+
+	void TransformHierarchy::update(JobSystem* pJobSystem) {
+
+		//Меньше узлов на задачу - накладные расходы дороже самих матриц
+		constexpr uint32_t parallel_grain = 1024;
+
+		if (m_bOrderDirty)
+			sort_breadth_first();
+
+		m_statistics = Statistics();
+		m_statistics.nodes = static_cast<unsigned int>(m_positions.size());
+		m_bInterpolated = false;
+
+		if (!pJobSystem || pJobSystem->get_threads_count() == 1 || m_positions.size() <= parallel_grain) {
+			update_range(0, m_positions.size(), m_statistics);
+			return;
+		}
+
+		//Внутри уровня узлы друг от друга не зависят, родители - на предыдущем, уже пересчитанном уровне
+		std::atomic<unsigned int> local_matrices_recomputed{ 0 };
+		std::atomic<unsigned int> world_matrices_recomputed{ 0 };
+		size_t level_begin = 0;
+		while (level_begin < m_positions.size()) {
+
+			size_t level_end = level_begin + 1;
+			while (level_end < m_positions.size() && m_depths[level_end] == m_depths[level_begin]) {
+				++level_end;
+			}
+
+			pJobSystem->parallel_for(static_cast<uint32_t>(level_end - level_begin), parallel_grain,
+				[this, level_begin, &local_matrices_recomputed, &world_matrices_recomputed](const uint32_t begin, const uint32_t end) {
+					Statistics statistics;
+					update_range(level_begin + begin, level_begin + end, statistics);
+					local_matrices_recomputed.fetch_add(statistics.local_matrices_recomputed, std::memory_order_relaxed);
+					world_matrices_recomputed.fetch_add(statistics.world_matrices_recomputed, std::memory_order_relaxed);
+				});
+			level_begin = level_end;
+		}
+		m_statistics.local_matrices_recomputed = local_matrices_recomputed.load();
+		m_statistics.world_matrices_recomputed = world_matrices_recomputed.load();
+	}
+
+	void TransformHierarchy::update_range(const size_t begin, const size_t end, Statistics& statistics) {
+
+		//WorldChanged родителя выставлен раньше в этом же проходе, т.к. родитель стоит раньше
+		for (size_t i = begin; i < end; ++i) {
+
+			uint8_t& flags = m_flags[i];
+			const uint32_t parent_index = m_parents[i];
+			const bool parent_changed = parent_index != s_no_parent && (m_flags[parent_index] & WorldChanged);
+
+			if (flags & LocalDirty) {
+				compose_trs(m_positions[i], m_rotations[i], m_scales[i], m_local_matrices[i]);
+				++statistics.local_matrices_recomputed;
+			}
+
+			if ((flags & LocalDirty) || parent_changed) {
+
+				if (!(flags & Created))
+					m_previous_world_matrices[i] = m_world_matrices[i];
+				if (parent_index == s_no_parent)
+					m_world_matrices[i] = m_local_matrices[i];
+				else
+					multiply_matrices(m_world_matrices[parent_index], m_local_matrices[i], m_world_matrices[i]);
+				if (flags & Created)
+					m_previous_world_matrices[i] = m_world_matrices[i];
+				flags = WorldChanged;
+				++statistics.world_matrices_recomputed;
+			}
+			else {
+				flags = 0;
+			}
+		}
+	}
+
+	void TransformHierarchy::interpolate(const float alpha) {
+
+		//Покомпонентный lerp матриц: между соседними шагами поворот мал, и искажение масштаба не видно
+		for (size_t i = 0; i < m_positions.size(); ++i) {
+
+			if (!(m_flags[i] & WorldChanged))
+				continue;
+
+			const glm::mat4& previous = m_previous_world_matrices[i];
+			const glm::mat4& current = m_world_matrices[i];
+			glm::mat4& render = m_render_matrices[i];
+			for (int column = 0; column < 4; ++column) {
+				render[column] = previous[column] + (current[column] - previous[column]) * alpha;
+			}
+		}
+		m_bInterpolated = true;
+	}
+
+	void TransformHierarchy::sort_breadth_first() {
+
+		const size_t count = m_positions.size();
+		std::vector<uint32_t> order(count);
+		std::iota(order.begin(), order.end(), 0);
+		//Стабильная сортировка сохраняет порядок внутри уровня
+		std::stable_sort(order.begin(), order.end(), [this](const uint32_t a, const uint32_t b) { return m_depths[a] < m_depths[b]; });
+
+		std::vector<uint32_t> new_index(count);
+		for (uint32_t i = 0; i < count; ++i) {
+			new_index[order[i]] = i;
+		}
+
+		auto permute = [&order](auto& values) {
+			std::remove_reference_t<decltype(values)> sorted;
+			sorted.reserve(values.size());
+			for (const uint32_t old_index : order) {
+				sorted.push_back(values[old_index]);
+			}
+			values.swap(sorted);
+		};
+		permute(m_positions);
+		permute(m_rotations);
+		permute(m_scales);
+		permute(m_local_matrices);
+		permute(m_world_matrices);
+		permute(m_previous_world_matrices);
+		permute(m_render_matrices);
+		permute(m_parents);
+		permute(m_depths);
+		permute(m_flags);
+		permute(m_index_to_node);
+
+		for (uint32_t i = 0; i < count; ++i) {
+
+			if (m_parents[i] != s_no_parent)
+				m_parents[i] = new_index[m_parents[i]];
+			m_node_to_index[m_index_to_node[i]] = i;
+		}
+		m_bOrderDirty = false;
+	}
+
+	void TransformHierarchy::remove_marked(const std::vector<uint8_t>& removed) {
+
+		const size_t count = m_positions.size();
+		std::vector<uint32_t> new_index(count, s_no_parent);
+		size_t kept = 0;
+		for (size_t i = 0; i < count; ++i) {
+
+			if (removed[i]) {
+				m_node_to_index[m_index_to_node[i]] = invalid_transform_node;
+				m_free_nodes.push_back(m_index_to_node[i]);
+				continue;
+			}
+
+			//Сдвиг только назад, поэтому переносим на месте
+			new_index[i] = static_cast<uint32_t>(kept);
+			m_positions[kept] = m_positions[i];
+			m_rotations[kept] = m_rotations[i];
+			m_scales[kept] = m_scales[i];
+			m_local_matrices[kept] = m_local_matrices[i];
+			m_world_matrices[kept] = m_world_matrices[i];
+			m_previous_world_matrices[kept] = m_previous_world_matrices[i];
+			m_render_matrices[kept] = m_render_matrices[i];
+			m_parents[kept] = m_parents[i] == s_no_parent ? s_no_parent : new_index[m_parents[i]];
+			m_depths[kept] = m_depths[i];
+			m_flags[kept] = m_flags[i];
+			m_index_to_node[kept] = m_index_to_node[i];
+			m_node_to_index[m_index_to_node[kept]] = static_cast<uint32_t>(kept);
+			++kept;
+		}
+
+		m_positions.resize(kept);
+		m_rotations.resize(kept);
+		m_scales.resize(kept);
+		m_local_matrices.resize(kept);
+		m_world_matrices.resize(kept);
+		m_previous_world_matrices.resize(kept);
+		m_render_matrices.resize(kept);
+		m_parents.resize(kept);
+		m_depths.resize(kept);
+		m_flags.resize(kept);
+		m_index_to_node.resize(kept);
+	}
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "SimpleEngineCore/Rendering/OpenGL/Renderer_OpenGL.hpp"
+#include "SimpleEngineCore/Rendering/OpenGL/FrameBuffer.hpp"
 
 #include <imgui/imgui.h>
 #include <imgui/backends/imgui_impl_opengl3.h>
@@ -13,10 +14,14 @@
 
 namespace SimpleEngine {
 
-    Window::Window(std::string title, const unsigned int width, const unsigned int height)
-        : m_data({ std::move(title), width, height }) {
+    Window::Window(std::string title, const unsigned int width, const unsigned int height, const EMode mode)
+        : m_data({ std::move(title), width, height })
+        , m_mode(mode) {
 
-        int resultCode = init();
+        //Без окна или контекста ImGui инициализировать не на чем - Application проверяет is_valid()
+        m_bValid = init() == 0;
+        if (!m_bValid)
+            return;
 
         IMGUI_CHECKVERSION();
         ImGui::CreateContext();
@@ -24,33 +29,110 @@ namespace SimpleEngine {
         ImGui_ImplGlfw_InitForOpenGL(m_pWindow, true);
     }
 
-    void Window::on_update() {
+    void Window::swap_buffers() {
+
+        //В headless режиме показывать нечего - кадр остаётся во FrameBuffer
+        if (m_mode == EMode::Windowed)
+            glfwSwapBuffers(m_pWindow);
+    }
+
+    void Window::poll_events() {
 
-        glfwSwapBuffers(m_pWindow);
         glfwPollEvents();
     }
 
-    int Window::init() {
+    void Window::make_context_current(const bool current) {
 
-        std::cout << " Window::init()\n";
+        glfwMakeContextCurrent(current ? m_pWindow : nullptr);
+    }
 
-        glfwSetErrorCallback([](int error_code, const char* description) {
+    bool Window::take_pending_viewport(unsigned int& width, unsigned int& height) {
 
-                std::cerr << "GLFW error: " << description << "\n";
-            });
+        if (!m_data.bViewportPending)
+            return false;
+        width = m_data.viewport_width;
+        height = m_data.viewport_height;
+        m_data.bViewportPending = false;
+        return true;
+    }
+
+    int Window::create_headless_window() {
 
+        //Сначала пробуем сервер без дисплея: null-платформа GLFW + OSMesa (llvmpipe)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        if (glfwInit()) {
+
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            m_pWindow = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+            if (m_pWindow)
+                return 0;
+
+            glfwTerminate();
+        }
+
+        //Иначе - невидимое окно на обычной платформе с EGL контекстом
+        std::cout << " OSMesa is not available, falling back to an invisible window\n";
+        glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
         if (!glfwInit()) {
             std::cerr << "Can't initialize GLFW!\n";
             return -1;
         }
 
-        /* Create a windowed mode window and its OpenGL context */
+        glfwDefaultWindowHints();
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
         m_pWindow = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
         if (!m_pWindow) {
 
-            std::cerr << "Can't create WINDOW!\n";
+            std::cerr << "Can't create headless WINDOW!\n";
             return -2;
         }
+        return 0;
+    }
+
+    int Window::init() {
+
+        std::cout << " Window::init()\n";
+
+        glfwSetErrorCallback([](int error_code, const char* description) {
+
+                std::cerr << "GLFW error: " << description << "\n";
+            });
+
+        if (m_mode == EMode::Headless) {
+
+            const int result_code = create_headless_window();
+            if (result_code != 0)
+                return result_code;
+        }
+        else {
+
+            if (!glfwInit()) {
+                std::cerr << "Can't initialize GLFW!\n";
+                return -1;
+            }
+
+            /* Create a windowed mode window and its OpenGL context */
+            m_pWindow = glfwCreateWindow(m_data.width, m_data.height, m_data.title.c_str(), nullptr, nullptr);
+            if (!m_pWindow) {
+
+                std::cerr << "Can't create WINDOW!\n";
+                return -2;
+            }
+
+            int framebuffer_width = 0;
+            int framebuffer_height = 0;
+            glfwGetFramebufferSize(m_pWindow, &framebuffer_width, &framebuffer_height);
+            m_data.framebuffer_width = static_cast<unsigned int>(framebuffer_width);
+            m_data.framebuffer_height = static_cast<unsigned int>(framebuffer_height);
+        }
 
         if (!Renderer_OpenGL::init(m_pWindow)) {
 
@@ -58,7 +140,20 @@ namespace SimpleEngine {
             return -3;
         }
 
-        // glfwSetWindowUserPointer,    
+        if (m_mode == EMode::Headless) {
+
+            //Без swap'а vsync не нужен, рисуем во внеэкранный FrameBuffer
+            glfwSwapInterval(0);
+            m_pFrameBuffer = std::make_unique<FrameBuffer>(m_data.width, m_data.height);
+            m_data.framebuffer_width = m_data.width;
+            m_data.framebuffer_height = m_data.height;
+            if (!m_pFrameBuffer->is_complete())
+                return -4;
+            m_pFrameBuffer->bind();
+            Renderer_OpenGL::set_viewport(m_data.width, m_data.height);
+        }
+
+        //Вызываем glfwSetWindowUserPointer, чтобы поймать пользовательские данные
         glfwSetWindowUserPointer(m_pWindow, &m_data);
         
         glfwSetKeyCallback(m_pWindow,
@@ -88,7 +183,7 @@ namespace SimpleEngine {
             });
 
         glfwSetWindowSizeCallback(m_pWindow,
-            // -
+            //Вызываем лямбда-функцию
             [](GLFWwindow* pWindow, int width, int height) {
 
                 //std::cout << "New size " << width << "x" << height << "\n";
@@ -119,7 +214,17 @@ namespace SimpleEngine {
         glfwSetFramebufferSizeCallback(m_pWindow,
             [](GLFWwindow* pWindow, int width, int height) {
 
-                Renderer_OpenGL::set_viewport(width, height);
+                WindowData& data = *static_cast<WindowData*>(glfwGetWindowUserPointer(pWindow));
+                data.framebuffer_width = width;
+                data.framebuffer_height = height;
+                //Колбэк приходит из glfwPollEvents() основного потока, а контекст может быть у потока отрисовки
+                if (glfwGetCurrentContext() == pWindow) {
+                    Renderer_OpenGL::set_viewport(width, height);
+                    return;
+                }
+                data.bViewportPending = true;
+                data.viewport_width = width;
+                data.viewport_height = height;
             });
 
         return 0;
@@ -127,11 +232,18 @@ namespace SimpleEngine {
 
     void Window::shutdown() {
 
-        ImGui_ImplOpenGL3_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
-        ImGui::DestroyContext();
+        if (m_bValid) {
+            ImGui_ImplOpenGL3_Shutdown();
+            ImGui_ImplGlfw_Shutdown();
+            ImGui::DestroyContext();
+        }
 
-        glfwDestroyWindow(m_pWindow);
+        //Буфер создаётся только с контекстом этого окна - без окна удалять нечего
+        if (m_pWindow) {
+            m_pFrameBuffer = nullptr;
+            glfwDestroyWindow(m_pWindow);
+            m_pWindow = nullptr;
+        }
         glfwTerminate();
     }
 
@@ -3,25 +3,46 @@
 #include "SimpleEngineCore/Event.hpp"
 #include <string>
 #include <functional>
+#include <memory>
 
 struct GLFWwindow;
 
 namespace SimpleEngine {
 
+    class FrameBuffer;
+
     class Window {
     public:
         using EventCallbackFn = std::function<void(BaseEvent&)>;
 
-        Window(std::string title, const unsigned int width, const unsigned int height);
+        enum class EMode {
+
+            Windowed,
+            Headless
+        };
+
+        Window(std::string title, const unsigned int width, const unsigned int height, const EMode mode = EMode::Windowed);
         Window(const Window&) = delete;
         Window(Window&&) = delete;
         Window& operator=(const Window&) = delete;
         Window& operator=(Window&&) = delete;
 
-        void on_update();
+        //swap_buffers() - из потока, где контекст текущий; события - только из основного
+        void swap_buffers();
+        void poll_events();
+        //Отпустить контекст в этом потоке (false) или сделать текущим (true)
+        void make_context_current(const bool current);
+        //Размер кадра менялся, пока контекст был у другого потока - вьюпорт надо выставить там
+        bool take_pending_viewport(unsigned int& width, unsigned int& height);
 
         unsigned int get_width() const { return m_data.width; }
         unsigned int get_height() const { return m_data.height; }
+        //В пикселях кадра: на экранах с масштабированием больше размера окна
+        unsigned int get_framebuffer_width() const { return m_data.framebuffer_width; }
+        unsigned int get_framebuffer_height() const { return m_data.framebuffer_height; }
+        bool is_headless() const { return m_mode == EMode::Headless; }
+        //false - окно, контекст или внеэкранный буфер создать не удалось, рисовать нельзя
+        bool is_valid() const { return m_bValid; }
 
         void set_event_callback(const EventCallbackFn& callback) {
 
@@ -37,13 +58,22 @@ namespace SimpleEngine {
             unsigned int width;
             unsigned int height;
             EventCallbackFn eventCallbackFn;
+            bool bViewportPending = false;
+            unsigned int viewport_width = 0;
+            unsigned int viewport_height = 0;
+            unsigned int framebuffer_width = 0;
+            unsigned int framebuffer_height = 0;
         };
 
         int init();
+        int create_headless_window();
         void shutdown();
 
         GLFWwindow* m_pWindow = nullptr;
         WindowData m_data;
+        EMode m_mode;
+        bool m_bValid = false;
+        std::unique_ptr<FrameBuffer> m_pFrameBuffer;
     };
 
 }
\ No newline at end of file
@@ -1,65 +1,79 @@
 #include <iostream>
 #include <memory>
+#include <cstring>
+#include <cstdlib>
 #include <SimpleEngineCore/Application.hpp>
 #include <imgui/imgui.h>
 #include "SimpleEngineCore/Input.hpp"
 
 class SimpleEngineEditor : public SimpleEngine::Application {
+public:
+    //Редактор в on_render ничего не рисует сам - GL можно отдать отдельному потоку
+    SimpleEngineEditor() {
+        use_render_thread = true;
+    }
+
+private:
+    //Скорости в секунду: шаг симуляции фиксированный, поэтому от частоты кадров не зависят
+    static constexpr float camera_movement_speed = 3.f;
+    static constexpr float camera_rotation_speed = 30.f;
 
-    virtual void on_update() override {
+    virtual void on_fixed_update(float delta_time) override {
 
         bool move_camera = false;
+        const float movement_step = camera_movement_speed * delta_time;
+        const float rotation_step = camera_rotation_speed * delta_time;
 
         glm::vec3 movement_delta{ 0, 0, 0 };
         glm::vec3 rotation_delta{ 0, 0, 0 };
 
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_W)) {
-            movement_delta.x += 0.05f;
+            movement_delta.x += movement_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_S)) {
-            movement_delta.x -= 0.05f;
+            movement_delta.x -= movement_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_A)) {
-            movement_delta.y -= 0.05f;
+            movement_delta.y -= movement_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_D)) {
-            movement_delta.y += 0.05f;
+            movement_delta.y += movement_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_E)) {
-            movement_delta.z += 0.05f;
+            movement_delta.z += movement_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_Q)) {
-            movement_delta.z -= 0.05f;
+            movement_delta.z -= movement_step;
             move_camera = true;
         }
 
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_UP)) {
-            rotation_delta.y += 0.5f;
+            rotation_delta.y += rotation_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_DOWN)) {
-            rotation_delta.y -= 0.5f;
+            rotation_delta.y -= rotation_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_RIGHT)) {
-            rotation_delta.z += 0.5f;
+            rotation_delta.z += rotation_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_LEFT)) {
-            rotation_delta.z -= 0.5f;
+            rotation_delta.z -= rotation_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_P)) {
-            rotation_delta.x += 0.5f;
+            rotation_delta.x += rotation_step;
             move_camera = true;
         }
         if (SimpleEngine::Input::IsKeyPressed(SimpleEngine::KeyCode::KEY_O)) {
-            rotation_delta.x -= 0.5f;
+            rotation_delta.x -= rotation_step;
             move_camera = true;
         }
         if(move_camera)
@@ -94,10 +108,16 @@ class SimpleEngineEditor : public SimpleEngine::Application {
     int frame = 0;
 };
 
-int main()
+int main(int argc, char** argv)
 {
     auto pSimpleEngineEditor = std::make_unique<SimpleEngineEditor>();
 
+    // --headless [frames] - run without a display (CI / render farm)
+    if (argc > 1 && std::strcmp(argv[1], "--headless") == 0) {
+        const unsigned int frames_count = argc > 2 ? static_cast<unsigned int>(std::strtoul(argv[2], nullptr, 10)) : 1000;
+        return pSimpleEngineEditor->start_headless(1024, 768, frames_count);
+    }
+
     int returnCode = pSimpleEngineEditor->start(1024, 768, "kuku");
 
     std::cin.get();
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
+
+#include "SimpleEngineCore/MeshFile.hpp"
+#include "SimpleEngineCore/MeshImporter.hpp"
+#include "SimpleEngineCore/MeshOptimizer.hpp"
+#include "SimpleEngineCore/JobSystem.hpp"
+
+static void print_usage()
+{
+    std::cerr << "Usage: SimpleEngineMeshConverter [options] <input.obj|input.gltf> <output.semesh>\n";
+    std::cerr << "       --threads N     1 - single-threaded import, 0 (default) - all cores\n";
+    std::cerr << "       --no-optimize   keep the source triangle and vertex order\n";
+    std::cerr << "       --index16       uint16 indexes when the mesh has at most 65536 vertices\n";
+    std::cerr << "       --quantize      Half4 position, Byte4N normal, Half2 uv (half precision positions)\n";
+    std::cerr << "       --lods N        up to N levels of detail, each with half the triangles (default 4, 1 - no LODs)\n";
+    std::cerr << "       Default vertex layout: Float3 position, Float3 normal[, Float2 uv]; indexes are uint32\n";
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int threads_count = 0;
+    bool optimize = true;
+    bool index16 = false;
+    bool quantize = false;
+    unsigned int lods_count = 4;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads_count = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--no-optimize") == 0)
+            optimize = false;
+        else if (std::strcmp(argv[i], "--index16") == 0)
+            index16 = true;
+        else if (std::strcmp(argv[i], "--quantize") == 0)
+            quantize = true;
+        else if (std::strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+            lods_count = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 2) {
+        print_usage();
+        return -1;
+    }
+
+    using namespace SimpleEngine;
+    std::unique_ptr<JobSystem> pJobSystem;
+    if (threads_count != 1)
+        pJobSystem = std::make_unique<JobSystem>(threads_count == 0 ? 0 : threads_count - 1);
+
+    MeshImporter importer(pJobSystem.get());
+    ImportedMesh mesh;
+    if (!importer.import(paths[0], mesh))
+        return -1;
+
+    const VertexCacheStatistics before = analyze_vertex_cache(mesh.indexes.data(), mesh.indexes.size(), mesh.vertices_count);
+
+    //Все уровни ссылаются на одни вершины и лежат в общем массиве индексов подряд
+    constexpr float max_lod_error = 0.1f;//В долях радиуса меша
+    const size_t stride = mesh.buffer_layout.get_stride();
+    const std::vector<MeshLod> lods = build_lod_chain(mesh.indexes, reinterpret_cast<const float*>(mesh.vertex_data.data()), mesh.vertices_count, stride,
+                                                      std::min(lods_count, MeshFileHeader::max_lods), max_lod_error, optimize);
+    if (optimize) {
+        if (!optimize_vertex_fetch(mesh.vertex_data.data(), mesh.vertices_count, stride, mesh.indexes.data(), mesh.indexes.size()))
+            return -1;
+        mesh.vertex_data.resize(mesh.vertices_count * stride);
+    }
+    const VertexCacheStatistics after = analyze_vertex_cache(mesh.indexes.data(), lods[0].indexes_count, mesh.vertices_count);
+
+    BufferLayout buffer_layout = mesh.buffer_layout;
+    std::vector<uint8_t> vertex_data;
+    if (quantize) {
+        buffer_layout = mesh.has_uvs
+            ? BufferLayout{ ShaderDataType::Half4, ShaderDataType::Byte4N, ShaderDataType::Half2 }
+            : BufferLayout{ ShaderDataType::Half4, ShaderDataType::Byte4N };
+        if (!quantize_vertices(mesh.buffer_layout, mesh.vertex_data.data(), mesh.vertices_count, buffer_layout, vertex_data))
+            return -1;
+    }
+    else {
+        vertex_data.swap(mesh.vertex_data);
+    }
+
+    std::vector<uint16_t> indexes16;
+    if (index16 && !narrow_indexes(mesh.indexes.data(), mesh.indexes.size(), mesh.vertices_count, indexes16)) {
+        std::cerr << "--index16: " << mesh.vertices_count << " vertices don't fit, keeping uint32 indexes\n";
+        index16 = false;
+    }
+    const bool written = index16
+        ? MeshFile::write(paths[1], buffer_layout, vertex_data.data(), mesh.vertices_count, indexes16.data(), indexes16.size(), sizeof(uint16_t), lods)
+        : MeshFile::write(paths[1], buffer_layout, vertex_data.data(), mesh.vertices_count, mesh.indexes.data(), mesh.indexes.size(), sizeof(uint32_t), lods);
+    if (!written)
+        return -1;
+
+    const MeshImporter::Statistics& statistics = importer.get_statistics();
+    std::cout << paths[1] << ": " << mesh.vertices_count << " vertices, " << lods[0].indexes_count / 3 << " triangles"
+              << (mesh.has_uvs ? ", uv" : "") << (mesh.generated_normals ? ", generated normals" : "")
+              << ", " << buffer_layout.get_stride() << " bytes per vertex, " << (index16 ? 16 : 32) << "-bit indexes\n";
+    std::cout << "import: " << statistics.import_ms << " ms, " << statistics.megabytes_per_second << " MB/s on "
+              << statistics.threads_count << " threads, peak " << statistics.peak_memory_bytes / (1024.0 * 1024.0) << " MB\n";
+    std::cout << "vertex cache (16 entries): ACMR " << before.acmr << " -> " << after.acmr
+              << ", ATVR " << before.atvr << " -> " << after.atvr << "\n";
+    for (size_t lod = 1; lod < lods.size(); ++lod)
+        std::cout << "LOD " << lod << ": " << lods[lod].indexes_count / 3 << " triangles, error " << lods[lod].error * 100.f << "% of radius\n";
+    return 0;
+}